@@ -6,6 +6,16 @@
 #include <vector>
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include <spdlog/fmt/fmt.h>
 
 #include "spdlog/spdlog.h"
@@ -15,6 +25,7 @@
 #include "git_version.h"
 
 #include "render/FSEQFile.h"
+#include "render/FrameChunkQueue.h"
 
 static int fseqMajVersion = 2;
 static int fseqMinVersion = 0;
@@ -22,6 +33,8 @@ static int compressionLevel = -99;
 static std::vector<std::pair<uint32_t, uint32_t>> ranges;
 static bool sparse = true;
 static FSEQFile::CompressionType compressionType = FSEQFile::CompressionType::zstd;
+static bool useDictionary = false;
+static bool useTemporalDelta = false;
 
 // Utility function to split a string by a delimiter
 std::vector<std::string> split(const std::string& str, char delimiter) {
@@ -34,19 +47,452 @@ std::vector<std::string> split(const std::string& str, char delimiter) {
     return tokens;
 }
 
+// Parse "Start-End" or "Start+Length" (1 based) into a 0 based start and length
+static bool parseRange(const std::string& r, std::pair<uint32_t, uint32_t>& range) {
+    char const sep = r.contains('-') ? '-' : '+';
+    std::vector<std::string> const startEnd = split(r, sep);
+    if (startEnd.size() != 2 || startEnd[0].empty() || startEnd[1].empty()) {
+        return false;
+    }
+    uint32_t const start = std::stoul(startEnd[0]);
+    uint32_t const second = std::stoul(startEnd[1]);
+    if (start == 0 || (sep == '-' && second < start)) {
+        return false;
+    }
+    range.first = start - 1;
+    range.second = sep == '-' ? second - start + 1 : second;
+    return true;
+}
+
+static bool parseRanges(const std::vector<std::string>& in, std::vector<std::pair<uint32_t, uint32_t>>& out, uint32_t& channelCount) {
+    for (auto const& r : in) {
+        std::pair<uint32_t, uint32_t> range;
+        if (!parseRange(r, range)) {
+            spdlog::critical("Invalid range format: {}", r);
+            return false;
+        }
+        out.push_back(range);
+        channelCount += range.second;
+    }
+    return true;
+}
+
+// Create path shaped like src holding channelCount channels from outRanges, and
+// write its header.  src must already be prepared to read the channels for the
+// dictionary training.
+static std::unique_ptr<FSEQFile> createOutput(FSEQFile& src, const std::string& path,
+                                              const std::vector<std::pair<uint32_t, uint32_t>>& outRanges, uint32_t channelCount) {
+    std::unique_ptr<FSEQFile> dest(FSEQFile::createFSEQFile(path,
+                                                            fseqMajVersion,
+                                                            compressionType,
+                                                            compressionLevel));
+    if (nullptr == dest) {
+        spdlog::critical("Failed to create FSEQ file (returned nullptr)!");
+        return nullptr;
+    }
+    dest->enableMinorVersionFeatures(fseqMinVersion);
+
+    dest->initializeFromFSEQ(src);
+    if (fseqMajVersion == 2 && sparse) {
+        V2FSEQFile* f = (V2FSEQFile*)dest.get();
+        f->m_sparseRanges = outRanges;
+        // writeHeader keeps the ranges below the channel count and then packs it
+        // down to their total, so it has to reach the end of the last range
+        uint32_t maxChannel = 0;
+        for (auto const& r : outRanges) {
+            maxChannel = std::max(maxChannel, r.first + r.second);
+        }
+        dest->setChannelCount(maxChannel);
+    } else {
+        dest->setChannelCount(channelCount);
+    }
+    if (useTemporalDelta) {
+        V2FSEQFile* f = dynamic_cast<V2FSEQFile*>(dest.get());
+        if (f == nullptr || !f->enableTemporalDelta()) {
+            spdlog::critical("Temporal delta needs a version 2 zstd compressed output");
+            return nullptr;
+        }
+    }
+    if (useDictionary) {
+        V2FSEQFile* f = dynamic_cast<V2FSEQFile*>(dest.get());
+        if (f == nullptr || compressionType != FSEQFile::CompressionType::zstd) {
+            spdlog::critical("A dictionary needs a version 2 zstd compressed output");
+            return nullptr;
+        }
+        std::vector<uint8_t> frame(8024 * 1024);
+        bool trained = f->trainZstdDictionary([&](uint32_t x, uint8_t* data) {
+            std::unique_ptr<FSEQFile::FrameData> fdata(src.getFrame(x));
+            if (!fdata || !fdata->readFrame(frame.data(), frame.size())) {
+                return false;
+            }
+            memcpy(data, frame.data(), std::min((size_t)f->getMaxChannel(), frame.size()));
+            return true;
+        });
+        if (!trained) {
+            spdlog::warn("Could not train a zstd dictionary, writing without one");
+        }
+    }
+    dest->writeHeader();
+    return dest;
+}
+
+#pragma region Batch
+// Batch mode converts every input into one output per target, decoding each
+// input only once.  The calling thread decodes frames (a Bulk read, so the
+// block decompression is spread over cores) into chunks that are handed to one
+// writer thread per output.  Each writer cuts its ranges out of the frames and
+// hands the blocks to a compression pool shared by every output, and a couple
+// of inputs are converted at once so one's decode overlaps another's compression.
+
+struct BatchTarget {
+    std::string name; // sub directory of the output directory, empty for the directory itself
+    std::vector<std::pair<uint32_t, uint32_t>> ranges; // empty for every channel
+    uint32_t channelCount = 0;
+};
+
+static constexpr uint32_t BATCH_CHUNK_FRAMES = 64;
+// chunks a writer can fall behind the decoder before the decoder waits for it
+static constexpr size_t BATCH_QUEUE_DEPTH = 8;
+// inputs converted at once, enough for one to decode while another compresses
+static constexpr size_t BATCH_FILES_IN_FLIGHT = 2;
+
+// Compresses the blocks of every output file being written, so all the outputs
+// of all the inputs in flight share one thread per core.
+class BlockPool {
+public:
+    explicit BlockPool(unsigned int threads) {
+        for (unsigned int i = 0; i < std::max(threads, 1u); i++) {
+            _threads.emplace_back([this] { run(); });
+        }
+    }
+    ~BlockPool() {
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            _stop = true;
+        }
+        _signal.notify_all();
+        for (auto& t : _threads) {
+            t.join();
+        }
+    }
+    void submit(std::function<void()> task) {
+        std::unique_lock<std::mutex> lock(_lock);
+        _tasks.push_back(std::move(task));
+        _signal.notify_one();
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(_lock);
+        for (;;) {
+            _signal.wait(lock, [this] { return _stop || !_tasks.empty(); });
+            if (_tasks.empty()) {
+                return;
+            }
+            auto task = std::move(_tasks.front());
+            _tasks.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+    std::mutex _lock;
+    std::condition_variable _signal;
+    std::deque<std::function<void()>> _tasks;
+    std::vector<std::thread> _threads;
+    bool _stop = false;
+};
+
+struct BatchWriter {
+    BatchTarget const* target = nullptr;
+    std::string path;
+    std::unique_ptr<FSEQFile> file;
+    FrameChunkQueue queue{ BATCH_QUEUE_DEPTH };
+    double busySeconds = 0;
+};
+
+static double mbPerSecond(uint64_t bytes, double seconds) {
+    return seconds > 0 ? (double)bytes / (1024.0 * 1024.0) / seconds : 0.0;
+}
+
+static bool convertBatchInput(const std::filesystem::path& input, const std::filesystem::path& outDir,
+                              const std::vector<BatchTarget>& targets, BlockPool& pool) {
+    using clock = std::chrono::steady_clock;
+    auto const started = clock::now();
+
+    std::unique_ptr<FSEQFile> src(FSEQFile::openFSEQFile(input.string()));
+    if (nullptr == src) {
+        spdlog::error("Error opening input file: {}", input.string());
+        return false;
+    }
+    uint32_t const frameSize = src->getMaxChannel();
+    uint32_t const numFrames = src->getNumFrames();
+    src->setReadPattern(FSEQFile::ReadPattern::Bulk);
+    src->prepareRead({ { 0, frameSize } });
+
+    std::vector<std::unique_ptr<BatchWriter>> writers;
+    for (auto const& t : targets) {
+        auto w = std::make_unique<BatchWriter>();
+        w->target = &t;
+        std::filesystem::path dir = t.name.empty() ? outDir : outDir / t.name;
+        std::error_code ec;
+        std::filesystem::create_directories(dir, ec);
+        w->path = (dir / input.filename()).string();
+        if (std::filesystem::equivalent(w->path, input, ec)) {
+            spdlog::error("{}: output would overwrite the input, skipped", w->path);
+            continue;
+        }
+        std::vector<std::pair<uint32_t, uint32_t>> outRanges = t.ranges;
+        uint32_t channelCount = t.channelCount;
+        if (outRanges.empty()) {
+            outRanges.emplace_back(0, src->getChannelCount());
+            channelCount = src->getChannelCount();
+        } else if (std::any_of(outRanges.begin(), outRanges.end(), [frameSize](auto const& r) { return r.first >= frameSize; })) {
+            spdlog::error("{}: ranges are out of bounds for the source file with {} channels, skipped", w->path, frameSize);
+            continue;
+        }
+        w->file = createOutput(*src, w->path, outRanges, channelCount);
+        if (w->file != nullptr) {
+            if (V2FSEQFile* f = dynamic_cast<V2FSEQFile*>(w->file.get())) {
+                f->setBlockExecutor([&pool](std::function<void()> task) { pool.submit(std::move(task)); });
+            }
+            writers.push_back(std::move(w));
+        }
+    }
+    if (writers.empty()) {
+        return false;
+    }
+
+    std::vector<std::thread> threads;
+    for (auto& w : writers) {
+        threads.emplace_back([w = w.get(), frameSize] {
+            while (auto chunk = w->queue.pop()) {
+                auto const start = clock::now();
+                for (uint32_t i = 0; i < chunk->frames; i++) {
+                    w->file->addFrame(chunk->firstFrame + i, &chunk->data[(size_t)i * frameSize]);
+                }
+                w->busySeconds += std::chrono::duration<double>(clock::now() - start).count();
+            }
+            auto const start = clock::now();
+            w->file->finalize();
+            w->file.reset();
+            w->busySeconds += std::chrono::duration<double>(clock::now() - start).count();
+        });
+    }
+
+    bool readOk = true;
+    double decodeSeconds = 0;
+    FSEQFile::FrameView view;
+    for (uint32_t first = 0; first < numFrames; first += BATCH_CHUNK_FRAMES) {
+        auto const start = clock::now();
+        auto chunk = std::make_shared<FrameChunk>();
+        chunk->firstFrame = first;
+        chunk->frames = std::min(BATCH_CHUNK_FRAMES, numFrames - first);
+        chunk->data.resize((size_t)chunk->frames * frameSize);
+        for (uint32_t i = 0; i < chunk->frames; i++) {
+            uint8_t* data = &chunk->data[(size_t)i * frameSize];
+            if (src->getFrameView(first + i, view)) {
+                view.readFrame(data, frameSize);
+            } else {
+                std::unique_ptr<FSEQFile::FrameData> fdata(src->getFrame(first + i));
+                if (fdata == nullptr || !fdata->readFrame(data, frameSize)) {
+                    // the frame is written as zeros, the input is reported as failed once the outputs are closed
+                    spdlog::error("{}: unable to read frame {}", input.string(), first + i);
+                    readOk = false;
+                }
+            }
+        }
+        decodeSeconds += std::chrono::duration<double>(clock::now() - start).count();
+        for (auto& w : writers) {
+            w->queue.push(chunk);
+        }
+    }
+    for (auto& w : writers) {
+        w->queue.close(false);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    double const wallSeconds = std::chrono::duration<double>(clock::now() - started).count();
+    uint64_t const srcBytes = (uint64_t)numFrames * src->getChannelCount();
+    spdlog::info("{}: {} frames, decode {:.1f} MB/s, {:.2f}s total", input.string(), numFrames, mbPerSecond(srcBytes, decodeSeconds), wallSeconds);
+    for (auto& w : writers) {
+        std::error_code ec;
+        uint64_t const outBytes = (uint64_t)numFrames * (w->target->ranges.empty() ? src->getChannelCount() : w->target->channelCount);
+        spdlog::info("  {}: {} bytes, extract + compress {:.1f} MB/s", w->path, std::filesystem::file_size(w->path, ec), mbPerSecond(outBytes, w->busySeconds));
+    }
+    return readOk;
+}
+
+// "name=ranges", ranges as for -r separated by commas.  A bare name keeps every channel.
+static bool parseTarget(const std::string& spec, BatchTarget& target) {
+    auto const eq = spec.find('=');
+    target.name = spec.substr(0, eq);
+    if (target.name.empty() || target.name.contains('/') || target.name.contains('\\')) {
+        spdlog::critical("Invalid target name: {}", spec);
+        return false;
+    }
+    if (eq == std::string::npos) {
+        return true;
+    }
+    return parseRanges(split(spec.substr(eq + 1), ','), target.ranges, target.channelCount);
+}
+
+static int runBatch(const std::vector<std::string>& inputs, const std::string& output, std::vector<BatchTarget> targets) {
+    std::vector<std::filesystem::path> files;
+    for (auto const& in : inputs) {
+        std::error_code ec;
+        if (std::filesystem::is_directory(in, ec)) {
+            std::vector<std::filesystem::path> dirFiles;
+            for (auto const& e : std::filesystem::directory_iterator(in, ec)) {
+                if (e.is_regular_file() && e.path().extension() == ".fseq") {
+                    dirFiles.push_back(e.path());
+                }
+            }
+            std::sort(dirFiles.begin(), dirFiles.end());
+            files.insert(files.end(), dirFiles.begin(), dirFiles.end());
+        } else {
+            files.emplace_back(in);
+        }
+    }
+    if (files.empty()) {
+        spdlog::critical("No fseq files found");
+        return EXIT_FAILURE;
+    }
+    if (targets.empty()) {
+        targets.emplace_back();
+    }
+
+    auto const started = std::chrono::steady_clock::now();
+    BlockPool pool(std::thread::hardware_concurrency());
+    std::atomic<size_t> next{ 0 };
+    std::atomic<int> failed{ 0 };
+    std::vector<std::thread> converters;
+    for (size_t i = 0; i < std::min(BATCH_FILES_IN_FLIGHT, files.size()); i++) {
+        converters.emplace_back([&] {
+            for (size_t f = next++; f < files.size(); f = next++) {
+                if (!convertBatchInput(files[f], output, targets, pool)) {
+                    failed++;
+                }
+            }
+        });
+    }
+    for (auto& t : converters) {
+        t.join();
+    }
+    spdlog::info("Converted {} of {} files in {:.2f}s", files.size() - failed.load(), files.size(),
+                 std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count());
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+#pragma endregion
+
+struct BenchResult {
+    uint64_t bytes = 0;
+    double encodeSeconds = 0;
+    double decodeSeconds = 0;
+};
+
+// Write frames (numFrames x frameSize, full channel data) as a zstd fseq shaped
+// like src, then read it back front to back the way xLights loads a sequence.
+static bool benchmarkFormat(const FSEQFile& src, const std::vector<uint8_t>& frames, uint32_t frameSize,
+                            const std::string& path, bool delta, BenchResult& result) {
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+    {
+        std::unique_ptr<FSEQFile> dest(FSEQFile::createFSEQFile(path, 2, FSEQFile::CompressionType::zstd, compressionLevel));
+        V2FSEQFile* f = dynamic_cast<V2FSEQFile*>(dest.get());
+        if (f == nullptr) {
+            return false;
+        }
+        dest->initializeFromFSEQ(src);
+        dest->setChannelCount(frameSize);
+        f->enableTemporalDelta(delta);
+        dest->writeHeader();
+        for (uint32_t x = 0; x < src.getNumFrames(); x++) {
+            dest->addFrame(x, &frames[(size_t)x * frameSize]);
+        }
+        dest->finalize();
+    }
+    result.encodeSeconds = std::chrono::duration<double>(clock::now() - start).count();
+    result.bytes = std::filesystem::file_size(path);
+
+    start = clock::now();
+    std::unique_ptr<FSEQFile> in(FSEQFile::openFSEQFile(path));
+    if (in == nullptr) {
+        return false;
+    }
+    in->setReadPattern(FSEQFile::ReadPattern::Bulk);
+    in->prepareRead({ { 0, frameSize } });
+    std::vector<uint8_t> frame(frameSize);
+    bool ok = true;
+    for (uint32_t x = 0; x < in->getNumFrames(); x++) {
+        std::unique_ptr<FSEQFile::FrameData> fdata(in->getFrame(x));
+        ok &= fdata != nullptr && fdata->readFrame(frame.data(), frameSize);
+        ok &= memcmp(frame.data(), &frames[(size_t)x * frameSize], frameSize) == 0;
+    }
+    result.decodeSeconds = std::chrono::duration<double>(clock::now() - start).count();
+    if (!ok) {
+        spdlog::error("{} did not read back the frames that were written", path);
+    }
+    return ok;
+}
+
+// Compare the size and speed of the plain zstd format with the temporal delta one
+static int runBenchmark(FSEQFile& src) {
+    uint32_t const frameSize = src.getChannelCount();
+    uint32_t const numFrames = src.getNumFrames();
+    if (frameSize == 0 || numFrames == 0) {
+        spdlog::critical("Nothing to benchmark in {}", src.getFilename());
+        return EXIT_FAILURE;
+    }
+    std::vector<uint8_t> frames((size_t)numFrames * frameSize);
+    src.prepareRead({ { 0, frameSize } });
+    for (uint32_t x = 0; x < numFrames; x++) {
+        std::unique_ptr<FSEQFile::FrameData> fdata(src.getFrame(x));
+        if (fdata == nullptr || !fdata->readFrame(&frames[(size_t)x * frameSize], frameSize)) {
+            spdlog::critical("Unable to read frame {} of {}", x, src.getFilename());
+            return EXIT_FAILURE;
+        }
+    }
+
+    double const rawMB = (double)frames.size() / (1024.0 * 1024.0);
+    spdlog::info("{}: {} frames x {} channels, {:.1f} MB uncompressed", src.getFilename(), numFrames, frameSize, rawMB);
+    auto const tmp = std::filesystem::temp_directory_path() / fmt::format("fseq_convert_bench_{}.fseq", src.getUniqueId());
+    bool ok = true;
+    for (bool delta : { false, true }) {
+        BenchResult r;
+        ok &= benchmarkFormat(src, frames, frameSize, tmp.string(), delta, r);
+        spdlog::info("  {:<14} {:>12} bytes  ratio {:>7.1f}:1  encode {:>8.1f} MB/s  decode {:>8.1f} MB/s",
+                     delta ? "zstd + delta" : "zstd",
+                     r.bytes,
+                     r.bytes ? (double)frames.size() / r.bytes : 0.0,
+                     r.encodeSeconds > 0 ? rawMB / r.encodeSeconds : 0.0,
+                     r.decodeSeconds > 0 ? rawMB / r.decodeSeconds : 0.0);
+    }
+    std::error_code ec;
+    std::filesystem::remove(tmp, ec);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 int main(int argc, char* argv[]) {
     spdlog::set_level(spdlog::level::debug);
     argparse::ArgumentParser program("fseq_convert", GIT_COMMIT_HASH);
     program.set_prefix_chars("-+/");
 
-    program.add_argument("-i", "--input").required().help("Input fseq File");
-    program.add_argument("-o", "--output").help("Ouput fseq File");
+    program.add_argument("-i", "--input").required().append().help("Input fseq File, more than one or a directory for batch mode");
+    program.add_argument("-o", "--output").help("Ouput fseq File, the output directory in batch mode");
     program.add_argument("-c", "--compression").help("Compression type (none|zstd|zlib)");
     program.add_argument("-r", "--ranges").append().help("Ranges, Start Channel-End Channel or Start Channel+Length(1-300|1+100)");
     program.add_argument("-f", "--freq").help("Set fseq version (1|2.0|2.2)");
     program.add_argument("-n", "--nosparse").flag().help("No Sparse Format");
     program.add_argument("-l", "--level").help("Compression level").scan<'i', int>();
     program.add_argument("-j", "--json").flag().help("Print Header As JSON");
+    program.add_argument("-d", "--dictionary").flag().help("Compress zstd blocks with a trained dictionary (fseq 2.3)");
+    program.add_argument("-t", "--delta").flag().help("Store zstd frames as differences from the previous frame (fseq 2.4)");
+    program.add_argument("-b", "--benchmark").flag().help("Report size and decode speed of the zstd formats for the input");
+    program.add_argument("-T", "--target").append().help("Batch output name=ranges, ranges as for -r separated by commas (remote1=1-3000,6001-9000)");
 
     try {
         program.parse_args(argc, argv);
@@ -56,11 +502,9 @@ int main(int argc, char* argv[]) {
         exit(EXIT_FAILURE);
     }
 
-    std::unique_ptr<FSEQFile> src(FSEQFile::openFSEQFile(program.get("-i")));
-    if (nullptr == src) {
-        spdlog::critical( "Error opening input file: {}", program.get("-i") );
-        exit(EXIT_FAILURE);
-    }
+    auto const inputs = program.get<std::vector<std::string>>("-i");
+    std::error_code ec;
+    bool const batch = inputs.size() > 1 || std::filesystem::is_directory(inputs[0], ec) || program.is_used("-T");
 
     if (program.is_used("-f")) {
         std::string const sversion = program.get("-f");
@@ -98,44 +542,49 @@ int main(int argc, char* argv[]) {
             exit(EXIT_FAILURE);
         }
     }
+    useDictionary = program.is_used("-d");
+    useTemporalDelta = program.is_used("-t");
     uint32_t channelCount { 0 };
     if (program.is_used("-r")) {
-        auto const inranges = program.get<std::vector<std::string>>("-r");
-        for (auto const& r : inranges) {
-            if (r.empty()) {
-                spdlog::critical("Invalid range format: {}", r);
-                exit(EXIT_FAILURE);
-            }
-            if (r.contains('-')) {
-                std::vector<std::string> const startEnd = split(r, '-');
-                if (startEnd.size() != 2) {
-                    spdlog::critical("Invalid range format: {}", r);
-                    exit(EXIT_FAILURE);
-                }
-                uint32_t const start = std::stoul(startEnd[0]);
-                uint32_t const end = std::stoul(startEnd[1]);
-                ranges.emplace_back(start - 1, end - start + 1);
-                channelCount += (end - start + 1);
-            } else if (r.contains('+')) {
-                std::vector<std::string> const startEnd = split(r, '+');
-                if (startEnd.size() != 2) {
-                    spdlog::critical("Invalid range format: {}", r);
-                    exit(EXIT_FAILURE);
-                }
-                uint32_t const start = std::stoul(startEnd[0]);
-                uint32_t const end = start + std::stoul(startEnd[1]);
-                ranges.emplace_back(start - 1, end);
-                channelCount += end;
-            } else {
-                if (r.empty()) {
-                    spdlog::critical("Invalid range format: {}", r);
+        if (!parseRanges(program.get<std::vector<std::string>>("-r"), ranges, channelCount)) {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (batch) {
+        if (!program.is_used("-o")) {
+            spdlog::critical("Batch mode needs an output directory");
+            exit(EXIT_FAILURE);
+        }
+        std::vector<BatchTarget> targets;
+        if (program.is_used("-T")) {
+            for (auto const& spec : program.get<std::vector<std::string>>("-T")) {
+                BatchTarget t;
+                if (!parseTarget(spec, t)) {
                     exit(EXIT_FAILURE);
                 }
+                targets.push_back(t);
             }
-            if (ranges.back().first >= src->getChannelCount()) {
-                spdlog::critical("Range start {} is out of bounds for the source file with {} channels", ranges.back().first, src->getChannelCount());
-                exit(EXIT_FAILURE);
-            }
+        } else if (!ranges.empty()) {
+            targets.push_back({ "", ranges, channelCount });
+        }
+        return runBatch(inputs, program.get("-o"), targets);
+    }
+
+    std::unique_ptr<FSEQFile> src(FSEQFile::openFSEQFile(inputs[0]));
+    if (nullptr == src) {
+        spdlog::critical( "Error opening input file: {}", inputs[0] );
+        exit(EXIT_FAILURE);
+    }
+
+    if (program.is_used("-b")) {
+        return runBenchmark(*src);
+    }
+
+    for (auto const& r : ranges) {
+        if (r.first >= src->getChannelCount()) {
+            spdlog::critical("Range start {} is out of bounds for the source file with {} channels", r.first, src->getChannelCount());
+            exit(EXIT_FAILURE);
         }
     }
 	
@@ -175,32 +624,24 @@ int main(int argc, char* argv[]) {
             ranges.push_back(std::pair<uint32_t, uint32_t>(0, ogNum_Channels));
             channelCount = ogNum_Channels;
         }
-        std::string const outputFile = program.get("-o");
-        std::unique_ptr<FSEQFile> dest(FSEQFile::createFSEQFile(outputFile,
-                                                                fseqMajVersion,
-                                                                compressionType,
-                                                                compressionLevel));
+        src->prepareRead(ranges);
+        std::unique_ptr<FSEQFile> dest(createOutput(*src, program.get("-o"), ranges, channelCount));
         if (nullptr == dest) {
-            spdlog::critical("Failed to create FSEQ file (returned nullptr)!");
             exit(EXIT_FAILURE);
         }
-        dest->enableMinorVersionFeatures(fseqMinVersion);
-
-        if (fseqMajVersion == 2 && sparse) {
-            V2FSEQFile* f = (V2FSEQFile*)dest.get();
-            f->m_sparseRanges = ranges;
-        }
-        src->prepareRead(ranges);
-
-        dest->initializeFromFSEQ(*src);
-        dest->setChannelCount(channelCount);
-        dest->writeHeader();
 
         uint8_t* data = (uint8_t*)malloc(8024 * 1024);
+        FSEQFile::FrameView view;
         for (int x = 0; x < src->getNumFrames(); x++) {
-            FSEQFile::FrameData* fdata = src->getFrame(x);
-            fdata->readFrame(data, 8024 * 1024);
-            delete fdata;
+            if (src->getFrameView(x, view)) {
+                view.readFrame(data, 8024 * 1024);
+            } else {
+                FSEQFile::FrameData* fdata = src->getFrame(x);
+                if (fdata == nullptr || !fdata->readFrame(data, 8024 * 1024)) {
+                    spdlog::error("Unable to read frame {}", x);
+                }
+                delete fdata;
+            }
 
             dest->addFrame(x, data);
         }
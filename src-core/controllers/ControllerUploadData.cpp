@@ -1320,67 +1320,62 @@ void UDController::ClearPorts() {
 void UDController::Rescan(bool eliminateOverlaps) {
     ClearPorts();
 
-    for (const auto& it : *_modelManager) {
-        if (!ModelProcessed(it.second, 1) && it.second->GetDisplayAs() != DisplayAsType::ModelGroup) {
-            int32_t modelstart = it.second->GetNumberFromChannelString(it.second->ModelStartChannel);
-            int32_t modelend = modelstart + it.second->GetChanCount() - 1;
-            if ((modelstart >= _controller->GetStartChannel() && modelstart <= _controller->GetEndChannel()) ||
-                (modelend >= _controller->GetStartChannel() && modelend <= _controller->GetEndChannel())) {
-                //spdlog::debug("Model {} start {} end {} found on controller {} output {} start {} end {}.",
-                //    (const char *)it->first.c_str(), modelstart, modelend,
-                //    (const char *)_ip.c_str(), node, currentcontrollerstartchannel, currentcontrollerendchannel);
-                if (!it.second->IsControllerConnectionValid()) {
-                    // only warn if we have not already warned
-                    if (std::find(_noConnectionModels.begin(), _noConnectionModels.end(), it.second) == _noConnectionModels.end()) {
-                        _noConnectionModels.push_back(it.second);
-                    }
-                } else {
-                    // model uses channels in this universe
-                    if (it.second->IsPixelProtocol()) {
-                        int strings = it.second->GetNumPhysicalStrings();
-                        if (strings == 1) {
-                            int port = it.second->GetControllerPort(1);
-                            GetControllerPixelPort(port)->AddModel(it.second, _controller, _outputManager, -1, eliminateOverlaps);
-                        } else {
-                            for (int i = 0; i < strings; i++) {
-                                int port = it.second->GetControllerPort(i+1);
-                                int32_t startChannel = it.second->GetStringStartChan(i) + 1;
-                                int32_t sc;
-                                Controller* c = _outputManager->GetController(startChannel, sc);
-                                if (c != nullptr &&
-                                    _controller->GetColumn2Label() == c->GetColumn2Label()) {
-                                    GetControllerPixelPort(port)->AddModel(it.second, _controller, _outputManager, i, eliminateOverlaps);
-                                }
+    // the index finds the models whose first or last channel is on this controller
+    for (const auto& entry : _modelManager->GetControllerModelIndex().GetModels(_controller)) {
+        Model* model = entry.model;
+        if (!ModelProcessed(model, 1)) {
+            int32_t modelstart = entry.startChannel;
+            if (!model->IsControllerConnectionValid()) {
+                // only warn if we have not already warned
+                if (std::find(_noConnectionModels.begin(), _noConnectionModels.end(), model) == _noConnectionModels.end()) {
+                    _noConnectionModels.push_back(model);
+                }
+            } else {
+                // model uses channels in this universe
+                if (model->IsPixelProtocol()) {
+                    int strings = model->GetNumPhysicalStrings();
+                    if (strings == 1) {
+                        int port = model->GetControllerPort(1);
+                        GetControllerPixelPort(port)->AddModel(model, _controller, _outputManager, -1, eliminateOverlaps);
+                    } else {
+                        for (int i = 0; i < strings; i++) {
+                            int port = model->GetControllerPort(i+1);
+                            int32_t startChannel = model->GetStringStartChan(i) + 1;
+                            int32_t sc;
+                            Controller* c = _outputManager->GetController(startChannel, sc);
+                            if (c != nullptr &&
+                                _controller->GetColumn2Label() == c->GetColumn2Label()) {
+                                GetControllerPixelPort(port)->AddModel(model, _controller, _outputManager, i, eliminateOverlaps);
                             }
                         }
-                    } else if (it.second->IsVirtualMatrixProtocol()) {
-                        int port = it.second->GetControllerPort(1);
-                        GetControllerVirtualMatrixPort(port)->AddModel(it.second, _controller, _outputManager, -1, eliminateOverlaps);
-                    } else if (it.second->IsLEDPanelMatrixProtocol()) {
-                        int port = it.second->GetControllerPort(1);
-                        GetControllerLEDPanelMatrixPort(port)->AddModel(it.second, _controller, _outputManager, -1, eliminateOverlaps);
-                    } else if (it.second->IsSerialProtocol()) {
-                        int port = it.second->GetControllerPort(1);
-                        GetControllerSerialPort(port)->AddModel(it.second, _controller, _outputManager, -1, eliminateOverlaps);
-                    } else if (it.second->IsPWMProtocol()) {
-                        std::vector<PWMOutput> outputs = it.second->GetPWMOutputs();
-                        int port = it.second->GetControllerPort(1);
-                        int string = 0;
-                        for (auto &o : outputs) {
-                            if (port <= _controller->GetControllerCaps()->GetMaxPWMPort()) {
-                                auto m = GetControllerPWMPort(port)->AddModel(it.second, _controller, _outputManager, string, eliminateOverlaps);
-                                if (o.type == PWMOutput::Type::LED) {
-                                    m->SetPWMLedPortProperties(o.label, o.brightness, o.gamma, o.startChannel, o.startChannel + o.channels - 1);
-                                } else {
-                                    m->SetPWMServoPortProperties(o.label, o.min_limit, o.max_limit,
-                                                                 o.reverse, o.zeroStyle, o.dataType,
-                                                                 o.startChannel, o.startChannel + o.channels - 1);
-                                }
+                    }
+                } else if (model->IsVirtualMatrixProtocol()) {
+                    int port = model->GetControllerPort(1);
+                    GetControllerVirtualMatrixPort(port)->AddModel(model, _controller, _outputManager, -1, eliminateOverlaps);
+                } else if (model->IsLEDPanelMatrixProtocol()) {
+                    int port = model->GetControllerPort(1);
+                    GetControllerLEDPanelMatrixPort(port)->AddModel(model, _controller, _outputManager, -1, eliminateOverlaps);
+                } else if (model->IsSerialProtocol()) {
+                    int port = model->GetControllerPort(1);
+                    GetControllerSerialPort(port)->AddModel(model, _controller, _outputManager, -1, eliminateOverlaps);
+                } else if (model->IsPWMProtocol()) {
+                    std::vector<PWMOutput> outputs = model->GetPWMOutputs();
+                    int port = model->GetControllerPort(1);
+                    int string = 0;
+                    for (auto &o : outputs) {
+                        if (port <= _controller->GetControllerCaps()->GetMaxPWMPort()) {
+                            auto m = GetControllerPWMPort(port)->AddModel(model, _controller, _outputManager, string, eliminateOverlaps);
+                            if (o.type == PWMOutput::Type::LED) {
+                                m->SetPWMLedPortProperties(o.label, o.brightness, o.gamma, o.startChannel, o.startChannel + o.channels - 1);
+                            } else {
+                                m->SetPWMServoPortProperties(o.label, o.min_limit, o.max_limit,
+                                                             o.reverse, o.zeroStyle, o.dataType,
+                                                             o.startChannel, o.startChannel + o.channels - 1);
                             }
-                            port++;
-                            string++;
-                            modelstart += o.channels;
                         }
+                        port++;
+                        string++;
+                        modelstart += o.channels;
                     }
                 }
             }
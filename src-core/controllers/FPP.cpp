@@ -54,6 +54,7 @@
 #include <log.h>
 #include "ControllerUploadData.h"
 #include "../render/FSEQFile.h"
+#include "FPPSequencePatch.h"
 #include "discovery/Discovery.h"
 #include "../utils/CurlManager.h"
 #include "../utils/ip_utils.h"
@@ -126,7 +127,7 @@ FPP::FPP(const std::string& ip_, const std::string& proxy_, const std::string& m
 FPP::FPP(const FPP &c)
     : hostName(c.hostName), description(c.description), ipAddress(c.ipAddress), fullVersion(c.fullVersion), platform(c.platform),
     model(c.model), majorVersion(c.majorVersion), minorVersion(c.minorVersion), patchVersion(c.patchVersion),
-    ranges(c.ranges), mode(c.mode), pixelControllerType(c.pixelControllerType), username(c.username), password(c.password),
+    supportsSequencePatch(c.supportsSequencePatch), ranges(c.ranges), mode(c.mode), pixelControllerType(c.pixelControllerType), username(c.username), password(c.password),
     fppType(c.fppType), _ui(nullptr), capeInfo(c.capeInfo), outputFile(nullptr) {
 
 }
@@ -499,6 +500,14 @@ bool FPP::parseSysInfo(nlohmann::json& val) {
     if (val.contains("majorVersion")) {
         majorVersion = GetJSONIntValue(val, "majorVersion");
     }
+    supportsSequencePatch = false;
+    if (val.contains("Capabilities") && val["Capabilities"].is_array()) {
+        for (const auto& c : val["Capabilities"]) {
+            if (c.is_string() && c.get<std::string>() == "SequencePatch") {
+                supportsSequencePatch = true;
+            }
+        }
+    }
     return true;
 }
 
@@ -859,6 +868,10 @@ public:
     std::string fileSizeHeader;
     std::string fileNameHeader;
     std::string filename;
+
+    // called once the last chunk is accepted (ok) or the upload gives up, cancelled
+    // when it gave up because the user cancelled
+    std::function<void(bool ok, bool cancelled)> onDone;
 };
 int progress_callback(void *clientp,
                       curl_off_t dltotal,
@@ -935,6 +948,8 @@ void prepareCurlForMulti(V7ProgressStruct *ps) {
         curl_easy_getinfo(c, CURLINFO_RESPONSE_CODE, &response_code);
         spdlog::info("    FPPConnect CURL Callback - URL: {}    Response: {}", ps->fullUrl, response_code);
         bool cancelled = false;
+        bool failed = false;
+        bool userCancelled = false;
         if (response_code != 200 && ps->errorCount < 3) {
             // strange error on upload, let's restart and try again (up to three attempts)
             ps->offset = 0;
@@ -945,13 +960,19 @@ void prepareCurlForMulti(V7ProgressStruct *ps) {
             ps->instance->messages.push_back("ERROR Uploading file: " + ps->filename + ". Response code: " + std::to_string(response_code));
             ps->instance->faileduploads.push_back(ps->filename);
             cancelled = true;
+            failed = true;
         } else {
             ps->offset += remaining;
         }
         uint64_t pct = ps->length > 0 ? (ps->offset * 1000) / ps->length : 1000;
-        cancelled |= ps->instance->updateProgress(pct, false);
+        userCancelled = ps->instance->updateProgress(pct, false);
+        cancelled |= userCancelled;
         if (cancelled || ps->offset >= ps->length) {
             spdlog::debug(ps->filename + " upload complete to " + ps->instance->hostName + " (" + ps->instance->ipAddress + "). Bytes sent:" + std::to_string(ps->length) + ".");
+            if (ps->onDone) {
+                ps->in.close();
+                ps->onDone(!failed && ps->offset >= ps->length, userCancelled && !failed);
+            }
             delete ps;
         } else {
             prepareCurlForMulti(ps);
@@ -962,7 +983,8 @@ void prepareCurlForMulti(V7ProgressStruct *ps) {
 
 bool FPP::uploadFileV7(const std::string &filename,
                        const std::string &file,
-                       const std::string &dir) {
+                       const std::string &dir,
+                       std::function<void(bool ok, bool cancelled)> onDone) {
     bool cancelled = false;
 
     V7ProgressStruct *ps = new V7ProgressStruct();
@@ -983,6 +1005,7 @@ bool FPP::uploadFileV7(const std::string &filename,
         ps->fileSizeHeader = "Upload-Length: " + std::to_string(ps->length);
         ps->fileNameHeader = "Upload-Name: " + filename;
         ps->instance = this;
+        ps->onDone = std::move(onDone);
         if (_progress.SetValue) {
             cancelled |= updateProgress(0, true);
         }
@@ -992,6 +1015,9 @@ bool FPP::uploadFileV7(const std::string &filename,
         messages.push_back("ERROR Uploading file: " + filename + "    Could not open source file: " + file);
         faileduploads.push_back(filename);
         delete ps;
+        if (onDone) {
+            onDone(false, false);
+        }
     }
     return cancelled;
 }
@@ -1005,6 +1031,111 @@ bool FPP::uploadOrCopyFile(const std::string &filename,
     return uploadFile(filename, file);
 }
 
+// The sequence cut into the segments FPPSequencePatch works with, empty if it is not
+// a v2 file with blocks.
+static std::vector<std::pair<uint64_t, uint64_t>> GetSequenceSegments(const std::string &file) {
+    std::unique_ptr<FSEQFile> seq(FSEQFile::openFSEQFile(file));
+    V2FSEQFile *v2 = dynamic_cast<V2FSEQFile*>(seq.get());
+    if (v2 == nullptr || v2->m_frameOffsets.empty()) {
+        return {};
+    }
+    std::error_code ec;
+    uint64_t fileSize = std::filesystem::file_size(file, ec);
+    if (ec) {
+        return {};
+    }
+    std::vector<uint64_t> blockOffsets;
+    blockOffsets.reserve(v2->m_frameOffsets.size());
+    for (const auto &fo : v2->m_frameOffsets) {
+        blockOffsets.push_back(fo.second);
+    }
+    return FPPSequencePatch::GetSegments(blockOffsets, fileSize);
+}
+
+// Sends only the parts of a sequence that FPP does not already have.  FPP is asked
+// for the hashes of the segments of its copy, the segments it lacks are uploaded as
+// a single patch file and a manifest tells it how to rebuild the new file from its
+// old copy and the patch.  Only used with players that advertise the SequencePatch
+// capability.  Anything that goes wrong along the way (too little in common, a
+// rejected patch) falls back to sending the whole file, unless the user cancelled.
+bool FPP::uploadSequencePatch(const std::string &filename,
+                              const std::string &file,
+                              bool deleteWhenDone) {
+    auto cleanup = [file, deleteWhenDone](bool, bool) {
+        if (deleteWhenDone) {
+            std::error_code ec;
+            std::filesystem::remove(file, ec);
+        }
+    };
+    auto fullUpload = [this, filename, file, cleanup]() {
+        return uploadFileV7(filename, file, "sequences", cleanup);
+    };
+
+    std::string blocks;
+    if (!GetURLAsString("/api/sequence/" + URLEncode(filename) + "/blocks", blocks, false)) {
+        return fullUpload();
+    }
+
+    auto segments = GetSequenceSegments(file);
+    std::ifstream in(file, std::ios::binary);
+    std::string patchFile = file + ".patch";
+    std::ofstream patch(patchFile, std::ios::binary | std::ios::trunc);
+    FPPSequencePatch::Patch plan;
+    bool built = in.is_open() && patch.is_open() && FPPSequencePatch::Build(in, segments, blocks, patch, plan);
+    in.close();
+    patch.close();
+    if (!built) {
+        { std::error_code ec; std::filesystem::remove(patchFile, ec); }
+        return fullUpload();
+    }
+
+    // the patch costs an extra request and a rebuild on the player, only worth it
+    // if a good part of the file is already there
+    if (plan.copied * 4 < plan.total) {
+        spdlog::debug("FPPConnect {} only shares {} of {} bytes with {}, sending the whole file.", filename, plan.copied, plan.total, ipAddress);
+        { std::error_code ec; std::filesystem::remove(patchFile, ec); }
+        return fullUpload();
+    }
+    spdlog::info("FPPConnect Patching {} on {}: reusing {} of {} bytes, sending {} bytes.", filename, ipAddress, plan.copied, plan.total, plan.patchLength);
+
+    nlohmann::json ops = nlohmann::json::array();
+    for (const auto &op : plan.ops) {
+        ops.push_back({ { op.copy ? "Source" : "Data", op.offset }, { "Length", op.length } });
+    }
+    nlohmann::json manifest;
+    manifest["Patch"] = filename + ".patch";
+    manifest["Length"] = plan.total;
+    manifest["Hash"] = plan.hash;
+    manifest["Ops"] = ops;
+
+    std::string fullUrl = ipAddress + "/api/sequence/" + URLEncode(filename) + "/patch";
+    if (!_fppProxy.empty()) {
+        fullUrl = "http://" + _fppProxy + "/proxy/" + fullUrl;
+    } else {
+        fullUrl = "http://" + fullUrl;
+    }
+    std::string body = manifest.dump();
+    return uploadFileV7(filename + ".patch", patchFile, "uploads", [this, filename, patchFile, fullUrl, body, fullUpload, cleanup](bool ok, bool cancelled) {
+        { std::error_code ec; std::filesystem::remove(patchFile, ec); }
+        if (cancelled) {
+            cleanup(false, true);
+            return;
+        }
+        if (!ok) {
+            fullUpload();
+            return;
+        }
+        CurlManager::INSTANCE.addPost(fullUrl, body, "application/json", [this, filename, fullUpload, cleanup](int rc, const std::string &resp) {
+            if (rc != 200) {
+                spdlog::info("FPPConnect {} rejected the patch for {} ({}), sending the whole file.", ipAddress, filename, rc);
+                fullUpload();
+            } else {
+                cleanup(true, false);
+            }
+        });
+    });
+}
+
 #ifndef DISCOVERYONLY
 // types
 // 0 - V1
@@ -1180,6 +1311,7 @@ bool FPP::PrepareUploadSequence(FSEQFile *file,
     }
 
     bool doSeqUpload = true;
+    sequenceOnPlayer = false;
     uint32_t currentMaxChannel = 0;
     uint32_t currentChannelCount = 0;
     std::vector<std::pair<uint32_t, uint32_t>> currentRanges;
@@ -1188,6 +1320,7 @@ bool FPP::PrepareUploadSequence(FSEQFile *file,
         nlohmann::json currentMeta;
         if (GetURLAsJSON("/api/sequence/" + URLEncode(baseName) + "/meta", currentMeta, false)) {
             doSeqUpload = false;
+            sequenceOnPlayer = true;
             char buf[24];
             snprintf(buf, sizeof(buf), "%" PRIu64, file->getUniqueId());
             std::string version = GetJSONStringValue(currentMeta, "Version");
@@ -1378,7 +1511,7 @@ bool FPP::WillUploadSequence() const {
 bool FPP::NeedCustomSequence() const {
     return outputFile != nullptr && !outputFileIsOriginal;
 }
-bool FPP::AddFrameToUpload(uint32_t frame, uint8_t *data) {
+bool FPP::AddFrameToUpload(uint32_t frame, const uint8_t *data) {
     if (outputFile && !outputFileIsOriginal) {
         outputFile->addFrame(frame, data);
     }
@@ -1398,9 +1531,14 @@ bool FPP::FinalizeUploadSequence() {
             if (EndsWith(baseSeqName, ".eseq")) {
                 directory = "effects";
             }
-            cancelled = uploadOrCopyFile(baseSeqName, tempFileName, directory);
-            if (!outputFileIsOriginal) {
-                { std::error_code ec; std::filesystem::remove(tempFileName, ec); }
+            if (fppType == FPP_TYPE::FPP && directory == "sequences" && sequenceOnPlayer && supportsSequencePatch) {
+                // the patch may still need the file once the upload has gone async, it cleans up after itself
+                cancelled = uploadSequencePatch(baseSeqName, tempFileName, !outputFileIsOriginal);
+            } else {
+                cancelled = uploadOrCopyFile(baseSeqName, tempFileName, directory);
+                if (!outputFileIsOriginal) {
+                    { std::error_code ec; std::filesystem::remove(tempFileName, ec); }
+                }
             }
             tempFileName = "";
             outputFileIsOriginal = false;
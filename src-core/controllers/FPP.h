@@ -4,6 +4,7 @@
 #include <map>
 #include <set>
 #include <algorithm>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -54,6 +55,8 @@ class FPP : public BaseController
     uint32_t majorVersion = 0;
     uint32_t minorVersion = 0;
     uint32_t patchVersion = 0;
+    // the player lists "SequencePatch" in its sysInfo Capabilities, see uploadSequencePatch
+    bool supportsSequencePatch = false;
     std::string ranges;
     std::string mode;
     std::string pixelControllerType;
@@ -113,7 +116,7 @@ class FPP : public BaseController
     bool CheckUploadMedia(const std::string &media, std::string &mediaBaseName);
     bool WillUploadSequence() const;
     bool NeedCustomSequence() const;
-    bool AddFrameToUpload(uint32_t frame, uint8_t *data);
+    bool AddFrameToUpload(uint32_t frame, const uint8_t *data);
     bool FinalizeUploadSequence();
     std::string GetTempFile() const { return tempFileName; }
     void ClearTempFile() { tempFileName = ""; }
@@ -208,7 +211,11 @@ private:
                     const std::string &file);
     bool uploadFileV7(const std::string &filename,
                       const std::string &file,
-                      const std::string &dir);
+                      const std::string &dir,
+                      std::function<void(bool ok, bool cancelled)> onDone = nullptr);
+    bool uploadSequencePatch(const std::string &filename,
+                             const std::string &file,
+                             bool deleteWhenDone);
     bool callMoveFile(const std::string &filename);
 
     bool parseSysInfo(nlohmann::json& v);
@@ -232,6 +239,7 @@ private:
     std::string baseSeqName;
     FSEQFile *outputFile = nullptr;
     bool outputFileIsOriginal = false;
+    bool sequenceOnPlayer = false;
 
     CURL *setupCurl(const std::string &url, bool isGet = true, int timeout = 30000);
     std::string curlInputBuffer;
@@ -0,0 +1,116 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "FPPSequencePatch.h"
+
+#include <algorithm>
+#include <map>
+
+#include <nlohmann/json.hpp>
+
+#include "../../dependencies/md5/md5.h"
+
+namespace FPPSequencePatch {
+
+std::vector<std::pair<uint64_t, uint64_t>> GetSegments(const std::vector<uint64_t>& blockOffsets,
+                                                       uint64_t fileSize,
+                                                       uint64_t segmentSize) {
+    std::vector<std::pair<uint64_t, uint64_t>> segments;
+    if (blockOffsets.empty() || segmentSize == 0) {
+        return segments;
+    }
+    std::vector<uint64_t> bounds;
+    bounds.push_back(0);
+    for (uint64_t off : blockOffsets) {
+        if (off > bounds.back() && off <= fileSize) {
+            bounds.push_back(off);
+        }
+    }
+    if (bounds.back() < fileSize) {
+        bounds.push_back(fileSize);
+    }
+    for (size_t x = 1; x < bounds.size(); x++) {
+        for (uint64_t off = bounds[x - 1]; off < bounds[x]; off += segmentSize) {
+            segments.push_back({ off, std::min(segmentSize, bounds[x] - off) });
+        }
+    }
+    return segments;
+}
+
+bool Build(std::istream& in,
+           const std::vector<std::pair<uint64_t, uint64_t>>& segments,
+           const std::string& blocksJson,
+           std::ostream& patch,
+           Patch& result) {
+    result = Patch();
+
+    nlohmann::json remote = nlohmann::json::parse(blocksJson, nullptr, false);
+    if (remote.is_discarded() || !remote.is_object() || !remote.contains("Blocks") || !remote["Blocks"].is_array()) {
+        return false;
+    }
+    // (hash, length) -> offset in FPP's copy
+    std::map<std::pair<std::string, uint64_t>, uint64_t> remoteSegments;
+    for (const auto& b : remote["Blocks"]) {
+        if (!b.is_object() || !b.contains("Hash") || !b.contains("Length") || !b.contains("Offset") ||
+            !b["Hash"].is_string() || !b["Length"].is_number_unsigned() || !b["Offset"].is_number_unsigned()) {
+            continue;
+        }
+        remoteSegments.emplace(std::make_pair(b["Hash"].get<std::string>(), b["Length"].get<uint64_t>()),
+                               b["Offset"].get<uint64_t>());
+    }
+    if (segments.empty() || remoteSegments.empty()) {
+        return false;
+    }
+
+    uint64_t lastSource = 0;
+    bool lastWasCopy = false;
+    MD5 fileHash;
+    std::vector<uint8_t> buf;
+    for (const auto& seg : segments) {
+        buf.resize(seg.second);
+        in.clear();
+        in.seekg(seg.first);
+        in.read(reinterpret_cast<char*>(buf.data()), seg.second);
+        if ((uint64_t)in.gcount() != seg.second) {
+            return false;
+        }
+        fileHash.update(buf.data(), (MD5::size_type)buf.size());
+        MD5 segHash;
+        segHash.update(buf.data(), (MD5::size_type)buf.size());
+        segHash.finalize();
+        result.total += seg.second;
+
+        auto it = remoteSegments.find(std::make_pair(segHash.hexdigest(), seg.second));
+        if (it != remoteSegments.end()) {
+            if (!result.ops.empty() && lastWasCopy && lastSource == it->second) {
+                result.ops.back().length += seg.second;
+            } else {
+                result.ops.push_back({ true, it->second, seg.second });
+            }
+            lastSource = it->second + seg.second;
+            lastWasCopy = true;
+            result.copied += seg.second;
+        } else {
+            patch.write(reinterpret_cast<const char*>(buf.data()), seg.second);
+            if (!result.ops.empty() && !lastWasCopy) {
+                result.ops.back().length += seg.second;
+            } else {
+                result.ops.push_back({ false, result.patchLength, seg.second });
+            }
+            result.patchLength += seg.second;
+            lastWasCopy = false;
+        }
+    }
+    fileHash.finalize();
+    result.hash = fileHash.hexdigest();
+    return patch.good();
+}
+
+} // namespace FPPSequencePatch
@@ -0,0 +1,62 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Works out how to bring the copy of a sequence FPP already has up to date by
+// sending only the parts it lacks (see FPP::uploadSequencePatch). Kept apart from
+// FPP so it can be driven without a player.
+namespace FPPSequencePatch {
+
+constexpr uint64_t SEGMENT_SIZE = 1024 * 1024;
+
+// Byte ranges (offset, length) of an fseq that are hashed and patched as a unit.
+// The boundaries are the header, each compressed block (blockOffsets, the file
+// offsets of the blocks in order) and whatever follows the last block, with
+// anything over segmentSize split from its start so an uncompressed file still
+// patches at a useful granularity. FPP has to cut its copy the same way.
+std::vector<std::pair<uint64_t, uint64_t>> GetSegments(const std::vector<uint64_t>& blockOffsets,
+                                                       uint64_t fileSize,
+                                                       uint64_t segmentSize = SEGMENT_SIZE);
+
+// Length bytes of the new file, copied from offset in FPP's existing copy or,
+// when !copy, from offset in the patch file.
+struct Op {
+    bool copy = false;
+    uint64_t offset = 0;
+    uint64_t length = 0;
+};
+
+struct Patch {
+    std::vector<Op> ops; // consecutive segments from the same place are merged into one op
+    uint64_t copied = 0;
+    uint64_t patchLength = 0;
+    uint64_t total = 0;
+    std::string hash; // md5 of the whole new file
+};
+
+// Reads the segments of the new file from in and matches them against the
+// segments FPP has, blocksJson being the response to
+// /api/sequence/<name>/blocks. The segments FPP lacks are written to patch.
+// Returns false if FPP's list is unusable or the file could not be read.
+bool Build(std::istream& in,
+           const std::vector<std::pair<uint64_t, uint64_t>>& segments,
+           const std::string& blocksJson,
+           std::ostream& patch,
+           Patch& result);
+
+} // namespace FPPSequencePatch
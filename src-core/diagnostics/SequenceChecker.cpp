@@ -5,13 +5,16 @@
 #include "diagnostics/SequenceChecker.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
 #include <filesystem>
 #include <map>
+#include <memory>
 #include <set>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 #include <spdlog/spdlog.h>
@@ -43,11 +46,14 @@
 #include "render/SequenceFile.h"
 #include "utils/ExternalHooks.h"
 #include "utils/FileUtils.h"
+#include "utils/Parallel.h"
 #include "utils/UtilClasses.h"
 #include "utils/UtilFunctions.h"
 #include "utils/ip_utils.h"
 #include "utils/string_utils.h"
 
+#include "../../dependencies/md5/md5.h"
+
 namespace {
 
 void LogMsg(const std::string& msg) {
@@ -1164,37 +1170,157 @@ int SequenceChecker::RunModelChecks(CheckSequenceReport& report) {
     return _errors - startErrors;
 }
 
-void SequenceChecker::CheckEffect(Effect* ef, CheckSequenceReport& report,
+struct SequenceChecker::EffectCheckResult {
+    std::vector<CheckSequenceReport::ReportIssue> issues;
+    bool videoCacheWarning = false;
+    bool disabled = false;
+    std::vector<std::string> faces;  // used on modelName
+    std::vector<std::string> states; // used on modelName
+    std::vector<std::string> viewPoints;
+    std::vector<std::string> files; // the effect's file references, resolved
+};
+
+struct SequenceChecker::ElementCheckResult {
+    std::vector<CheckSequenceReport::ReportIssue> issues;
+    bool videoCacheWarning = false;
+    bool disabledEffects = false;
+    std::list<std::pair<std::string, std::string>> faces;
+    std::list<std::pair<std::string, std::string>> states;
+    std::list<std::string> viewPoints;
+    int effects = 0;
+    int reused = 0;
+};
+
+// Effect checks from the last run, keyed on the MD5 of everything the check
+// reads. Entries not used by a run are dropped at its end so the cache only
+// ever holds one sequence's worth.
+struct SequenceChecker::EffectCheckCache {
+    struct Entry {
+        EffectCheckResult result;
+        std::vector<std::pair<std::string, FileState>> files; // as they were when the check ran
+    };
+
+    std::mutex lock;
+    std::unordered_map<std::string, std::shared_ptr<const Entry>> entries;
+    std::unordered_map<std::string, std::shared_ptr<const Entry>> used;
+};
+
+SequenceChecker::EffectCheckCache& SequenceChecker::GetEffectCheckCache() {
+    static EffectCheckCache cache;
+    return cache;
+}
+
+template<typename T>
+static void AddUnique(std::list<T>& list, const T& value) {
+    if (std::find(list.begin(), list.end(), value) == list.end()) {
+        list.push_back(value);
+    }
+}
+
+SequenceChecker::FileState SequenceChecker::GetFileState(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(_fileStatesLock);
+        auto it = _fileStates.find(path);
+        if (it != _fileStates.end()) {
+            return it->second;
+        }
+    }
+    FileState state;
+    if (!path.empty() && FileExists(path)) {
+        state.exists = true;
+        std::error_code ec;
+        state.size = std::filesystem::file_size(path, ec);
+        if (ec) {
+            state.size = 0;
+        }
+        auto modified = std::filesystem::last_write_time(path, ec);
+        if (!ec) {
+            state.modified = (int64_t)modified.time_since_epoch().count();
+        }
+    }
+    std::lock_guard<std::mutex> lock(_fileStatesLock);
+    _fileStates.emplace(path, state);
+    return state;
+}
+
+void SequenceChecker::CacheFileStates(const std::vector<std::string>& paths) {
+    std::vector<std::string> missing;
+    {
+        std::lock_guard<std::mutex> lock(_fileStatesLock);
+        for (const auto& it : paths) {
+            if (_fileStates.find(it) == _fileStates.end()) {
+                missing.push_back(it);
+            }
+        }
+    }
+    std::sort(missing.begin(), missing.end());
+    missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
+    // lookups are mostly waiting on the disk (or network share) so do them together
+    parallel_for(0, (int)missing.size(), [&](int i) {
+        GetFileState(missing[i]);
+    });
+}
+
+std::string SequenceChecker::GetEffectCheckContext() {
+    std::string ctx = fmt::format("{}|{}|{}|{}|", _renderCacheMode, _transTimeDisabled, _models.GetModelGeneration(), _showFolder);
+    if (_sequenceFile != nullptr) {
+        FileState media = GetFileState(_sequenceFile->GetMediaFile());
+        ctx += fmt::format("{}|{}|{}|{}|{}|", _sequenceFile->GetSequenceDurationMS(), _sequenceFile->GetMediaFile(),
+                           media.exists, media.size, media.modified);
+    }
+    // timing tracks effects can refer to
+    for (size_t i = 0; i < _elements.GetElementCount(MASTER_VIEW); i++) {
+        Element* e = _elements.GetElement(i);
+        if (e != nullptr && e->GetType() == ElementType::ELEMENT_TYPE_TIMING) {
+            ctx += e->GetName() + "|";
+        }
+    }
+    // sequence level faces and what is embedded in the sequence
+    for (const auto& [faceName, def] : _elements.GetSequenceFaces().GetFaces()) {
+        ctx += faceName + "|";
+        for (const auto& [key, value] : def) {
+            ctx += key + "=" + value + "|";
+            if (SequenceFaces::IsImageKey(key) && !value.empty()) {
+                FileState image = GetFileState(FileUtils::FixFile("", value));
+                ctx += fmt::format("{}{}{}|", image.exists, image.size, image.modified);
+            }
+        }
+    }
+    for (const auto& it : _elements.GetSequenceMedia().GetAllMediaPaths()) {
+        auto embed = _elements.GetSequenceMedia().GetMediaEmbedState(it.first);
+        ctx += fmt::format("{}={}{}|", it.first, embed.first, embed.second);
+    }
+
+    MD5 md5;
+    md5.update(ctx.c_str(), (MD5::size_type)ctx.size());
+    md5.finalize();
+    return md5.hexdigest();
+}
+
+void SequenceChecker::CheckEffect(Effect* ef,
                                   const std::string& elementName,
                                   const std::string& modelName,
                                   int layerIndex,
                                   bool node,
-                                  bool& videoCacheWarning,
-                                  bool& disabledEffects,
-                                  std::list<std::pair<std::string, std::string>>& faces,
-                                  std::list<std::pair<std::string, std::string>>& states,
-                                  std::list<std::string>& viewPoints,
-                                  std::list<std::string>& allFiles) {
+                                  EffectCheckResult& result) {
     EffectManager& em = _elements.GetEffectManager();
     SettingsMap& sm = ef->GetSettings();
-    std::string renderCacheMode = _callbacks ? _callbacks->GetRenderCacheMode() : std::string("Enabled");
 
     if (ef->GetEffectName() == "Video") {
-        if (renderCacheMode == "Disabled") {
-            videoCacheWarning = true;
-        } else if (!ef->IsLocked() && renderCacheMode == "Locked Only") {
-            videoCacheWarning = true;
+        if (_renderCacheMode == "Disabled") {
+            result.videoCacheWarning = true;
+        } else if (!ef->IsLocked() && _renderCacheMode == "Locked Only") {
+            result.videoCacheWarning = true;
             std::string msg = fmt::format("    WARN: Video effect unlocked but only locked video effects are being render cached. Effect: {}, Model: {}, Start {}",
                                           ef->GetEffectName(), modelName, FORMATTIME(ef->GetStartTimeMS()));
-            RecordIssue(report, "sequence",
-                        CheckSequenceReport::ReportIssue::ForEffect(
-                            CheckSequenceReport::ReportIssue::WARNING, msg, "videocache",
-                            modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layerIndex));
+            result.issues.push_back(CheckSequenceReport::ReportIssue::ForEffect(
+                CheckSequenceReport::ReportIssue::WARNING, msg, "videocache",
+                modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layerIndex));
         }
     }
 
     if (ef->IsRenderDisabled())
-        disabledEffects = true;
+        result.disabled = true;
 
     bool isPerModel = false;
     bool isSubBuffer = false;
@@ -1205,10 +1331,9 @@ void SequenceChecker::CheckEffect(Effect* ef, CheckSequenceReport& report,
     if (isPerModel && isSubBuffer) {
         std::string msg = fmt::format("    ERR: Effect on a model group using a 'Per Model' render buffer is also using a subbuffer. This will not work as you might expect. Effect: {}, Model: {}, Start {}",
                                       ef->GetEffectName(), modelName, FORMATTIME(ef->GetStartTimeMS()));
-        RecordIssue(report, "sequence",
-                    CheckSequenceReport::ReportIssue::ForEffect(
-                        CheckSequenceReport::ReportIssue::CRITICAL, msg, "buffer",
-                        modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layerIndex));
+        result.issues.push_back(CheckSequenceReport::ReportIssue::ForEffect(
+            CheckSequenceReport::ReportIssue::CRITICAL, msg, "buffer",
+            modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layerIndex));
     }
 
     // very old value curves not yet upgraded
@@ -1227,10 +1352,9 @@ void SequenceChecker::CheckEffect(Effect* ef, CheckSequenceReport& report,
             }
             std::string msg = fmt::format("    ERR: Effect contains very old value curve. Click on this effect and then save the sequence to convert it. Effect: {}, Model: {}, Start {} ({})",
                                           ef->GetEffectName(), modelName, FORMATTIME(ef->GetStartTimeMS()), property);
-            RecordIssue(report, "sequence",
-                        CheckSequenceReport::ReportIssue::ForEffect(
-                            CheckSequenceReport::ReportIssue::CRITICAL, msg, "oldcurves",
-                            modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layerIndex));
+            result.issues.push_back(CheckSequenceReport::ReportIssue::ForEffect(
+                CheckSequenceReport::ReportIssue::CRITICAL, msg, "oldcurves",
+                modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layerIndex));
         }
     }
 
@@ -1243,38 +1367,34 @@ void SequenceChecker::CheckEffect(Effect* ef, CheckSequenceReport& report,
             ef->GetEffectName() != "Kaleidoscope" && ef->GetEffectName() != "Shader") {
             std::string msg = fmt::format("    WARN: Canvas mode enabled on an effect it is not normally used on. This will slow down rendering. Effect: {}, Model: {}, Start {}",
                                           ef->GetEffectName(), modelName, FORMATTIME(ef->GetStartTimeMS()));
-            RecordIssue(report, "sequence",
-                        CheckSequenceReport::ReportIssue::ForEffect(
-                            CheckSequenceReport::ReportIssue::WARNING, msg, "canvas",
-                            modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layerIndex));
+            result.issues.push_back(CheckSequenceReport::ReportIssue::ForEffect(
+                CheckSequenceReport::ReportIssue::WARNING, msg, "canvas",
+                modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layerIndex));
         }
     }
 
-    if (!(_callbacks && _callbacks->IsCheckOptionDisabled("TransTime"))) {
+    if (!_transTimeDisabled) {
         if (fadein > efdur) {
             std::string msg = fmt::format("    WARN: Transition in time {:.2f} on effect {} at start time {}  on Model '{}' is greater than effect duration {:.2f}.",
                                           fadein, ef->GetEffectName(), FORMATTIME(ef->GetStartTimeMS()), elementName, efdur);
-            RecordIssue(report, "sequence",
-                        CheckSequenceReport::ReportIssue::ForEffect(
-                            CheckSequenceReport::ReportIssue::WARNING, msg, "transitions",
-                            modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layerIndex));
+            result.issues.push_back(CheckSequenceReport::ReportIssue::ForEffect(
+                CheckSequenceReport::ReportIssue::WARNING, msg, "transitions",
+                modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layerIndex));
         }
         if (fadeout > efdur) {
             std::string msg = fmt::format("    WARN: Transition out time {:.2f} on effect {} at start time {}  on Model '{}' is greater than effect duration {:.2f}.",
                                           fadeout, ef->GetEffectName(), FORMATTIME(ef->GetStartTimeMS()), elementName, efdur);
-            RecordIssue(report, "sequence",
-                        CheckSequenceReport::ReportIssue::ForEffect(
-                            CheckSequenceReport::ReportIssue::WARNING, msg, "transitions",
-                            modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layerIndex));
+            result.issues.push_back(CheckSequenceReport::ReportIssue::ForEffect(
+                CheckSequenceReport::ReportIssue::WARNING, msg, "transitions",
+                modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layerIndex));
         }
         if (fadein <= efdur && fadeout <= efdur && fadein + fadeout > efdur) {
             std::string msg = fmt::format("    WARN: Transition in time {:.2f} + transition out time {:.2f} = {:.2f} on effect {} at start time {}  on Model '{}' is greater than effect duration {:.2f}.",
                                           fadein, fadeout, fadein + fadeout, ef->GetEffectName(),
                                           FORMATTIME(ef->GetStartTimeMS()), elementName, efdur);
-            RecordIssue(report, "sequence",
-                        CheckSequenceReport::ReportIssue::ForEffect(
-                            CheckSequenceReport::ReportIssue::WARNING, msg, "transitions",
-                            modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layerIndex));
+            result.issues.push_back(CheckSequenceReport::ReportIssue::ForEffect(
+                CheckSequenceReport::ReportIssue::WARNING, msg, "transitions",
+                modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layerIndex));
         }
     }
 
@@ -1283,10 +1403,9 @@ void SequenceChecker::CheckEffect(Effect* ef, CheckSequenceReport& report,
                                       ef->GetEffectName(), FORMATTIME(ef->GetEndTimeMS()),
                                       FORMATTIME(_sequenceFile->GetSequenceDurationMS()), elementName,
                                       FORMATTIME(ef->GetStartTimeMS()));
-        RecordIssue(report, "sequence",
-                    CheckSequenceReport::ReportIssue::ForEffect(
-                        CheckSequenceReport::ReportIssue::WARNING, msg, "timing",
-                        modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layerIndex));
+        result.issues.push_back(CheckSequenceReport::ReportIssue::ForEffect(
+            CheckSequenceReport::ReportIssue::WARNING, msg, "timing",
+            modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layerIndex));
     }
 
     auto looksNumericEnough = [](const std::string& v) -> bool {
@@ -1356,10 +1475,9 @@ void SequenceChecker::CheckEffect(Effect* ef, CheckSequenceReport& report,
                 std::string msg = fmt::format(
                     "    ERR: Effect has invalid numeric value '{}' for setting '{}'. Effect: {}, Model: {}, Start {}",
                     val, key, ef->GetEffectName(), modelName, FORMATTIME(ef->GetStartTimeMS()));
-                RecordIssue(report, "sequence",
-                            CheckSequenceReport::ReportIssue::ForEffect(
-                                CheckSequenceReport::ReportIssue::CRITICAL, msg, "corruptsettings",
-                                modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layerIndex));
+                result.issues.push_back(CheckSequenceReport::ReportIssue::ForEffect(
+                    CheckSequenceReport::ReportIssue::CRITICAL, msg, "corruptsettings",
+                    modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layerIndex));
             }
         }
     };
@@ -1372,84 +1490,56 @@ void SequenceChecker::CheckEffect(Effect* ef, CheckSequenceReport& report,
             if (node && !re->AppropriateOnNodes()) {
                 std::string msg = fmt::format("    WARN: Effect {} at start time {}  on Model '{}' really shouldnt be used at the node level.",
                                               ef->GetEffectName(), FORMATTIME(ef->GetStartTimeMS()), elementName);
-                RecordIssue(report, "sequence",
-                            CheckSequenceReport::ReportIssue::ForEffect(
-                                CheckSequenceReport::ReportIssue::WARNING, msg, "nodes",
-                                modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layerIndex));
+                result.issues.push_back(CheckSequenceReport::ReportIssue::ForEffect(
+                    CheckSequenceReport::ReportIssue::WARNING, msg, "nodes",
+                    modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layerIndex));
             }
 
-            bool renderCache = renderCacheMode == "Enabled" ||
-                               (renderCacheMode == "Locked Only" && ef->IsLocked());
+            bool renderCache = _renderCacheMode == "Enabled" ||
+                               (_renderCacheMode == "Locked Only" && ef->IsLocked());
             Model* m = _models.GetModel(elementName);
             if (m == nullptr) {
                 m = _models.GetModel(modelName);
             }
             AudioManager* media = _sequenceFile ? _sequenceFile->GetMedia() : nullptr;
 
-            // `RenderableEffect::GetTiming()` (used by VUMeter, Servo,
-            // Faces, State, etc. inside CheckEffectSettings to validate
-            // timing-track references) walks `mSequenceElements`. The
-            // EffectManager singletons never have it set (no propagation
-            // path on either platform), which made every "Timing Event"
-            // VU Meter etc. report "unknown timing track" even when the
-            // track exists. Set it for the call and restore so we don't
-            // leave a dangling pointer once this checker goes away.
-            SequenceElements* prevSeqElements = re->GetSequenceElements();
-            re->SetSequenceElements(&_elements);
+            // `mSequenceElements` is pointed at `_elements` for the
+            // whole walk by `RunSequenceChecks`
             std::list<std::string> warnings = re->CheckEffectSettings(sm, media, m, ef, renderCache);
-            re->SetSequenceElements(prevSeqElements);
             for (const auto& s : warnings) {
                 auto issueType = (s.find("WARN:") != std::string::npos)
                                      ? CheckSequenceReport::ReportIssue::WARNING
                                      : CheckSequenceReport::ReportIssue::CRITICAL;
-                RecordIssue(report, "sequence",
-                            CheckSequenceReport::ReportIssue::ForEffect(
-                                issueType, s + "--Effect:" + ef->GetEffectName(), "effectsettings",
-                                modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layerIndex));
+                result.issues.push_back(CheckSequenceReport::ReportIssue::ForEffect(
+                    issueType, s + "--Effect:" + ef->GetEffectName(), "effectsettings",
+                    modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layerIndex));
             }
 
-            // Accumulate referenced files for this effect
+            // Files this effect reads, the result depends on them
             if (m != nullptr) {
-                auto refs = re->GetFileReferences(m, sm);
-                allFiles.splice(allFiles.end(), refs);
+                for (const auto& it : re->GetFileReferences(m, sm)) {
+                    result.files.push_back(FileUtils::FixFile("", it));
+                }
             }
 
             if (ef->GetEffectName() == "Faces") {
                 for (const auto& it : static_cast<FacesEffect*>(re)->GetFacesUsed(sm)) {
-                    bool found = false;
-                    for (auto it2 : faces) {
-                        if (it2.first == modelName && it2.second == it) {
-                            found = true;
-                        }
-                    }
-                    if (!found) {
-                        faces.push_back({ modelName, it });
+                    if (std::find(result.faces.begin(), result.faces.end(), it) == result.faces.end()) {
+                        result.faces.push_back(it);
                     }
                 }
             } else if (ef->GetEffectName() == "State") {
                 for (const auto& it : static_cast<StateEffect*>(re)->GetStatesUsed(sm)) {
-                    bool found = false;
-                    for (auto it2 : states) {
-                        if (it2.first == modelName && it2.second == it) {
-                            found = true;
-                        }
-                    }
-                    if (!found) {
-                        states.push_back({ modelName, it });
+                    if (std::find(result.states.begin(), result.states.end(), it) == result.states.end()) {
+                        result.states.push_back(it);
                     }
                 }
             }
 
             for (const auto& it : sm) {
                 if (it.first == "B_CHOICE_PerPreviewCamera") {
-                    bool found = false;
-                    for (auto it2 : viewPoints) {
-                        if (it2 == it.second) {
-                            found = true;
-                        }
-                    }
-                    if (!found) {
-                        viewPoints.push_back(it.second);
+                    if (std::find(result.viewPoints.begin(), result.viewPoints.end(), it.second) == result.viewPoints.end()) {
+                        result.viewPoints.push_back(it.second);
                     }
                 }
             }
@@ -1457,18 +1547,94 @@ void SequenceChecker::CheckEffect(Effect* ef, CheckSequenceReport& report,
     }
 }
 
-void SequenceChecker::CheckElement(Element* e, CheckSequenceReport& report,
+void SequenceChecker::CheckEffectCached(Effect* ef,
+                                        const std::string& elementName,
+                                        const std::string& modelName,
+                                        int layerIndex,
+                                        bool node,
+                                        ElementCheckResult& result) {
+    // effects whose checks read other elements or timing tracks are checked every time
+    RenderableEffect* re = ef->GetEffectIndex() >= 0 ? _elements.GetEffectManager().GetEffect(ef->GetEffectIndex()) : nullptr;
+    if (re != nullptr && !re->CheckEffectSettingsIsSelfContained()) {
+        EffectCheckResult checked;
+        CheckEffect(ef, elementName, modelName, layerIndex, node, checked);
+        AddEffectCheckResult(checked, modelName, result);
+        return;
+    }
+
+    // the same model CheckEffect hands to CheckEffectSettings
+    Model* m = _models.GetModel(elementName);
+    if (m == nullptr) {
+        m = _models.GetModel(modelName);
+    }
+    std::string key = fmt::format("{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|", _effectCheckContext, elementName, modelName, layerIndex, node,
+                                  ef->GetEffectName(), ef->GetEffectIndex(), ef->GetStartTimeMS(), ef->GetEndTimeMS(),
+                                  ef->IsLocked(), ef->IsRenderDisabled(), (uintptr_t)m, m == nullptr ? 0 : m->GetChangeCount());
+    key += ef->GetSettingsAsString() + "|" + ef->GetPaletteAsString();
+    MD5 md5;
+    md5.update(key.c_str(), (MD5::size_type)key.size());
+    md5.finalize();
+    key = md5.hexdigest();
+
+    EffectCheckCache& cache = GetEffectCheckCache();
+    std::shared_ptr<const EffectCheckCache::Entry> entry;
+    {
+        std::lock_guard<std::mutex> lock(cache.lock);
+        auto it = cache.entries.find(key);
+        if (it != cache.entries.end()) {
+            entry = it->second;
+        }
+    }
+    // only good if every file the check read is still as it was
+    if (entry != nullptr) {
+        for (const auto& [path, state] : entry->files) {
+            if (!(GetFileState(path) == state)) {
+                entry = nullptr;
+                break;
+            }
+        }
+    }
+    if (entry != nullptr) {
+        ++result.reused;
+    } else {
+        auto checked = std::make_shared<EffectCheckCache::Entry>();
+        CheckEffect(ef, elementName, modelName, layerIndex, node, checked->result);
+        for (const auto& it : checked->result.files) {
+            checked->files.push_back({ it, GetFileState(it) });
+        }
+        entry = checked;
+    }
+    {
+        std::lock_guard<std::mutex> lock(cache.lock);
+        cache.used[key] = entry;
+    }
+    AddEffectCheckResult(entry->result, modelName, result);
+}
+
+void SequenceChecker::AddEffectCheckResult(const EffectCheckResult& checked,
+                                           const std::string& modelName,
+                                           ElementCheckResult& result) {
+    ++result.effects;
+
+    result.issues.insert(result.issues.end(), checked.issues.begin(), checked.issues.end());
+    result.videoCacheWarning |= checked.videoCacheWarning;
+    result.disabledEffects |= checked.disabled;
+    for (const auto& it : checked.faces) {
+        AddUnique(result.faces, std::make_pair(modelName, it));
+    }
+    for (const auto& it : checked.states) {
+        AddUnique(result.states, std::make_pair(modelName, it));
+    }
+    for (const auto& it : checked.viewPoints) {
+        AddUnique(result.viewPoints, it);
+    }
+}
+
+void SequenceChecker::CheckElement(Element* e,
                                    const std::string& name,
                                    const std::string& modelName,
-                                   bool& videoCacheWarning,
-                                   bool& disabledEffects,
-                                   std::list<std::pair<std::string, std::string>>& faces,
-                                   std::list<std::pair<std::string, std::string>>& states,
-                                   std::list<std::string>& viewPoints,
-                                   bool& usesShader,
-                                   std::list<std::string>& allFiles) {
+                                   ElementCheckResult& result) {
     Model* m = _models[modelName];
-    EffectManager& em = _elements.GetEffectManager();
 
     int layer = 0;
     for (const auto& el : e->GetEffectLayers()) {
@@ -1478,27 +1644,19 @@ void SequenceChecker::CheckElement(Element* e, CheckSequenceReport& report,
                 std::string msg = fmt::format("    ERR: Effect {} ({}-{}) on Model '{}' layer {} is a random effect. This should never happen and may cause other issues.",
                                               ef->GetEffectName(), FORMATTIME(ef->GetStartTimeMS()),
                                               FORMATTIME(ef->GetEndTimeMS()), name, layer);
-                RecordIssue(report, "sequence",
-                            CheckSequenceReport::ReportIssue::ForEffect(
-                                CheckSequenceReport::ReportIssue::CRITICAL, msg, "unexpected",
-                                modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layer));
+                result.issues.push_back(CheckSequenceReport::ReportIssue::ForEffect(
+                    CheckSequenceReport::ReportIssue::CRITICAL, msg, "unexpected",
+                    modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layer));
             } else {
-                RenderableEffect* eff = em.GetEffect(ef->GetEffectIndex());
-                if (eff != nullptr) {
-                    auto refs = eff->GetFileReferences(m, ef->GetSettings());
-                    allFiles.splice(allFiles.end(), refs);
-                }
-
                 if (m != nullptr) {
                     if (e->GetType() == ElementType::ELEMENT_TYPE_MODEL) {
                         if (m->GetNodeCount() == 0) {
                             std::string msg = fmt::format("    ERR: Effect {} ({}-{}) on Model '{}' layer {} Has no nodes and wont do anything.",
                                                           ef->GetEffectName(), FORMATTIME(ef->GetStartTimeMS()),
                                                           FORMATTIME(ef->GetEndTimeMS()), name, layer);
-                            RecordIssue(report, "sequence",
-                                        CheckSequenceReport::ReportIssue::ForEffect(
-                                            CheckSequenceReport::ReportIssue::CRITICAL, msg, "nonodestorender",
-                                            modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layer));
+                            result.issues.push_back(CheckSequenceReport::ReportIssue::ForEffect(
+                                CheckSequenceReport::ReportIssue::CRITICAL, msg, "nonodestorender",
+                                modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layer));
                         }
                     } else if (e->GetType() == ElementType::ELEMENT_TYPE_STRAND) {
                         StrandElement* se = (StrandElement*)e;
@@ -1506,10 +1664,9 @@ void SequenceChecker::CheckElement(Element* e, CheckSequenceReport& report,
                             std::string msg = fmt::format("    ERR: Effect {} ({}-{}) on Model '{}' layer {} Has no nodes and wont do anything.",
                                                           ef->GetEffectName(), FORMATTIME(ef->GetStartTimeMS()),
                                                           FORMATTIME(ef->GetEndTimeMS()), name, layer);
-                            RecordIssue(report, "sequence",
-                                        CheckSequenceReport::ReportIssue::ForEffect(
-                                            CheckSequenceReport::ReportIssue::CRITICAL, msg, "nonodestorender",
-                                            modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layer));
+                            result.issues.push_back(CheckSequenceReport::ReportIssue::ForEffect(
+                                CheckSequenceReport::ReportIssue::CRITICAL, msg, "nonodestorender",
+                                modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layer));
                         }
                     } else if (e->GetType() == ElementType::ELEMENT_TYPE_SUBMODEL) {
                         Model* se = _models[name];
@@ -1517,19 +1674,14 @@ void SequenceChecker::CheckElement(Element* e, CheckSequenceReport& report,
                             std::string msg = fmt::format("    ERR: Effect {} ({}-{}) on Model '{}' layer {} Has no nodes and wont do anything.",
                                                           ef->GetEffectName(), FORMATTIME(ef->GetStartTimeMS()),
                                                           FORMATTIME(ef->GetEndTimeMS()), name, layer);
-                            RecordIssue(report, "sequence",
-                                        CheckSequenceReport::ReportIssue::ForEffect(
-                                            CheckSequenceReport::ReportIssue::CRITICAL, msg, "nonodestorender",
-                                            modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layer));
+                            result.issues.push_back(CheckSequenceReport::ReportIssue::ForEffect(
+                                CheckSequenceReport::ReportIssue::CRITICAL, msg, "nonodestorender",
+                                modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layer));
                         }
                     }
                 }
 
-                CheckEffect(ef, report, name, modelName, layer, false,
-                            videoCacheWarning, disabledEffects, faces, states, viewPoints, allFiles);
-                if (ef->GetEffectName() == "Shader") {
-                    usesShader = true;
-                }
+                CheckEffectCached(ef, name, modelName, layer, false, result);
             }
         }
 
@@ -1544,10 +1696,9 @@ void SequenceChecker::CheckElement(Element* e, CheckSequenceReport& report,
                                                   FORMATTIME(lastEffect->GetStartTimeMS()),
                                                   FORMATTIME(lastEffect->GetEndTimeMS()),
                                                   name, layer);
-                    RecordIssue(report, "sequence",
-                                CheckSequenceReport::ReportIssue::ForEffect(
-                                    CheckSequenceReport::ReportIssue::CRITICAL, msg, "impossibleoverlap",
-                                    modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layer));
+                    result.issues.push_back(CheckSequenceReport::ReportIssue::ForEffect(
+                        CheckSequenceReport::ReportIssue::CRITICAL, msg, "impossibleoverlap",
+                        modelName, ef->GetEffectName(), ef->GetStartTimeMS(), layer));
                 }
             }
             lastEffect = ef;
@@ -1591,7 +1742,7 @@ int SequenceChecker::RunSequenceChecks(CheckSequenceReport& report) {
         }
 
         if (_sequenceFile->GetSequenceType() == "Media") {
-            if (!FileExists(_sequenceFile->GetMediaFile())) {
+            if (!GetFileState(_sequenceFile->GetMediaFile()).exists) {
                 std::string msg = fmt::format("    ERR: media file {} does not exist.",
                                               _sequenceFile->GetMediaFile());
                 RecordIssue(report, "sequence",
@@ -1608,7 +1759,7 @@ int SequenceChecker::RunSequenceChecks(CheckSequenceReport& report) {
                 // FixFile so relative / moved-sequence paths resolve the way
                 // the renderer will resolve them
                 std::string resolved = FileUtils::FixFile("", value);
-                if (resolved.empty() || !FileExists(resolved)) {
+                if (resolved.empty() || !GetFileState(resolved).exists) {
                     std::string msg = fmt::format("    ERR: Sequence face '{}' image missing {}.",
                                                   faceName, value);
                     RecordIssue(report, "sequence",
@@ -1653,67 +1804,130 @@ int SequenceChecker::RunSequenceChecks(CheckSequenceReport& report) {
             }
         }
 
-        // Walk every element / effect
-        bool disabledEffects = false;
-        bool videoCacheWarning = false;
-        std::list<std::pair<std::string, std::string>> faces;
-        std::list<std::pair<std::string, std::string>> states;
-        std::list<std::string> viewPoints;
-        bool usesShader = false;
-        std::list<std::string> allfiles;
-
-        for (const auto& it : _models) {
-            allfiles.splice(allfiles.end(), it.second->GetFileReferences());
+        // Walk every element / effect. Each top-level element (with its
+        // strands, nodes and submodels) is checked as one job; the results
+        // are recorded in element order so the report matches a serial walk.
+        auto walkStart = std::chrono::steady_clock::now();
+        _renderCacheMode = _callbacks ? _callbacks->GetRenderCacheMode() : std::string("Enabled");
+        _transTimeDisabled = _callbacks && _callbacks->IsCheckOptionDisabled("TransTime");
+        _effectCheckContext = GetEffectCheckContext();
+
+        EffectCheckCache& cache = GetEffectCheckCache();
+        std::vector<std::string> lastFiles;
+        {
+            std::lock_guard<std::mutex> lock(cache.lock);
+            cache.used.clear();
+            for (const auto& it : cache.entries) {
+                for (const auto& f : it.second->files) {
+                    lastFiles.push_back(f.first);
+                }
+            }
+        }
+        // everything the remembered results depend on, looked up in one go
+        CacheFileStates(lastFiles);
+
+        // `RenderableEffect::GetTiming()` (used by VUMeter, Servo,
+        // Faces, State, etc. inside CheckEffectSettings to validate
+        // timing-track references) walks `mSequenceElements`. The
+        // EffectManager singletons never have it set (no propagation
+        // path on either platform), which made every "Timing Event"
+        // VU Meter etc. report "unknown timing track" even when the
+        // track exists. Set it for the walk and restore so we don't
+        // leave a dangling pointer once this checker goes away.
+        EffectManager& em = _elements.GetEffectManager();
+        std::vector<SequenceElements*> prevSeqElements(em.size(), nullptr);
+        for (size_t i = 0; i < em.size(); ++i) {
+            RenderableEffect* re = em.GetEffect((int)i);
+            if (re != nullptr) {
+                prevSeqElements[i] = re->GetSequenceElements();
+                re->SetSequenceElements(&_elements);
+            }
         }
 
+        std::vector<Element*> elements;
         for (size_t i = 0; i < _elements.GetElementCount(MASTER_VIEW); i++) {
             Element* e = _elements.GetElement(i);
             if (e->GetType() != ElementType::ELEMENT_TYPE_TIMING) {
-                CheckElement(e, report, e->GetFullName(), e->GetName(),
-                             videoCacheWarning, disabledEffects, faces, states,
-                             viewPoints, usesShader, allfiles);
-
-                if (e->GetType() == ElementType::ELEMENT_TYPE_MODEL) {
-                    ModelElement* me = dynamic_cast<ModelElement*>(e);
-                    if (me != nullptr) {
-                        Model* model = _models[me->GetModelName()];
-                        for (int j = 0; j < me->GetStrandCount(); ++j) {
-                            StrandElement* se = me->GetStrand(j);
-                            CheckElement(se, report, se->GetFullName(), e->GetName(),
-                                         videoCacheWarning, disabledEffects, faces, states,
-                                         viewPoints, usesShader, allfiles);
-
-                            for (int k = 0; k < se->GetNodeLayerCount(); ++k) {
-                                NodeLayer* nl = se->GetNodeLayer(k);
-                                for (int l = 0; l < nl->GetEffectCount(); l++) {
-                                    Effect* ef = nl->GetEffect(l);
-                                    std::string nodeName = fmt::format("{} Strand {}/Node {}",
-                                                                        se->GetFullName(), j + 1, l + 1);
-                                    CheckEffect(ef, report, nodeName, e->GetName(),
-                                                k, true, videoCacheWarning, disabledEffects,
-                                                faces, states, viewPoints, allfiles);
-                                    EffectManager& em = _elements.GetEffectManager();
-                                    RenderableEffect* eff = em.GetEffect(ef->GetEffectIndex());
-                                    if (eff != nullptr && model != nullptr) {
-                                        auto refs = eff->GetFileReferences(model, ef->GetSettings());
-                                        allfiles.splice(allfiles.end(), refs);
-                                    }
-                                }
+                elements.push_back(e);
+            }
+        }
+        std::vector<ElementCheckResult> results(elements.size());
+        parallel_for(0, (int)elements.size(), [&](int i) {
+            Element* e = elements[i];
+            ElementCheckResult& result = results[i];
+            CheckElement(e, e->GetFullName(), e->GetName(), result);
+
+            if (e->GetType() == ElementType::ELEMENT_TYPE_MODEL) {
+                ModelElement* me = dynamic_cast<ModelElement*>(e);
+                if (me != nullptr) {
+                    for (int j = 0; j < me->GetStrandCount(); ++j) {
+                        StrandElement* se = me->GetStrand(j);
+                        CheckElement(se, se->GetFullName(), e->GetName(), result);
+
+                        for (int k = 0; k < se->GetNodeLayerCount(); ++k) {
+                            NodeLayer* nl = se->GetNodeLayer(k);
+                            for (int l = 0; l < nl->GetEffectCount(); l++) {
+                                Effect* ef = nl->GetEffect(l);
+                                std::string nodeName = fmt::format("{} Strand {}/Node {}",
+                                                                    se->GetFullName(), j + 1, l + 1);
+                                CheckEffectCached(ef, nodeName, e->GetName(), k, true, result);
                             }
                         }
-                        for (int j = 0; j < me->GetSubModelAndStrandCount(); ++j) {
-                            Element* sme = me->GetSubModel(j);
-                            if (sme != nullptr && sme->GetType() == ElementType::ELEMENT_TYPE_SUBMODEL) {
-                                CheckElement(sme, report, sme->GetFullName(), e->GetName(),
-                                             videoCacheWarning, disabledEffects, faces, states,
-                                             viewPoints, usesShader, allfiles);
-                            }
+                    }
+                    for (int j = 0; j < me->GetSubModelAndStrandCount(); ++j) {
+                        Element* sme = me->GetSubModel(j);
+                        if (sme != nullptr && sme->GetType() == ElementType::ELEMENT_TYPE_SUBMODEL) {
+                            CheckElement(sme, sme->GetFullName(), e->GetName(), result);
                         }
                     }
                 }
             }
+        });
+
+        for (size_t i = 0; i < em.size(); ++i) {
+            RenderableEffect* re = em.GetEffect((int)i);
+            if (re != nullptr) {
+                re->SetSequenceElements(prevSeqElements[i]);
+            }
         }
 
+        bool disabledEffects = false;
+        bool videoCacheWarning = false;
+        std::list<std::pair<std::string, std::string>> faces;
+        std::list<std::pair<std::string, std::string>> states;
+        std::list<std::string> viewPoints;
+        int effects = 0;
+        int reused = 0;
+        for (const auto& result : results) {
+            for (const auto& issue : result.issues) {
+                RecordIssue(report, "sequence", issue);
+            }
+            disabledEffects |= result.disabledEffects;
+            videoCacheWarning |= result.videoCacheWarning;
+            for (const auto& it : result.faces) {
+                AddUnique(faces, it);
+            }
+            for (const auto& it : result.states) {
+                AddUnique(states, it);
+            }
+            for (const auto& it : result.viewPoints) {
+                AddUnique(viewPoints, it);
+            }
+            effects += result.effects;
+            reused += result.reused;
+        }
+
+        // keep only what this run used for the next one
+        {
+            std::lock_guard<std::mutex> lock(cache.lock);
+            cache.entries.swap(cache.used);
+            cache.used.clear();
+        }
+        LogMsg(fmt::format("Checked {} effects on {} elements in {}ms, {} unchanged since the last check.",
+                           effects, elements.size(),
+                           (long long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - walkStart).count(),
+                           reused));
+
         if (videoCacheWarning) {
             RecordIssue(report, "sequence",
                         CheckSequenceReport::ReportIssue(
@@ -1846,13 +2060,30 @@ int SequenceChecker::RunFileReferenceChecks(CheckSequenceReport& report) {
             showdir = sd3;
     }
 
+    // The same file is usually referenced by many effects, resolve and
+    // look up each one once, all together
+    std::vector<std::string> names(allfiles.begin(), allfiles.end());
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    std::vector<std::string> resolved(names.size());
+    parallel_for(0, (int)names.size(), [&](int i) {
+        resolved[i] = FileUtils::FixFile(_showFolder, names[i]);
+    });
+    std::vector<std::string> lookup;
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (StartsWith(resolved[i], _showFolder) && !_elements.GetSequenceMedia().GetMediaEmbedState(resolved[i]).first) {
+            lookup.push_back(resolved[i]);
+        }
+    }
+    CacheFileStates(lookup);
+
     for (const auto& it : allfiles) {
-        std::string ff = FileUtils::FixFile(_showFolder, it);
+        const std::string& ff = resolved[std::lower_bound(names.begin(), names.end(), it) - names.begin()];
         if (_elements.GetSequenceMedia().GetMediaEmbedState(ff).first) {
             continue;
         }
         if (StartsWith(ff, _showFolder)) {
-            if (FileExists(ff)) {
+            if (GetFileState(ff).exists) {
                 std::string rel = ff.substr(_showFolder.size());
                 auto folders = SplitByAny(rel, "\\/");
                 for (const auto& it2 : folders) {
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <list>
+#include <map>
+#include <mutex>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "diagnostics/CheckSequenceReport.h"
 
@@ -60,6 +64,15 @@ public:
 // All inputs are core types (`SequenceElements`, `ModelManager`,
 // `OutputManager`, `SequenceFile`). Construct on every check;
 // the object is single-shot and not thread-safe.
+//
+// `RunSequenceChecks` checks each top-level element (with its
+// strands, nodes and submodels) as a job on the parallel pool and
+// merges the results in element order, so the report reads exactly
+// as a serial walk would. Per-effect results are remembered for the
+// next check (process wide) keyed on the effect's settings and
+// everything the check reads, plus the size / time of every file
+// it depends on, so re-checking a large sequence only re-checks
+// the effects that changed.
 class SequenceChecker {
 public:
     SequenceChecker(SequenceElements& elements,
@@ -87,33 +100,63 @@ public:
     int RunFileReferenceChecks(CheckSequenceReport& report);
 
 private:
+    // Existence, size and modification time of a file. Compared to
+    // decide whether a remembered effect check is still valid.
+    struct FileState {
+        bool exists = false;
+        uintmax_t size = 0;
+        int64_t modified = 0;
+
+        bool operator==(const FileState& other) const = default;
+    };
+
+    // What checking one effect / one top-level element found. Issues
+    // are kept in the order they were found and only recorded into
+    // the report (in element order) once the parallel walk is done.
+    struct EffectCheckResult;
+    struct ElementCheckResult;
+    struct EffectCheckCache;
+    static EffectCheckCache& GetEffectCheckCache();
+
     // Per-effect / per-element body. Mirrors the desktop
     // `CheckEffect` / `CheckElement` shape; faces / states / view
-    // points / file lists are accumulated across the whole sequence
-    // walk and consumed in `RunSequenceChecks` to emit summary
-    // issues (missing face image, undefined state, unused view).
-    void CheckEffect(Effect* ef, CheckSequenceReport& report,
+    // points are accumulated across the whole sequence walk and
+    // consumed in `RunSequenceChecks` to emit summary issues. Safe
+    // to run for different elements at the same time.
+    void CheckEffect(Effect* ef,
                      const std::string& elementName,
                      const std::string& modelName,
                      int layerIndex,
                      bool node,
-                     bool& videoCacheWarning,
-                     bool& disabledEffects,
-                     std::list<std::pair<std::string, std::string>>& faces,
-                     std::list<std::pair<std::string, std::string>>& states,
-                     std::list<std::string>& viewPoints,
-                     std::list<std::string>& allFiles);
-
-    void CheckElement(Element* e, CheckSequenceReport& report,
+                     EffectCheckResult& result);
+
+    // `CheckEffect`, reusing the last check's result for the effect
+    // if neither it nor anything the check reads has changed.
+    void CheckEffectCached(Effect* ef,
+                           const std::string& elementName,
+                           const std::string& modelName,
+                           int layerIndex,
+                           bool node,
+                           ElementCheckResult& result);
+    // Folds one effect's check into its element's result.
+    void AddEffectCheckResult(const EffectCheckResult& checked,
+                              const std::string& modelName,
+                              ElementCheckResult& result);
+
+    void CheckElement(Element* e,
                       const std::string& name,
                       const std::string& modelName,
-                      bool& videoCacheWarning,
-                      bool& disabledEffects,
-                      std::list<std::pair<std::string, std::string>>& faces,
-                      std::list<std::pair<std::string, std::string>>& states,
-                      std::list<std::string>& viewPoints,
-                      bool& usesShader,
-                      std::list<std::string>& allFiles);
+                      ElementCheckResult& result);
+
+    // Everything outside the effect itself that an effect check
+    // reads, folded into the key of every remembered result.
+    std::string GetEffectCheckContext();
+
+    // File lookups shared by every check in this run. `CacheFileStates`
+    // looks up a batch of files in parallel, `GetFileState` answers
+    // from the batch and looks up (and keeps) anything not in it.
+    FileState GetFileState(const std::string& path);
+    void CacheFileStates(const std::vector<std::string>& paths);
 
     // Recursive start-channel chain check for "model after model"
     // references. Returns true if the chain terminates normally;
@@ -141,4 +184,13 @@ private:
     // running totals between sections.
     int _errors = 0;
     int _warnings = 0;
+
+    // Read once before the parallel walk so the callbacks are only
+    // ever called from the thread running the check
+    std::string _renderCacheMode = "Enabled";
+    bool _transTimeDisabled = false;
+    std::string _effectCheckContext;
+
+    std::mutex _fileStatesLock;
+    std::map<std::string, FileState> _fileStates;
 };
@@ -26,6 +26,9 @@ class DuplicateEffect : public RenderableEffect
             return true;
         }
         virtual std::list<std::string> CheckEffectSettings(const SettingsMap& settings, AudioManager* media, Model* model, Effect* eff, bool renderCache) override;
+        virtual bool CheckEffectSettingsIsSelfContained() const override {
+            return false;
+        }
         static int GetLayersForModel(const SequenceElements& sequenceElements, const std::string& model);
 
     protected:
@@ -26,8 +26,14 @@ public:
         return false;
     }
     virtual void Render(Effect* effect, const SettingsMap& settings, RenderBuffer& buffer) override;
+    virtual bool RenderCacheDependsOnModel(const SettingsMap& settings) const override {
+        return true;
+    }
     virtual void RenameTimingTrack(std::string oldname, std::string newname, Effect* effect) override;
     virtual std::list<std::string> CheckEffectSettings(const SettingsMap& settings, AudioManager* media, Model* model, Effect* eff, bool renderCache) override;
+    virtual bool CheckEffectSettingsIsSelfContained() const override {
+        return false;
+    }
     virtual bool AppropriateOnNodes() const override
     {
         return false;
@@ -27,6 +27,10 @@
 #include "../../include/fire-48.xpm"
 #include "../../include/fire-64.xpm"
 
+#include "ispc/FireFunctions.ispc.h"
+
+#include <algorithm>
+
 // Fallback defaults (used until OnMetadataLoaded replaces them with Fire.json values).
 int FireEffect::sHeightDefault = 50;
 int FireEffect::sHeightMin = 1;
@@ -122,25 +126,6 @@ private:
 };
 static const FirePaletteClass FirePalette;
 
-// 0 <= x < BufferWi
-// 0 <= y < BufferHt
-void SetFireBuffer(int x, int y, int PaletteIdx, std::vector<int>& FireBuffer, int maxWi, int maxHi)
-{
-    if (x >= 0 && x < maxWi && y >= 0 && y < maxHi) {
-        FireBuffer[y * maxWi + x] = PaletteIdx;
-    }
-}
-
-// 0 <= x < BufferWi
-// 0 <= y < BufferHt
-int GetFireBuffer(int x, int y, const std::vector<int>& FireBuffer, int maxWi, int maxHi)
-{
-    if (x >= 0 && x < maxWi && y >= 0 && y < maxHi) {
-        return FireBuffer[y * maxWi + x];
-    }
-    return -1;
-}
-
 static int GetLocation(const std::string &location) {
     if (location == "Bottom") {
         return 0;
@@ -174,40 +159,57 @@ static FireRenderCache* GetCache(RenderBuffer &buffer, int id) {
     return cache;
 }
 
-// Advance/draw split of the fire grid render: Render rebuilds the grid, DrawFire
-// rasterises it.  (Kept separate for clarity; frame-parallel does not engage -
-// see FireEffect.h - because the advance dominates Fire's cost.)
-static void DrawFire(RenderBuffer& buffer, const std::vector<int>& fireBuffer, int maxMWi, int maxMHt, int curWi, int curHt, int loc, int HueShift) {
-    for (int y = 0; y < curHt; ++y) {
-        for (int x = 0; x < curWi; ++x) {
-            int xp = x;
-            int yp = y;
-            if (loc == 1 || loc == 3) {
-                yp = curHt - y - 1;
-            }
-            if (loc == 2 || loc == 3) {
-                std::swap(xp, yp);
-            }
-            if (HueShift > 0) {
-                HSVValue hsv = FirePalette[GetFireBuffer(x, y, fireBuffer, maxMWi, maxMHt)];
-                hsv.hue = hsv.hue + (HueShift / 100.0);
-                if (hsv.hue > 1.0)
-                    hsv.hue = 1.0;
-                if (buffer.allowAlpha) {
-                    xlColor c(hsv);
-                    c.alpha = FirePalette.asAlphaColor(GetFireBuffer(x, y, fireBuffer, maxMWi, maxMHt)).Alpha();
-                    buffer.SetPixel(xp, yp, c);
-                } else {
-                    buffer.SetPixel(xp, yp, hsv);
-                }
-            } else {
-                if (buffer.allowAlpha) {
-                    buffer.SetPixel(xp, yp, FirePalette.asAlphaColor(GetFireBuffer(x, y, fireBuffer, maxMWi, maxMHt)));
-                } else {
-                    buffer.SetPixel(xp, yp, FirePalette.asColor(GetFireBuffer(x, y, fireBuffer, maxMWi, maxMHt)));
-                }
+// The color each heat value draws as this frame, hue shift and alpha applied
+static void BuildFireLut(const RenderBuffer& buffer, int HueShift, xlColorVector& lut) {
+    lut.resize(FirePalette.size());
+    for (int i = 0; i < FirePalette.size(); ++i) {
+        if (HueShift > 0) {
+            HSVValue hsv = FirePalette[i];
+            hsv.hue = hsv.hue + (HueShift / 100.0);
+            if (hsv.hue > 1.0)
+                hsv.hue = 1.0;
+            lut[i] = xlColor(hsv);
+            if (buffer.allowAlpha) {
+                lut[i].alpha = FirePalette.asAlphaColor(i).Alpha();
             }
+        } else {
+            lut[i] = buffer.allowAlpha ? FirePalette.asAlphaColor(i) : FirePalette.asColor(i);
+        }
+    }
+}
+
+// Rasterise the heat grid.  Fire stays Stateful (see FireEffect.h) so this runs
+// serially, straight after the advance, on the cached grid.
+static void DrawFire(RenderBuffer& buffer, const std::vector<int>& fireBuffer, int maxMWi, int maxMHt, int curHt, int loc, int HueShift) {
+    xlColorVector lut;
+    BuildFireLut(buffer, HueShift, lut);
+
+    if (buffer.dmx_buffer) {
+        // DMX models only take the first pixel's color and SetPixel knows how to hand it over
+        int y = (loc == 1 || loc == 3) ? curHt - 1 : 0;
+        if (y < maxMHt) {
+            buffer.SetPixel(0, 0, lut[fireBuffer[y * maxMWi]]);
         }
+        return;
+    }
+
+    ispc::FireData fdata;
+    fdata.width = buffer.BufferWi;
+    fdata.height = buffer.BufferHt;
+    fdata.gridWidth = maxMWi;
+    fdata.gridHeight = maxMHt;
+    fdata.curHt = curHt;
+    fdata.location = loc;
+    fdata.lutSize = (int)lut.size();
+
+    // Bound the ISPC writes by the actual pixel allocation, not the logical
+    // dimensions (variable sub-buffers can leave GetPixelCount() smaller
+    // than BufferWi*BufferHt) — the kernel has no bounds check.
+    int max = std::min<int>(buffer.GetPixelCount(), buffer.BufferWi * buffer.BufferHt);
+    if (max > 0) {
+        ispc::FireEffectISPC(&fdata, 0, max, fireBuffer.data(),
+                             reinterpret_cast<const ispc::uint8_t4*>(lut.data()),
+                             (ispc::uint8_t4*)buffer.GetPixels());
     }
 }
 
@@ -281,36 +283,33 @@ void FireEffect::Render(Effect* effect, const SettingsMap& SettingsMap, RenderBu
     }
     
     // build fire
+    std::vector<int>& fire = cache->FireBuffer;
     for (int x = 0; x < maxMWi; ++x) {
         int r = 150 + buffer.randInt(0, 49);
-        SetFireBuffer(x, 0, r, cache->FireBuffer, maxMWi, maxMHt);
+        fire[x] = r;
     }
     int step = std::max(1, 255 * 100 / curHt / HeightPct);
     for (int y = 1; y < maxMHt; ++y) {
+        // the cells this one averages are all in rows already computed so only the edges need bounds checks
+        const int* below = &fire[(y - 1) * maxMWi];
+        const int* below2 = y >= 2 ? &fire[(y - 2) * maxMWi] : nullptr;
+        int* row = &fire[y * maxMWi];
         for (int x = 0; x < maxMWi; ++x) {
-            int v1 = GetFireBuffer(x - 1, y - 1, cache->FireBuffer, maxMWi, maxMHt);
-            int v2 = GetFireBuffer(x, y - 1, cache->FireBuffer, maxMWi, maxMHt);
-            int v3 = GetFireBuffer(x + 1, y - 1, cache->FireBuffer, maxMWi, maxMHt);
-            int v4 = GetFireBuffer(x, y - 2, cache->FireBuffer, maxMWi, maxMHt);
-            int n = 0;
-            int sum = 0;
-            if (v1 >= 0) {
-                sum += v1;
-                n++;
-            }
-            if (v2 >= 0) {
-                sum += v2;
+            int sum = below[x];
+            int n = 1;
+            if (x > 0) {
+                sum += below[x - 1];
                 n++;
             }
-            if (v3 >= 0) {
-                sum += v3;
+            if (x + 1 < maxMWi) {
+                sum += below[x + 1];
                 n++;
             }
-            if (v4 >= 0) {
-                sum += v4;
+            if (below2 != nullptr) {
+                sum += below2[x];
                 n++;
             }
-            int new_index = n > 0 ? sum / n : 0;
+            int new_index = sum / n;
             if (new_index > 0) {
                 new_index += (buffer.randInt(0, 99) < 20) ? step : -step;
                 if (new_index < 0)
@@ -318,10 +317,10 @@ void FireEffect::Render(Effect* effect, const SettingsMap& SettingsMap, RenderBu
                 if (new_index >= FirePalette.size())
                     new_index = FirePalette.size() - 1;
             }
-            SetFireBuffer(x, y, new_index, cache->FireBuffer, maxMWi, maxMHt);
+            row[x] = new_index;
         }
     }
 
     //  Now play fire
-    DrawFire(buffer, cache->FireBuffer, maxMWi, maxMHt, curWi, curHt, loc, HueShift);
+    DrawFire(buffer, fire, maxMWi, maxMHt, curHt, loc, HueShift);
 }
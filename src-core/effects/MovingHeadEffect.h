@@ -40,6 +40,9 @@ public:
         return false;
     }
     virtual void Render(Effect* effect, const SettingsMap& settings, RenderBuffer& buffer) override;
+    virtual bool RenderCacheDependsOnModel(const SettingsMap& settings) const override {
+        return true;
+    }
     virtual FrameParallelism GetFrameParallelism(const SettingsMap& settings) const override { return FrameParallelism::Pure; }
     virtual void RenameTimingTrack(std::string oldname, std::string newname, Effect* effect) override;
     virtual bool CanRenderPartialTimeInterval() const override
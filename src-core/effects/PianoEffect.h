@@ -33,6 +33,9 @@ public:
         return 5;
     }
     virtual std::list<std::string> CheckEffectSettings(const SettingsMap& settings, AudioManager* media, Model* model, Effect* eff, bool renderCache) override;
+    virtual bool CheckEffectSettingsIsSelfContained() const override {
+        return false;
+    }
     virtual bool AppropriateOnNodes() const override
     {
         return false;
@@ -308,6 +308,26 @@ bool RenderableEffect::SupportsRenderCache(const SettingsMap& settings) const
     return false;
 }
 
+bool RenderableEffect::RenderCacheDependsOnTime(const SettingsMap& settings) const
+{
+    for (const auto& it : settings) {
+        // timing and lyric track selections
+        if ((Contains(it.first, "TimingTrack") || Contains(it.first, "LyricTrack")) && !it.second.empty()) {
+            return true;
+        }
+        // music / audio reactive options
+        if ((Contains(it.first, "UseMusic") || Contains(it.first, "WithAudio")) && it.second == "1") {
+            return true;
+        }
+        // value curves driven by the audio or a timing track
+        if (Contains(it.first, "VALUECURVE_") && Contains(it.second, "Active=TRUE") &&
+            (Contains(it.second, "Type=Music") || Contains(it.second, "Type=Inverted Music") || Contains(it.second, "Type=Timing Track"))) {
+            return true;
+        }
+    }
+    return false;
+}
+
 RenderableEffect::FrameParallelism RenderableEffect::GetEffectiveFrameParallelism(const SettingsMap& settings) const
 {
     FrameParallelism fp = GetFrameParallelism(settings);
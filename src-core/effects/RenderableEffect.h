@@ -112,6 +112,16 @@ public:
 
     // Methods for rendering the effect
     virtual bool SupportsRenderCache(const SettingsMap& settings) const;
+    // True if the rendered frames depend on where the effect sits in the sequence (audio,
+    // timing tracks, absolute frame numbers). The render cache only shares such renders
+    // between effects with the same start time.
+    virtual bool RenderCacheDependsOnTime(const SettingsMap& settings) const;
+    // True if the rendered frames depend on the model the effect is on (its faces, states or
+    // channel layout) rather than only the buffer size. The render cache only shares such
+    // renders between effects on the same model.
+    virtual bool RenderCacheDependsOnModel(const SettingsMap& settings) const {
+        return false;
+    }
 
     // Frame-parallelism capability. Describes whether this effect's output at
     // frame N is a pure function of N and its settings, or depends on state
@@ -166,6 +176,11 @@ public:
     virtual void Render(Effect* effect, const SettingsMap& settings, RenderBuffer& buffer) = 0;
     virtual void RenameTimingTrack(std::string oldname, std::string newname, Effect* effect) {}
     virtual std::list<std::string> CheckEffectSettings(const SettingsMap& settings, AudioManager* media, Model* model, Effect* eff, bool renderCache);
+    // False if CheckEffectSettings looks at other elements or timing tracks in the
+    // sequence, so the sequence checker can't reuse an earlier result for the effect.
+    virtual bool CheckEffectSettingsIsSelfContained() const {
+        return true;
+    }
 
     virtual bool CanBeRandom() {
         return true;
@@ -24,12 +24,18 @@ public:
         return false;
     }
     virtual void Render(Effect* effect, const SettingsMap& settings, RenderBuffer& buffer) override;
+    virtual bool RenderCacheDependsOnModel(const SettingsMap& settings) const override {
+        return true;
+    }
     virtual FrameParallelism GetFrameParallelism(const SettingsMap& settings) const override { return FrameParallelism::Pure; }
     virtual void RenameTimingTrack(std::string oldname, std::string newname, Effect* effect) override;
     virtual bool CanRenderPartialTimeInterval() const override {
         return true;
     }
     virtual std::list<std::string> CheckEffectSettings(const SettingsMap& settings, AudioManager* media, Model* model, Effect* eff, bool renderCache) override;
+    virtual bool CheckEffectSettingsIsSelfContained() const override {
+        return false;
+    }
 
     virtual double GetSettingVCMin(const std::string& name) const override {
         if (name == "E_VALUECURVE_Servo")
@@ -23,10 +23,16 @@ class StateEffect : public RenderableEffect
         virtual ~StateEffect();
         virtual bool CanBeRandom() override {return false;}
         virtual void Render(Effect *effect, const SettingsMap &settings, RenderBuffer &buffer) override;
+        virtual bool RenderCacheDependsOnModel(const SettingsMap& settings) const override {
+            return true;
+        }
         virtual FrameParallelism GetFrameParallelism(const SettingsMap& settings) const override { return FrameParallelism::Pure; }
         std::list<std::string> GetStates(Model* cls, std::string model);
         virtual void RenameTimingTrack(std::string oldname, std::string newname, Effect* effect) override;
         virtual std::list<std::string> CheckEffectSettings(const SettingsMap& settings, AudioManager* media, Model* model, Effect* eff, bool renderCache) override;
+        virtual bool CheckEffectSettingsIsSelfContained() const override {
+            return false;
+        }
         virtual bool CanRenderPartialTimeInterval() const override { return true; }
         std::list<std::string> GetStatesUsed(const SettingsMap& SettingsMap);
 
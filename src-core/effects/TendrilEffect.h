@@ -78,6 +78,11 @@ public:
     {
         return true;
     }
+    // movement is stepped on absolute frame numbers
+    virtual bool RenderCacheDependsOnTime(const SettingsMap& settings) const override
+    {
+        return true;
+    }
 
     // Cached from Tendril.json by OnMetadataLoaded().
     static std::string sMovementDefault;
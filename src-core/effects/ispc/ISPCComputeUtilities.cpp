@@ -246,12 +246,34 @@ bool ISPCComputeUtilities::blendLayers(PixelBufferClass *pixelBuffer, int effect
     
     xlColor *colors = (xlColor*)(&pixelBuffer->blendDataBuffer[0]);
     int nc = pixelBuffer->layers[saveLayer]->buffer.GetNodeCount();
-    for (int x = 0; x < nc; x++) {
-        pixelBuffer->layers[saveLayer]->buffer.Nodes[x]->SetColor(colors[x]);
-    }
+    pixelBuffer->layers[saveLayer]->buffer.SetNodeColors(colors, nc);
     return true;
 }
 
+void ISPCComputeUtilities::scatterNodeColors(const RenderBuffer& buffer, unsigned char* fdata, unsigned int numChannels) {
+    // short runs cost more to dispatch than to just copy
+    constexpr uint32_t minKernelRun = 8;
+    const uint32_t* colors = (const uint32_t*)buffer.nodeColors.data();
+    for (const auto& r : buffer.scatterRuns) {
+        if (r.count >= minKernelRun && (size_t)r.destChannel + (size_t)r.count * 3 <= numChannels) {
+            ispc::ScatterNodeColors(&colors[r.firstNode], &fdata[r.destChannel], r.count, r.offsets[0], r.offsets[1], r.offsets[2]);
+            continue;
+        }
+        for (uint32_t n = 0; n < r.count; ++n) {
+            // same bounds rule as the per node path, the node's first channel must be in the frame
+            size_t start = (size_t)r.destChannel + n * 3;
+            if (start >= numChannels) {
+                break;
+            }
+            const xlColor& c = buffer.nodeColors[r.firstNode + n];
+            unsigned char* out = &fdata[start];
+            if (r.offsets[0] != 255) out[r.offsets[0]] = c.red;
+            if (r.offsets[1] != 255) out[r.offsets[1]] = c.green;
+            if (r.offsets[2] != 255) out[r.offsets[2]] = c.blue;
+        }
+    }
+}
+
 void ISPCComputeUtilities::blendLayers(PixelBufferClass *pixelBuffer, int effectPeriod, const std::vector<bool>& validLayers, int saveLayer, int start, int end) {
     uint32_t * tmpBufferBlend = (uint32_t *)&pixelBuffer->blendDataBuffer[0];
     for (int l = validLayers.size() - 1; l >= 0; --l) {
@@ -20,6 +20,8 @@ public:
     ~ISPCComputeUtilities();
     
     bool blendLayers(PixelBufferClass *pixelBuffer, int effectPeriod, const std::vector<bool>& validLayers, int saveLayer, bool saveToPixels);
+    // write the buffer's current node colours to the output frame using its scatter plan
+    void scatterNodeColors(const RenderBuffer& buffer, unsigned char* fdata, unsigned int numChannels);
 
     
     static ISPCComputeUtilities INSTANCE;
@@ -210,6 +210,11 @@ extern "C" {
 #else
     extern void Reveal21Function(const struct LayerBlendingData *data, uint32_t * result, const uint32_t * src, const uint32_t * indexes);
 #endif // Reveal21Function function declaraion
+#if defined(__cplusplus)
+    extern void ScatterNodeColors(const uint32_t * colors, uint8_t * dest, uint32_t count, uint8_t redOffset, uint8_t greenOffset, uint8_t blueOffset);
+#else
+    extern void ScatterNodeColors(const uint32_t * colors, uint8_t * dest, uint32_t count, uint8_t redOffset, uint8_t greenOffset, uint8_t blueOffset);
+#endif // ScatterNodeColors function declaraion
 #if defined(__cplusplus)
     extern void Shadow_1on2Function(const struct LayerBlendingData &data, uint32_t * result, const uint32_t * src, const uint32_t * indexes);
 #else
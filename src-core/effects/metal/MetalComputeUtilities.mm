@@ -382,14 +382,11 @@ bool MetalPixelBufferComputeData::doBlendLayers(PixelBufferClass *pixelBuffer, i
 
     xlColor *colors = (xlColor*)(tmpBufferBlend.contents);
     int nc = pixelBuffer->layers[saveLayer]->buffer.GetNodeCount();
-    auto &nodes = pixelBuffer->layers[saveLayer]->buffer.Nodes;
     // Deliberately serial.  SetColor is a few byte writes, so a parallel_for
     // here costs more in pool dispatch (job alloc, queue lock, CV wait) than
     // the copy itself - measured 2-7% slower across sequences on the GPU path,
     // where this runs for every model of every frame.
-    for (int x = 0; x < nc; ++x) {
-        nodes[x]->SetColor(colors[x]);
-    }
+    pixelBuffer->layers[saveLayer]->buffer.SetNodeColors(colors, nc);
     return true;
 }
 
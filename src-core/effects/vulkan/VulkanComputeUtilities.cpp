@@ -1312,12 +1312,9 @@ bool VulkanPixelBufferComputeData::doBlendLayers(PixelBufferClass* pixelBuffer,
 
     xlColor* colors = (xlColor*)(tmpBufferBlend.mapped);
     int nc = pixelBuffer->layers[saveLayer]->buffer.GetNodeCount();
-    auto& nodes = pixelBuffer->layers[saveLayer]->buffer.Nodes;
     // Deliberately serial - see the Metal path: SetColor is a few byte writes,
     // so a parallel_for costs more in pool dispatch than the copy itself.
-    for (int x = 0; x < nc; ++x) {
-        nodes[x]->SetColor(colors[x]);
-    }
+    pixelBuffer->layers[saveLayer]->buffer.SetNodeColors(colors, nc);
     return true;
 }
 
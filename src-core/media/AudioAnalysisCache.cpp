@@ -0,0 +1,279 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "AudioAnalysisCache.h"
+#include "AudioManager.h"
+#include "../../dependencies/md5/md5.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <log.h>
+
+namespace fs = std::filesystem;
+
+static constexpr uint32_t AUDIO_ANALYSIS_CACHE_VERSION = 1;
+static constexpr char AUDIO_ANALYSIS_CACHE_MAGIC[4] = { 'X', 'L', 'A', 'C' };
+static constexpr char AUDIO_ANALYSIS_CACHE_EXT[] = ".xac";
+// A set of stems for a five minute song is around 400MB so this holds the
+// analysis of a handful of songs. Entries are evicted least recently used
+// first, and any not used for MAX_AGE are dropped regardless.
+static constexpr uint64_t AUDIO_ANALYSIS_CACHE_MAX_SIZE = 4ull * 1024 * 1024 * 1024;
+static constexpr auto AUDIO_ANALYSIS_CACHE_MAX_AGE = std::chrono::hours(24 * 60);
+
+static std::mutex __cacheFolderLock;
+static std::string __cacheFolder;
+static std::mutex __cacheTrimLock;
+
+namespace {
+
+// A read only view of a whole file. Mapped where we can so a large entry such
+// as a set of stems is only copied once, into the structure that uses it.
+class CacheFileView {
+public:
+    explicit CacheFileView(const std::string& filename) {
+#ifndef _WIN32
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (p != MAP_FAILED) {
+                _mapped = static_cast<uint8_t*>(p);
+                _data = _mapped;
+                _size = st.st_size;
+                // entries are always read front to back in full
+                madvise(p, _size, MADV_SEQUENTIAL);
+            }
+        }
+        close(fd);
+#else
+        std::ifstream in(filename, std::ios::binary | std::ios::ate);
+        if (!in.is_open()) {
+            return;
+        }
+        _buffer.resize((size_t)in.tellg());
+        in.seekg(0);
+        if (in.read(reinterpret_cast<char*>(_buffer.data()), _buffer.size())) {
+            _data = _buffer.data();
+            _size = _buffer.size();
+        }
+#endif
+    }
+    ~CacheFileView() {
+#ifndef _WIN32
+        if (_mapped != nullptr) {
+            munmap(_mapped, _size);
+        }
+#endif
+    }
+    CacheFileView(const CacheFileView&) = delete;
+    CacheFileView& operator=(const CacheFileView&) = delete;
+
+    const uint8_t* Data() const { return _data; }
+    uint64_t Size() const { return _size; }
+
+private:
+    const uint8_t* _data = nullptr;
+    uint64_t _size = 0;
+#ifndef _WIN32
+    uint8_t* _mapped = nullptr;
+#else
+    std::vector<uint8_t> _buffer;
+#endif
+};
+
+} // namespace
+
+static std::string GetCacheFolder() {
+    std::lock_guard<std::mutex> lock(__cacheFolderLock);
+    return __cacheFolder;
+}
+
+// The full key is stored in the entry and checked on load, the file name only
+// needs to be unique enough to find it.
+static std::string GetCacheKey(AudioManager* audio, const std::string& type, const std::string& params) {
+    return audio->Hash() + "|" + std::to_string(audio->GetRate()) + "|" + type + "|" + params;
+}
+
+static std::string GetCacheFile(const std::string& folder, AudioManager* audio, const std::string& type, const std::string& params) {
+    MD5 md5;
+    std::string key = std::to_string(audio->GetRate()) + "|" + params;
+    md5.update(key.c_str(), (MD5::size_type)key.size());
+    md5.finalize();
+    return (fs::path(folder) / (audio->Hash() + "_" + type + "_" + md5.hexdigest().substr(0, 12) + AUDIO_ANALYSIS_CACHE_EXT)).string();
+}
+
+// An entry's modification time is when it was last used, Load touches it.
+// Removes entries past the age limit then the least recently used until the
+// folder is under the size limit, keeping `keep` which has just been written.
+static void TrimCache(const std::string& folder, const std::string& keep) {
+    std::unique_lock<std::mutex> lock(__cacheTrimLock, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        // another store is already trimming
+        return;
+    }
+
+    struct Entry {
+        fs::path path;
+        fs::file_time_type used;
+        uint64_t size;
+    };
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+    std::error_code ec;
+    for (fs::directory_iterator it(folder, ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code tec, sec;
+        if (it->path().extension() != AUDIO_ANALYSIS_CACHE_EXT || !it->is_regular_file(tec) || it->path() == fs::path(keep)) {
+            continue;
+        }
+        Entry e { it->path(), it->last_write_time(tec), it->file_size(sec) };
+        if (tec || sec) {
+            continue;
+        }
+        entries.push_back(e);
+        total += e.size;
+    }
+    std::error_code kec;
+    uint64_t keepSize = fs::file_size(keep, kec);
+    if (!kec) {
+        total += keepSize;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.used < b.used; });
+    const auto oldest = fs::file_time_type::clock::now() - AUDIO_ANALYSIS_CACHE_MAX_AGE;
+    for (const auto& e : entries) {
+        if (e.used >= oldest && total <= AUDIO_ANALYSIS_CACHE_MAX_SIZE) {
+            break;
+        }
+        if (fs::remove(e.path, ec)) {
+            total -= e.size;
+            spdlog::debug("AudioAnalysisCache: Evicted {}.", e.path.string());
+        }
+    }
+}
+
+void AudioAnalysisCache::SetFolder(const std::string& folder) {
+    std::lock_guard<std::mutex> lock(__cacheFolderLock);
+    if (folder.empty()) {
+        __cacheFolder.clear();
+    } else {
+        __cacheFolder = (fs::path(folder) / "AudioCache").string();
+    }
+}
+
+bool AudioAnalysisCache::IsEnabled() {
+    return !GetCacheFolder().empty();
+}
+
+bool AudioAnalysisCache::Load(AudioManager* audio, const std::string& type, const std::string& params,
+                              const std::function<bool(Reader&)>& read) {
+    std::string folder = GetCacheFolder();
+    if (folder.empty() || audio == nullptr || !audio->IsOk()) {
+        return false;
+    }
+    std::string filename = GetCacheFile(folder, audio, type, params);
+    std::error_code ec;
+    if (!fs::exists(filename, ec)) {
+        return false;
+    }
+
+    CacheFileView view(filename);
+    if (view.Data() == nullptr || view.Size() < sizeof(AUDIO_ANALYSIS_CACHE_MAGIC)
+        || memcmp(view.Data(), AUDIO_ANALYSIS_CACHE_MAGIC, sizeof(AUDIO_ANALYSIS_CACHE_MAGIC)) != 0) {
+        spdlog::warn("AudioAnalysisCache: {} is not a cache entry, ignoring it.", filename);
+        return false;
+    }
+    Reader header(view.Data() + sizeof(AUDIO_ANALYSIS_CACHE_MAGIC), view.Size() - sizeof(AUDIO_ANALYSIS_CACHE_MAGIC));
+    uint32_t version = 0;
+    std::string key;
+    header.Get(version);
+    header.GetString(key);
+    if (!header.IsOk() || version != AUDIO_ANALYSIS_CACHE_VERSION || key != GetCacheKey(audio, type, params)) {
+        spdlog::debug("AudioAnalysisCache: {} is stale, ignoring it.", filename);
+        return false;
+    }
+
+    // the payload is the rest of the file
+    Reader payload(view.Data() + (view.Size() - header.Remaining()), header.Remaining());
+    if (!read(payload) || !payload.IsOk() || payload.Remaining() != 0) {
+        spdlog::warn("AudioAnalysisCache: Could not read {}, ignoring it.", filename);
+        return false;
+    }
+    fs::last_write_time(filename, fs::file_time_type::clock::now(), ec);
+    spdlog::debug("AudioAnalysisCache: Loaded {} for {} from {}.", type, audio->FileName(), filename);
+    return true;
+}
+
+void AudioAnalysisCache::Store(AudioManager* audio, const std::string& type, const std::string& params,
+                               const std::function<void(Writer&)>& write) {
+    std::string folder = GetCacheFolder();
+    if (folder.empty() || audio == nullptr || !audio->IsOk()) {
+        return;
+    }
+    std::error_code ec;
+    if (!fs::exists(folder, ec)) {
+        fs::create_directories(folder, ec);
+        if (ec) {
+            spdlog::warn("AudioAnalysisCache: Could not create cache folder {}: {}", folder, ec.message());
+            return;
+        }
+    }
+
+    // written aside and renamed so a reader never sees a partial entry
+    std::string filename = GetCacheFile(folder, audio, type, params);
+    std::string tempName = filename + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+    {
+        std::ofstream out(tempName, std::ios::binary | std::ios::trunc);
+        out.write(AUDIO_ANALYSIS_CACHE_MAGIC, sizeof(AUDIO_ANALYSIS_CACHE_MAGIC));
+        Writer writer(out);
+        writer.Add(AUDIO_ANALYSIS_CACHE_VERSION);
+        writer.AddString(GetCacheKey(audio, type, params));
+        write(writer);
+        out.flush();
+        if (!out.good()) {
+            out.close();
+            spdlog::warn("AudioAnalysisCache: Could not write {}.", tempName);
+            fs::remove(tempName, ec);
+            return;
+        }
+    }
+    fs::rename(tempName, filename, ec);
+    if (ec) {
+        spdlog::warn("AudioAnalysisCache: Could not replace {}: {}", filename, ec.message());
+        fs::remove(tempName, ec);
+        return;
+    }
+    spdlog::debug("AudioAnalysisCache: Saved {} for {} to {}.", type, audio->FileName(), filename);
+    TrimCache(folder, filename);
+}
+
+void AudioAnalysisCache::Purge() {
+    std::string folder = GetCacheFolder();
+    if (folder.empty()) {
+        return;
+    }
+    std::error_code ec;
+    fs::remove_all(folder, ec);
+    spdlog::debug("AudioAnalysisCache: Purged {}.", folder);
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+// On-disk cache for the results of audio analysis (frame data, filtered
+// waveforms, onset envelopes, tempo, chords, stems) so reopening a sequence
+// does not redo minutes of work.
+//
+// Entries are keyed by the content hash of the decoded audio
+// (`AudioManager::Hash`), its sample rate, the kind of analysis and a string
+// describing the parameters it was run with. Each entry is a single file in
+// the `AudioCache` folder under the render cache directory (the show folder
+// unless the user moved it), mapped into memory when it is read. Bump
+// `AUDIO_ANALYSIS_CACHE_VERSION` whenever an analysis changes what it
+// produces so stale entries are ignored. The folder is kept under a size
+// limit by evicting the least recently used entries each time one is
+// stored, and entries not used for a couple of months are dropped.
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+class AudioManager;
+
+class AudioAnalysisCache {
+public:
+    // Serialises an entry straight to its file. Only trivially copyable values
+    // are written, in the machine's own byte order - the cache is never shared
+    // between machines.
+    class Writer {
+    public:
+        explicit Writer(std::ostream& out) :
+            _out(out) {}
+
+        template<typename T>
+        void Add(const T& v) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            AddBytes(&v, sizeof(T));
+        }
+        template<typename T>
+        void AddArray(const T* v, uint64_t count) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            Add(count);
+            AddBytes(v, count * sizeof(T));
+        }
+        template<typename T>
+        void AddVector(const std::vector<T>& v) {
+            AddArray(v.data(), v.size());
+        }
+        void AddString(const std::string& s) {
+            AddArray(s.data(), s.size());
+        }
+
+    private:
+        void AddBytes(const void* p, uint64_t len) {
+            _out.write(static_cast<const char*>(p), len);
+        }
+        std::ostream& _out;
+    };
+
+    // Reads an entry back in the order it was written. Every read is bounds
+    // checked, once one fails all further reads fail so callers can check
+    // IsOk() at the end.
+    class Reader {
+    public:
+        Reader(const uint8_t* data, uint64_t len) :
+            _data(data), _len(len) {}
+
+        template<typename T>
+        bool Get(T& v) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            return GetBytes(&v, sizeof(T));
+        }
+        // reads an array written by AddArray/AddVector into dst which must hold count elements
+        template<typename T>
+        bool GetArray(T* dst, uint64_t count) {
+            uint64_t stored = 0;
+            if (!Get(stored) || stored != count) {
+                return Fail();
+            }
+            return GetBytes(dst, count * sizeof(T));
+        }
+        template<typename T>
+        bool GetVector(std::vector<T>& v) {
+            uint64_t count = 0;
+            if (!Get(count) || count > Remaining() / sizeof(T)) {
+                return Fail();
+            }
+            v.resize(count);
+            return GetBytes(v.data(), count * sizeof(T));
+        }
+        bool GetString(std::string& s) {
+            uint64_t count = 0;
+            if (!Get(count) || count > Remaining()) {
+                return Fail();
+            }
+            s.assign(reinterpret_cast<const char*>(_data + _pos), count);
+            _pos += count;
+            return true;
+        }
+
+        bool IsOk() const { return _ok; }
+        uint64_t Remaining() const { return _len - _pos; }
+
+    private:
+        bool GetBytes(void* dst, uint64_t len) {
+            if (!_ok || len > Remaining()) {
+                return Fail();
+            }
+            if (len > 0) {
+                memcpy(dst, _data + _pos, len);
+            }
+            _pos += len;
+            return true;
+        }
+        bool Fail() {
+            _ok = false;
+            return false;
+        }
+
+        const uint8_t* _data;
+        uint64_t _len;
+        uint64_t _pos = 0;
+        bool _ok = true;
+    };
+
+    // Where entries are kept, normally the render cache directory. An empty
+    // folder disables the cache.
+    static void SetFolder(const std::string& folder);
+    static bool IsEnabled();
+
+    // Looks for an entry and hands it to `read`. Returns false if there is no
+    // entry, it was written by another version or `read` rejects it.
+    static bool Load(AudioManager* audio, const std::string& type, const std::string& params,
+                     const std::function<bool(Reader&)>& read);
+    // Writes an entry, replacing any existing one.
+    static void Store(AudioManager* audio, const std::string& type, const std::string& params,
+                      const std::function<void(Writer&)>& write);
+
+    // Removes every entry. Done along with purging the render cache.
+    static void Purge();
+};
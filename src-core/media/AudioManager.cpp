@@ -24,8 +24,10 @@
 #include <stdlib.h>
 
 #include "AudioManager.h"
+#include "AudioAnalysisCache.h"
 #include "IAudioOutput.h"
 #include "IAudioDecoder.h"
+#include "../render/RenderProfile.h"
 #include "../utils/ExternalHooks.h"
 #include "../utils/Parallel.h"
 #include "../utils/UtilFunctions.h"
@@ -67,6 +69,9 @@ static FFmpegAudioDecoder __audioDecoder;
 
 #define PCMFUDGE 32768
 
+// samples each worker filters at a time in the band pass filters
+static constexpr long FILTER_CHUNK_SAMPLES = 65536;
+
 #if !TARGET_OS_IPHONE
 static void ProgressFunction(int p) {
     // placeholder for polyphonic transcription progress
@@ -304,33 +309,46 @@ AudioManager::AudioManager(const std::string& audio_file, int intervalMS, const
     // for the old SDL path and is no longer needed.
 }
 
-void AudioManager::CalculateSpectrumAnalysis(const float* in, int n, float& max, int id, std::vector<float>& res) const {
-    res.clear();
-    res.reserve(127);
-    int outcount = n / 2 + 1;
-    kiss_fftr_cfg cfg;
-    kiss_fft_cpx* out = (kiss_fft_cpx*)malloc(sizeof(kiss_fft_cpx) * (outcount));
-    if (out != nullptr) {
-        if ((cfg = kiss_fftr_alloc(n, 0 /*is_inverse_fft*/, nullptr, nullptr)) != nullptr) {
-            kiss_fftr(cfg, in, out);
-            free(cfg);
-        }
-
-        for (int j = 0; j < 127; j++) {
+// An FFT plan and output buffer for one window size along with the bins that make up
+// each MIDI note.  Setting these up costs more than the FFT itself so each worker in
+// DoPrepareFrameData creates one and reuses it for every window it analyses.
+class SpectrumAnalyser {
+public:
+    SpectrumAnalyser(int n, long rate) :
+        _outcount(n / 2 + 1), _out(n / 2 + 1) {
+        _cfg = kiss_fftr_alloc(n, 0 /*is_inverse_fft*/, nullptr, nullptr);
+        for (int j = 0; j < NOTES; j++) {
             // choose the right bucket for this MIDI note
             double freq = 440.0 * exp2f(((double)j - 69.0) / 12.0);
-            int start = freq * (double)n / (double)_rate;
             double freqnext = 440.0 * exp2f(((double)j + 1.0 - 69.0) / 12.0);
-            int end = freqnext * (double)n / (double)_rate;
+            _buckets[j].first = freq * (double)n / (double)rate;
+            _buckets[j].second = freqnext * (double)n / (double)rate;
+        }
+    }
+    ~SpectrumAnalyser() {
+        free(_cfg);
+    }
+    SpectrumAnalyser(const SpectrumAnalyser&) = delete;
+    SpectrumAnalyser& operator=(const SpectrumAnalyser&) = delete;
+
+    void Calculate(const float* in, float& max, std::vector<float>& res) {
+        res.clear();
+        if (_cfg == nullptr) {
+            return;
+        }
+        res.reserve(NOTES);
+        kiss_fftr(_cfg, in, _out.data());
 
+        for (int j = 0; j < NOTES; j++) {
+            const int start = _buckets[j].first;
+            const int end = _buckets[j].second;
             float val = 0.0;
 
             // got through all buckets up to the next note and take the maximums
-            if (end < outcount - 1) {
+            if (end < _outcount - 1) {
                 for (int k = start; k <= end; k++) {
-                    kiss_fft_cpx* cur = out + k;
-                    val = std::max(val, sqrtf(cur->r * cur->r + cur->i * cur->i));
-                    // float valscaled = valnew * scaling;
+                    const kiss_fft_cpx& cur = _out[k];
+                    val = std::max(val, sqrtf(cur.r * cur.r + cur.i * cur.i));
                 }
             }
 
@@ -344,7 +362,40 @@ void AudioManager::CalculateSpectrumAnalysis(const float* in, int n, float& max,
                 max = db;
             }
         }
-        free(out);
+    }
+
+private:
+    static constexpr int NOTES = 127;
+    int _outcount;
+    kiss_fftr_cfg _cfg = nullptr;
+    std::vector<kiss_fft_cpx> _out;
+    std::pair<int, int> _buckets[NOTES];
+};
+
+// Min and max of a run of samples.  Kept in independent lanes so the compiler can
+// hold them in vector registers rather than serialising on a single accumulator.
+static void SampleRange(const float* data, long count, float& min, float& max) {
+    constexpr int LANES = 8;
+    float lmin[LANES];
+    float lmax[LANES];
+    for (int l = 0; l < LANES; l++) {
+        lmin[l] = min;
+        lmax[l] = max;
+    }
+    long i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        for (int l = 0; l < LANES; l++) {
+            lmin[l] = data[i + l] < lmin[l] ? data[i + l] : lmin[l];
+            lmax[l] = data[i + l] > lmax[l] ? data[i + l] : lmax[l];
+        }
+    }
+    for (; i < count; i++) {
+        min = data[i] < min ? data[i] : min;
+        max = data[i] > max ? data[i] : max;
+    }
+    for (int l = 0; l < LANES; l++) {
+        min = std::min(min, lmin[l]);
+        max = std::max(max, lmax[l]);
     }
 }
 
@@ -547,102 +598,114 @@ void AudioManager::DoPrepareFrameData() {
     spdlog::info("    Frames {}", frames);
     spdlog::info("    Total samples {}", totalsamples);
 
+    const std::string cacheParams = "interval=" + std::to_string(_intervalMS);
+    if (LoadCachedFrameData(cacheParams, frames)) {
+        _frameDataPrepared = true;
+        spdlog::info("DoPrepareFrameData: Audio frame data loaded from cache in {}. Frames: {}", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - sw_start).count(), frames);
+        return;
+    }
+
     // these are used to normalise output
     _bigmax = -1;
     _bigspread = -1;
     _bigmin = 1;
     _bigspectogrammax = -1;
 
-    size_t step = 2048;
-    float* pdata[2];
+    const int step = 2048;
 
-    int pos = 0;
-    std::vector<float> spectrogram;
-    std::vector<float> subspectrogram;
+    // the spectrogram windows are taken back to back through the song and each belongs
+    // to the frame it starts in, that makes every frame independent of the others
+    const int windows = totalsamples > 0 ? (totalsamples - 1) / step : 0;
+    FilteredAudioData* fad = GetFilteredAudioData(AUDIOSAMPLETYPE::RAW, -1, -1);
+    const float* raw = fad != nullptr ? fad->data0 : nullptr;
+    const long trackSize = _trackSize;
+
+    constexpr int FRAMES_PER_CHUNK = 64;
+    const int chunks = (frames + FRAMES_PER_CHUNK - 1) / FRAMES_PER_CHUNK;
+    std::vector<float> chunkSpectrogramMax(chunks, -1);
+    std::vector<uint8_t> hasSpectrogram(frames, 0);
 
     // process each frome of the song
     _frameData.resize(frames);
-    for (int i = 0; i < frames; i++) {
-        // accumulators
-        float max = -100.0;
-        float min = 100.0;
-        float spread = -100;
-
-        // clear the data if we are about to get new data ... dont clear it if we wont
-        // this happens because the spectrogram function has a fixed window based on the parameters we set and it
-        // does not match our time slices exactly so we have to select which one to use
-        if (pos < i * samplesperframe + samplesperframe && pos + (int)step < totalsamples) {
+    parallel_for(0, chunks, [&](int c) {
+        SpectrumAnalyser analyser(step, _rate);
+        std::vector<float> subspectrogram;
+        const int last = std::min(frames, (c + 1) * FRAMES_PER_CHUNK);
+        for (int i = c * FRAMES_PER_CHUNK; i < last; i++) {
+            FrameData& fd = _frameData[i];
+            const long start = (long)i * samplesperframe;
+            const long end = start + samplesperframe;
+
+            std::vector<float>& spectrogram = fd.vu;
             spectrogram.clear();
-        }
-
-        // only get the data if we are not ahead of the music
-        while (pos < i * samplesperframe + samplesperframe && pos + (int)step < totalsamples) {
-            pdata[0] = GetRawLeftDataPtr(pos);
-            assert(pdata[0] != nullptr);
-            pdata[1] = GetRawRightDataPtr(pos);
-            float max2 = 0;
-
-            if (pdata[0] == nullptr) {
-                subspectrogram.clear();
-            } else {
-                CalculateSpectrumAnalysis(pdata[0], step, max2, i, subspectrogram);
-            }
+            const int firstWindow = (int)((start + step - 1) / step);
+            const int lastWindow = std::min(windows, (int)((end + step - 1) / step));
+            hasSpectrogram[i] = firstWindow < lastWindow;
+            for (int w = firstWindow; w < lastWindow; w++) {
+                const long pos = (long)w * step;
+                float max2 = 0;
+                if (raw == nullptr || pos > trackSize) {
+                    subspectrogram.clear();
+                } else {
+                    analyser.Calculate(raw + pos, max2, subspectrogram);
+                }
 
-            // and keep track of the larges value so we can normalise it
-            if (max2 > _bigspectogrammax) {
-                _bigspectogrammax = max2;
-            }
-            pos += step;
+                // and keep track of the larges value so we can normalise it
+                if (max2 > chunkSpectrogramMax[c]) {
+                    chunkSpectrogramMax[c] = max2;
+                }
 
-            // either take the newly calculated values or if we are merging two results take the maximum of each value
-            if (spectrogram.size() == 0) {
-                spectrogram = subspectrogram;
-            } else {
-                if (subspectrogram.size() > 0) {
-                    std::vector<float>::iterator sub = subspectrogram.begin();
-                    for (std::vector<float>::iterator fr = spectrogram.begin(); fr != spectrogram.end(); ++fr) {
-                        if (*sub > *fr) {
-                            *fr = *sub;
-                        }
-                        ++sub;
+                // either take the newly calculated values or if we are merging two results take the maximum of each value
+                if (spectrogram.empty()) {
+                    spectrogram = subspectrogram;
+                } else if (!subspectrogram.empty()) {
+                    for (size_t v = 0; v < spectrogram.size(); v++) {
+                        spectrogram[v] = std::max(spectrogram[v], subspectrogram[v]);
                     }
                 }
             }
-        }
-
-        // now do the raw data analysis for the frame
-        for (int j = 0; j < samplesperframe; j++) {
-            float data = GetRawLeftData(i * samplesperframe + j);
-
-            // Max data
-            if (data > max) {
-                max = data;
-            }
-
-            // Min data
-            if (data < min) {
-                min = data;
-            }
 
-            // Spread data
-            if (max - min > spread) {
+            // now do the raw data analysis for the frame, samples past the end of the track read as silence
+            float max = -100.0;
+            float min = 100.0;
+            float spread = -100;
+            if (samplesperframe > 0) {
+                const long available = raw == nullptr ? 0 : std::clamp(trackSize + 1 - start, 0L, (long)samplesperframe);
+                if (available > 0) {
+                    SampleRange(raw + start, available, min, max);
+                }
+                if (available < samplesperframe) {
+                    min = std::min(min, 0.0f);
+                    max = std::max(max, 0.0f);
+                }
                 spread = max - min;
             }
+            fd.min = min;
+            fd.max = max;
+            fd.spread = spread;
         }
+    }, 1);
 
-        if (max > _bigmax) {
-            _bigmax = max;
+    for (float m : chunkSpectrogramMax) {
+        if (m > _bigspectogrammax) {
+            _bigspectogrammax = m;
+        }
+    }
+    for (int i = 0; i < frames; i++) {
+        FrameData& fd = _frameData[i];
+        // a frame shorter than a window may not start one, it shows the spectrogram of the one before
+        if (!hasSpectrogram[i] && i > 0) {
+            fd.vu = _frameData[i - 1].vu;
+        }
+        if (fd.max > _bigmax) {
+            _bigmax = fd.max;
         }
-        if (min < _bigmin) {
-            _bigmin = min;
+        if (fd.min < _bigmin) {
+            _bigmin = fd.min;
         }
-        if (spread > _bigspread) {
-            _bigspread = spread;
+        if (fd.spread > _bigspread) {
+            _bigspread = fd.spread;
         }
-        _frameData[i].min = min;
-        _frameData[i].max = max;
-        _frameData[i].spread = spread;
-        _frameData[i].vu = spectrogram;
     }
 
     // normalise data ... basically scale the data so the highest value is the scale value.
@@ -661,10 +724,42 @@ void AudioManager::DoPrepareFrameData() {
         }
     }
 
+    AudioAnalysisCache::Store(this, "frames", cacheParams, [this](AudioAnalysisCache::Writer& w) {
+        w.Add((uint64_t)_frameData.size());
+        for (const auto& fr : _frameData) {
+            w.Add(fr.min);
+            w.Add(fr.max);
+            w.Add(fr.spread);
+            w.AddVector(fr.vu);
+        }
+    });
+
     // flag the fact that the data is all ready
     _frameDataPrepared = true;
     spdlog::info("DoPrepareFrameData: Audio frame data processing complete in {}. Frames: {}", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - sw_start).count(), frames);
 }
+bool AudioManager::LoadCachedFrameData(const std::string& params, int frames) {
+    std::vector<FrameData> frameData;
+    bool loaded = AudioAnalysisCache::Load(this, "frames", params, [&frameData, frames](AudioAnalysisCache::Reader& r) {
+        uint64_t count = 0;
+        if (!r.Get(count) || count != (uint64_t)frames) {
+            return false;
+        }
+        frameData.resize(frames);
+        for (auto& fr : frameData) {
+            r.Get(fr.min);
+            r.Get(fr.max);
+            r.Get(fr.spread);
+            r.GetVector(fr.vu);
+        }
+        return r.IsOk();
+    });
+    if (loaded) {
+        _frameData = std::move(frameData);
+    }
+    return loaded;
+}
+
 // Called to trigger frame data creation
 void AudioManager::PrepareFrameData(bool separateThread) {
     // if frame data is already being processed, wait for that one to finish, otherwise
@@ -961,6 +1056,34 @@ std::string AudioManager::MidiToNote(int midi) {
     return std::string(notes[offset]) + std::to_string(octave);
 }
 
+// Only the band pass filters are worth caching, the others are a single cheap pass over the samples
+bool AudioManager::LoadCachedFilteredAudioData(const std::string& params, FilteredAudioData* fad) {
+    return AudioAnalysisCache::Load(this, "filter", params, [this, fad](AudioAnalysisCache::Reader& r) {
+        uint8_t hasRight = 0;
+        r.Get(hasRight);
+        if (hasRight != (fad->data1 != nullptr ? 1 : 0)) {
+            return false;
+        }
+        r.GetArray(fad->data0, _trackSize);
+        if (fad->data1 != nullptr) {
+            r.GetArray(fad->data1, _trackSize);
+        }
+        r.GetArray(reinterpret_cast<uint8_t*>(fad->pcmdata), _pcmdatasize);
+        return r.IsOk();
+    });
+}
+
+void AudioManager::StoreCachedFilteredAudioData(const std::string& params, const FilteredAudioData* fad) {
+    AudioAnalysisCache::Store(this, "filter", params, [this, fad](AudioAnalysisCache::Writer& w) {
+        w.Add((uint8_t)(fad->data1 != nullptr ? 1 : 0));
+        w.AddArray(fad->data0, _trackSize);
+        if (fad->data1 != nullptr) {
+            w.AddArray(fad->data1, _trackSize);
+        }
+        w.AddArray(reinterpret_cast<const uint8_t*>(fad->pcmdata), _pcmdatasize);
+    });
+}
+
 void AudioManager::NormaliseFilteredAudioData(FilteredAudioData* fad) {
     // PCM Data is the displayed waveform
     int16_t* pcm = fad->pcmdata;
@@ -1043,8 +1166,6 @@ void AudioManager::NormaliseFilteredAudioData(FilteredAudioData* fad) {
 }
 
 FilteredAudioData* AudioManager::EnsureFilteredAudioData(AUDIOSAMPLETYPE type, int lowNote, int highNote) {
-    static const double pi2 = 6.283185307;
-
     if (type == AUDIOSAMPLETYPE::BASS) {
         lowNote = 48;
         highNote = 60;
@@ -1056,14 +1177,21 @@ FilteredAudioData* AudioManager::EnsureFilteredAudioData(AUDIOSAMPLETYPE type, i
         highNote = 84;
     }
 
-    std::lock_guard<std::recursive_mutex> flock(_filteredMutex);
+    auto findFiltered = [this, type, lowNote, highNote]() -> FilteredAudioData* {
+        for (const auto& it : _filtered) {
+            if ((type == AUDIOSAMPLETYPE::ANY || it->type == type) &&
+                (lowNote == -1 || (it->lowNote == lowNote && it->highNote == highNote))) {
+                return it;
+            }
+        }
+        return nullptr;
+    };
+
+    std::unique_lock<std::recursive_mutex> flock(_filteredMutex);
 
     // Fast path: already cached.
-    for (const auto& it : _filtered) {
-        if ((type == AUDIOSAMPLETYPE::ANY || it->type == type) &&
-            (lowNote == -1 || (it->lowNote == lowNote && it->highNote == highNote))) {
-            return it;
-        }
+    if (FilteredAudioData* cached = findFiltered(); cached != nullptr) {
+        return cached;
     }
 
     if (_data[0] == nullptr || _pcmdata == nullptr) {
@@ -1075,13 +1203,20 @@ FilteredAudioData* AudioManager::EnsureFilteredAudioData(AUDIOSAMPLETYPE type, i
     // the tail is uninitialised (calloc'd zeros on iPad) until the
     // async decoder thread catches up. Reading zeros from the tail
     // makes L/R look identical there and drives NONVOCALS / VOCALS
-    // peak estimates wrongly toward zero.
-    if (type != AUDIOSAMPLETYPE::RAW && _trackSize > 0) {
+    // peak estimates wrongly toward zero. Waited for without the
+    // lock so lookups of filters that already exist are not held up.
+    if (type != AUDIOSAMPLETYPE::RAW && _trackSize > 0 && !IsDataLoaded(_trackSize - 1)) {
+        flock.unlock();
         int waits = 0;
         while (!IsDataLoaded(_trackSize - 1) && waits < 100) {
             std::this_thread::sleep_for(std::chrono::milliseconds(50));
             waits++;
         }
+        flock.lock();
+        // another thread may have built it while we waited
+        if (FilteredAudioData* cached = findFiltered(); cached != nullptr) {
+            return cached;
+        }
     }
 
     // Ensure the RAW cache entry exists — all downstream filters read
@@ -1122,6 +1257,108 @@ FilteredAudioData* AudioManager::EnsureFilteredAudioData(AUDIOSAMPLETYPE type, i
     const float* srcR = (rawFad && rawFad->data1) ? rawFad->data1
                                                   : (_data[1] ? _data[1] : nullptr);
 
+    // The gated and stem filters read state SetClassifyGate/SetStemData
+    // replace under this lock, and are a single cheap pass, so they are
+    // still built holding it.
+    if (type == AUDIOSAMPLETYPE::CLASSIFIED ||
+        type == AUDIOSAMPLETYPE::STEM_DRUMS ||
+        type == AUDIOSAMPLETYPE::STEM_BASS ||
+        type == AUDIOSAMPLETYPE::STEM_OTHER ||
+        type == AUDIOSAMPLETYPE::STEM_VOCALS ||
+        type == AUDIOSAMPLETYPE::RAW ||
+        type == AUDIOSAMPLETYPE::ANY) {
+        FilteredAudioData* fad = BuildFilteredAudioData(type, lowNote, highNote, srcL, srcR, rawFad);
+        if (fad != nullptr) {
+            _filtered.push_back(fad);
+        }
+        return fad;
+    }
+
+    // Everything else only reads the RAW entry, which is never evicted,
+    // so it is built without the lock. If another thread is already
+    // building this filter wait for its result.
+    const auto key = std::make_tuple(type, lowNote, highNote);
+    auto building = _filterBuilds.find(key);
+    if (building != _filterBuilds.end()) {
+        std::shared_future<FilteredAudioData*> result = building->second;
+        flock.unlock();
+        RenderJobProfile* prof = tlsRenderProfile;
+        if (prof != nullptr) {
+            auto t0 = std::chrono::steady_clock::now();
+            result.wait();
+            prof->audioWaits++;
+            prof->audioWaitNs += xlProfNs(t0, std::chrono::steady_clock::now());
+        }
+        return result.get();
+    }
+
+    std::promise<FilteredAudioData*> promise;
+    _filterBuilds[key] = promise.get_future().share();
+    flock.unlock();
+
+    FilteredAudioData* fad = nullptr;
+    try {
+        fad = BuildFilteredAudioData(type, lowNote, highNote, srcL, srcR, rawFad);
+    } catch (...) {
+        flock.lock();
+        _filterBuilds.erase(key);
+        flock.unlock();
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    flock.lock();
+    if (fad != nullptr) {
+        _filtered.push_back(fad);
+    }
+    _filterBuilds.erase(key);
+    flock.unlock();
+    promise.set_value(fad);
+    return fad;
+}
+
+// Band pass FIR over samples [start, end) of one channel. The taps are
+// reversed so both arrays are walked forwards. Eight outputs are summed
+// side by side, which the compiler vectorises, while each output still
+// adds its taps in the same order as the one at a time loop.
+static void ApplyBandPassFilter(const float* src, float* dst, long start, long end, const float* taps, int order) {
+    constexpr int LANES = 8;
+    long i = start;
+    // the first order outputs start before the track, skip those taps
+    for (; i < end && i < order; i++) {
+        float v = 0;
+        for (int j = order - (int)i; j < order; j++) {
+            v += src[i + j - order] * taps[j];
+        }
+        dst[i] = v;
+    }
+    for (; i + LANES <= end; i += LANES) {
+        const float* s = src + i - order;
+        float acc[LANES] = {};
+        for (int j = 0; j < order; j++) {
+            const float t = taps[j];
+            for (int k = 0; k < LANES; k++) {
+                acc[k] += s[j + k] * t;
+            }
+        }
+        for (int k = 0; k < LANES; k++) {
+            dst[i + k] = acc[k];
+        }
+    }
+    for (; i < end; i++) {
+        const float* s = src + i - order;
+        float v = 0;
+        for (int j = 0; j < order; j++) {
+            v += s[j] * taps[j];
+        }
+        dst[i] = v;
+    }
+}
+
+FilteredAudioData* AudioManager::BuildFilteredAudioData(AUDIOSAMPLETYPE type, int lowNote, int highNote,
+                                                        const float* srcL, const float* srcR, const FilteredAudioData* rawFad) {
+    static const double pi2 = 6.283185307;
+
     FilteredAudioData* fad = nullptr;
     switch (type) {
     case AUDIOSAMPLETYPE::NONVOCALS: {
@@ -1168,10 +1405,9 @@ FilteredAudioData* AudioManager::EnsureFilteredAudioData(AUDIOSAMPLETYPE type, i
         fad->highNote = 0;
         fad->type = type;
         NormaliseFilteredAudioData(fad);
-        _filtered.push_back(fad);
     } break;
     case AUDIOSAMPLETYPE::RAW:
-        // Handled by the RAW-ensure block above.
+        // Handled by the RAW-ensure block in EnsureFilteredAudioData.
         break;
     case AUDIOSAMPLETYPE::ALTO:
     case AUDIOSAMPLETYPE::BASS:
@@ -1204,40 +1440,41 @@ FilteredAudioData* AudioManager::EnsureFilteredAudioData(AUDIOSAMPLETYPE type, i
                 a[i + middle] = sin(w2_c * i) / (M_PI * i) - sin(w1_c * i) / (M_PI * i);
             }
         }
-        parallel_for(0, _trackSize, [fad, this, a, order, srcL, srcR](int i) {
-            float lvalue = 0;
-            float rvalue = 0;
-            for (int j = 0; j < order; j++) {
-                int jj = i + j - order;
-                if (jj >= 0 && jj < _trackSize) {
-                    lvalue += srcL[jj] * a[order - j - 1];
-                    if (srcR) {
-                        rvalue += srcR[jj] * a[order - j - 1];
-                    }
-                }
-            }
-            fad->data0[i] = lvalue;
+        fad->lowNote = lowNote;
+        fad->highNote = highNote;
+        fad->type = type;
+        const std::string cacheParams = "notes=" + std::to_string(lowNote) + "-" + std::to_string(highNote);
+        if (LoadCachedFilteredAudioData(cacheParams, fad)) {
+            break;
+        }
 
-            lvalue = lvalue * 32768;
-            int v2 = (int)lvalue;
-            fad->pcmdata[i * _channels] = v2;
-            if (_channels > 1) {
-                if (srcR) {
-                    fad->data1[i] = rvalue;
-                    rvalue = rvalue * 32768;
-                    v2 = (int)rvalue;
-                    fad->pcmdata[i * _channels + 1] = v2;
-                } else {
+        float taps[order];
+        for (int j = 0; j < order; j++) {
+            taps[j] = a[order - j - 1];
+        }
+        const float* srcRight = (srcR && fad->data1) ? srcR : nullptr;
+        const long chunks = (_trackSize + FILTER_CHUNK_SAMPLES - 1) / FILTER_CHUNK_SAMPLES;
+        parallel_for(0, (int)chunks, [fad, this, &taps, order, srcL, srcRight](int c) {
+            const long start = (long)c * FILTER_CHUNK_SAMPLES;
+            const long end = std::min((long)_trackSize, start + FILTER_CHUNK_SAMPLES);
+            ApplyBandPassFilter(srcL, fad->data0, start, end, taps, order);
+            if (srcRight) {
+                ApplyBandPassFilter(srcRight, fad->data1, start, end, taps, order);
+            }
+            for (long i = start; i < end; i++) {
+                int v2 = (int)(fad->data0[i] * 32768);
+                fad->pcmdata[i * _channels] = v2;
+                if (_channels > 1) {
+                    if (srcRight) {
+                        v2 = (int)(fad->data1[i] * 32768);
+                    }
                     fad->pcmdata[i * _channels + 1] = v2;
                 }
             }
         });
 
-        fad->lowNote = lowNote;
-        fad->highNote = highNote;
-        fad->type = type;
         NormaliseFilteredAudioData(fad);
-        _filtered.push_back(fad);
+        StoreCachedFilteredAudioData(cacheParams, fad);
     } break;
     case AUDIOSAMPLETYPE::VOCALS: {
         // A8 (partial): centre-channel extraction. Mid = (L+R)/2 is
@@ -1296,7 +1533,6 @@ FilteredAudioData* AudioManager::EnsureFilteredAudioData(AUDIOSAMPLETYPE type, i
         fad->highNote = 0;
         fad->type = type;
         NormaliseFilteredAudioData(fad);
-        _filtered.push_back(fad);
     } break;
     case AUDIOSAMPLETYPE::LUFS: {
         // A3: BS.1770 K-weighting → 400 ms momentary loudness envelope.
@@ -1321,14 +1557,8 @@ FilteredAudioData* AudioManager::EnsureFilteredAudioData(AUDIOSAMPLETYPE type, i
         // Copy from the RAW cache entry (not `_pcmdata`, which may
         // already carry a previous filter's signal after a prior
         // SwitchTo) so playback is preserved regardless of ordering.
-        {
-            FilteredAudioData* rawEntry = nullptr;
-            for (const auto& it : _filtered) {
-                if (it->type == AUDIOSAMPLETYPE::RAW) { rawEntry = it; break; }
-            }
-            if (rawEntry && rawEntry->pcmdata) {
-                memcpy(fad->pcmdata, rawEntry->pcmdata, _pcmdatasize);
-            }
+        if (rawFad && rawFad->pcmdata) {
+            memcpy(fad->pcmdata, rawFad->pcmdata, _pcmdatasize);
         }
 
         // RBJ cookbook coefficients at our sample rate for:
@@ -1429,7 +1659,6 @@ FilteredAudioData* AudioManager::EnsureFilteredAudioData(AUDIOSAMPLETYPE type, i
         fad->lowNote = 0;
         fad->highNote = 0;
         fad->type = type;
-        _filtered.push_back(fad);
     } break;
     case AUDIOSAMPLETYPE::CLASSIFIED: {
         // A7: raw signal gated by the class-confidence curve set via
@@ -1481,7 +1710,6 @@ FilteredAudioData* AudioManager::EnsureFilteredAudioData(AUDIOSAMPLETYPE type, i
         fad->lowNote = 0;
         fad->highNote = 0;
         fad->type = type;
-        _filtered.push_back(fad);
     } break;
     case AUDIOSAMPLETYPE::STEM_DRUMS:
     case AUDIOSAMPLETYPE::STEM_BASS:
@@ -1531,7 +1759,6 @@ FilteredAudioData* AudioManager::EnsureFilteredAudioData(AUDIOSAMPLETYPE type, i
         fad->lowNote = 0;
         fad->highNote = 0;
         fad->type = type;
-        _filtered.push_back(fad);
     } break;
     case AUDIOSAMPLETYPE::ANY:
         break;
@@ -1620,7 +1847,15 @@ FilteredAudioData* AudioManager::GetFilteredAudioData(AUDIOSAMPLETYPE type, int
             return nullptr;
         }
         flock.unlock();
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        RenderJobProfile* prof = tlsRenderProfile;
+        if (prof != nullptr) {
+            auto t0 = std::chrono::steady_clock::now();
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            prof->audioWaits++;
+            prof->audioWaitNs += xlProfNs(t0, std::chrono::steady_clock::now());
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
     }
 }
 
@@ -1897,20 +2132,32 @@ float* AudioManager::GetFilteredRightDataPtr(long offset) {
 // data — used by iPad's spectrogram cache to invalidate when the
 // audio content changes. Kept outside the VAMP `#if` gate below so
 // iOS builds (which exclude VAMP plugin code) still get this
-// symbol. Desktop callers use it too.
+// symbol. Desktop callers use it too. Worked out once by whichever
+// thread asks first, the others wait for it, so it must not be called
+// holding `_filteredMutex`.
 std::string AudioManager::Hash() {
-    if (_hash == "") {
-
+    std::call_once(_hashOnce, [this]() {
         while (!IsDataLoaded(_trackSize)) {
             spdlog::debug("GetLeftDataPtr waiting for data to be loaded.");
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
 
+        // hash the original samples, after a SwitchTo _data holds the filtered ones
+        const float* data = _data[0];
+        {
+            std::lock_guard<std::recursive_mutex> flock(_filteredMutex);
+            for (const auto& it : _filtered) {
+                if (it->type == AUDIOSAMPLETYPE::RAW) {
+                    data = it->data0;
+                    break;
+                }
+            }
+        }
         MD5 md5;
-        md5.update((unsigned char*)_data[0], sizeof(float) * _trackSize);
+        md5.update((unsigned char*)data, sizeof(float) * _trackSize);
         md5.finalize();
         _hash = md5.hexdigest();
-    }
+    });
 
     return _hash;
 }
@@ -13,10 +13,12 @@
 #include <functional>
 #include <future>
 #include <list>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <shared_mutex>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #if !TARGET_OS_IPHONE
@@ -109,6 +111,11 @@ class AudioManager {
     // vector or holding a FilteredAudioData* across erase is otherwise
     // UAF.
     mutable std::recursive_mutex _filteredMutex;
+    // Filters being built outside `_filteredMutex`, keyed by
+    // (type, lowNote, highNote). A second request for the same key waits
+    // on the first one's result instead of computing it again, requests
+    // for different keys run in parallel. Guarded by `_filteredMutex`.
+    std::map<std::tuple<AUDIOSAMPLETYPE, int, int>, std::shared_future<FilteredAudioData*>> _filterBuilds;
     // A7: state for `AUDIOSAMPLETYPE::CLASSIFIED`. Populated by
     // `SetClassifyGate`. The gate curve is re-interpolated per-
     // sample inside `EnsureFilteredAudioData(CLASSIFIED)`.
@@ -125,7 +132,8 @@ class AudioManager {
     std::vector<float> _stemVocalsL, _stemVocalsR;
     mutable int _sdlid = 0;
     bool _ok = false;
-    std::string _hash;
+    std::once_flag _hashOnce;
+    std::string _hash; // set once under _hashOnce, see Hash()
     std::future<void> _prepFrameData;
     std::future<void> _loadingAudio;
     std::string _device;
@@ -135,10 +143,14 @@ class AudioManager {
 
     int OpenMediaFile();
     void PrepareFrameData(bool separateThread);
-    void CalculateSpectrumAnalysis(const float* in, int n, float& max, int id, std::vector<float>& d) const;
     void SetLoadedData(long pos);
 
     void NormaliseFilteredAudioData(FilteredAudioData* fad);
+    FilteredAudioData* BuildFilteredAudioData(AUDIOSAMPLETYPE type, int lowNote, int highNote,
+                                              const float* srcL, const float* srcR, const FilteredAudioData* rawFad);
+    bool LoadCachedFilteredAudioData(const std::string& params, FilteredAudioData* fad);
+    void StoreCachedFilteredAudioData(const std::string& params, const FilteredAudioData* fad);
+    bool LoadCachedFrameData(const std::string& params, int frames);
 
 public:
     static double MidiToFrequency(int midi);
@@ -7,6 +7,7 @@
 #include "ChordDetector.h"
 
 #include "AudioManager.h"
+#include "AudioAnalysisCache.h"
 #include "kiss_fft/tools/kiss_fftr.h"
 
 #include <algorithm>
@@ -63,10 +64,8 @@ std::vector<float> MakeHannWindow(int n) {
     return w;
 }
 
-} // namespace
-
-HarmonyAnalysis DetectChords(AudioManager* audio,
-                              const ChordDetectorOptions& opts) {
+HarmonyAnalysis CalculateChords(AudioManager* audio,
+                                const ChordDetectorOptions& opts) {
     HarmonyAnalysis out;
     if (!audio || !audio->IsOk()) return out;
 
@@ -239,3 +238,45 @@ HarmonyAnalysis DetectChords(AudioManager* audio,
 
     return out;
 }
+
+} // namespace
+
+HarmonyAnalysis DetectChords(AudioManager* audio,
+                              const ChordDetectorOptions& opts) {
+    HarmonyAnalysis out;
+    if (!audio || !audio->IsOk()) return out;
+
+    const std::string params = "frame=" + std::to_string(opts.frameSize) +
+                               ",hop=" + std::to_string(opts.hopSize) +
+                               ",freq=" + std::to_string(opts.minFreqHz) +
+                               "-" + std::to_string(opts.maxFreqHz) +
+                               ",segment=" + std::to_string(opts.minSegmentMS);
+    if (AudioAnalysisCache::Load(audio, "chords", params, [&out](AudioAnalysisCache::Reader& r) {
+            uint64_t count = 0;
+            r.GetString(out.key);
+            if (!r.Get(count) || count > r.Remaining()) return false;
+            out.chords.resize(count);
+            for (auto& c : out.chords) {
+                r.Get(c.startMS);
+                r.Get(c.endMS);
+                r.GetString(c.name);
+            }
+            return r.IsOk();
+        })) {
+        return out;
+    }
+
+    out = CalculateChords(audio, opts);
+    if (!out.key.empty()) {
+        AudioAnalysisCache::Store(audio, "chords", params, [&out](AudioAnalysisCache::Writer& w) {
+            w.AddString(out.key);
+            w.Add((uint64_t)out.chords.size());
+            for (const auto& c : out.chords) {
+                w.Add(c.startMS);
+                w.Add(c.endMS);
+                w.AddString(c.name);
+            }
+        });
+    }
+    return out;
+}
@@ -7,11 +7,13 @@
 #include "OnsetDetector.h"
 
 #include "AudioManager.h"
+#include "AudioAnalysisCache.h"
 #include "kiss_fft/tools/kiss_fftr.h"
 
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <string>
 #include <vector>
 
 namespace {
@@ -30,10 +32,8 @@ std::vector<float> MakeHannWindow(int n) {
     return w;
 }
 
-} // namespace
-
-OnsetEnvelope ComputeOnsetEnvelope(AudioManager* audio,
-                                    const OnsetDetectorOptions& opts) {
+OnsetEnvelope CalculateOnsetEnvelope(AudioManager* audio,
+                                     const OnsetDetectorOptions& opts) {
     OnsetEnvelope env;
     if (!audio || !audio->IsOk()) return env;
 
@@ -92,6 +92,39 @@ OnsetEnvelope ComputeOnsetEnvelope(AudioManager* audio,
     return env;
 }
 
+} // namespace
+
+OnsetEnvelope ComputeOnsetEnvelope(AudioManager* audio,
+                                    const OnsetDetectorOptions& opts) {
+    OnsetEnvelope env;
+    if (!audio || !audio->IsOk()) return env;
+
+    // Only the window and hop shape the envelope; the peak-picking
+    // options are applied afterwards by `DetectOnsets`.
+    const std::string params = "frame=" + std::to_string(opts.frameSize) +
+                               ",hop=" + std::to_string(opts.hopSize);
+    if (AudioAnalysisCache::Load(audio, "onsets", params, [&env](AudioAnalysisCache::Reader& r) {
+            r.GetVector(env.flux);
+            r.Get(env.hopSize);
+            r.Get(env.sampleRate);
+            r.Get(env.lengthMS);
+            return r.IsOk();
+        })) {
+        return env;
+    }
+
+    env = CalculateOnsetEnvelope(audio, opts);
+    if (!env.flux.empty()) {
+        AudioAnalysisCache::Store(audio, "onsets", params, [&env](AudioAnalysisCache::Writer& w) {
+            w.AddVector(env.flux);
+            w.Add(env.hopSize);
+            w.Add(env.sampleRate);
+            w.Add(env.lengthMS);
+        });
+    }
+    return env;
+}
+
 std::vector<long> DetectOnsets(AudioManager* audio,
                                const OnsetDetectorOptions& opts) {
     std::vector<long> onsets;
@@ -8,11 +8,13 @@
 
 #include "StemSeparator.h"
 #include "AudioManager.h"
+#include "AudioAnalysisCache.h"
 #include "kiss_fft/tools/kiss_fftr.h"
 #include <spdlog/spdlog.h>
 #include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <filesystem>
 #include <vector>
 
 #ifdef __APPLE__
@@ -118,14 +120,14 @@ extern "C" OrtStatus* ORT_API_CALL OrtSessionOptionsAppendExecutionProvider_DML(
 #endif
 
 // ─────────────────────────────────────────────────────────────────────────────
-// SeparateStems — public API
+// RunSeparateStems — inference on the selected backend
 // ─────────────────────────────────────────────────────────────────────────────
-bool SeparateStems(AudioManager* audio,
-                   const std::string& modelPath,
-                   StemOutput& out,
-                   const StemSeparatorOptions& opts,
-                   std::function<void(int pct)> progress,
-                   const std::atomic<bool>* cancel) {
+static bool RunSeparateStems(AudioManager* audio,
+                             const std::string& modelPath,
+                             StemOutput& out,
+                             const StemSeparatorOptions& opts,
+                             std::function<void(int pct)> progress,
+                             const std::atomic<bool>* cancel) {
     if (!audio || !audio->IsOk()) return false;
     if (modelPath.empty()) return false;
 
@@ -497,3 +499,46 @@ bool SeparateStems(AudioManager* audio,
     return false;
 #endif
 }
+
+// ─────────────────────────────────────────────────────────────────────────────
+// SeparateStems — public API
+// ─────────────────────────────────────────────────────────────────────────────
+// Separation takes minutes per track, so the result is kept in the
+// audio analysis cache. The key uses the model's file name rather than
+// its path so moving the model store doesn't throw the stems away.
+bool SeparateStems(AudioManager* audio,
+                   const std::string& modelPath,
+                   StemOutput& out,
+                   const StemSeparatorOptions& opts,
+                   std::function<void(int pct)> progress,
+                   const std::atomic<bool>* cancel) {
+    if (!audio || !audio->IsOk()) return false;
+    if (modelPath.empty()) return false;
+
+    const std::string params = "model=" + std::filesystem::path(modelPath).filename().string() +
+                               ",chunk=" + std::to_string(opts.chunkSamples) +
+                               ",overlap=" + std::to_string(opts.overlapSamples);
+    std::vector<float>* stems[] = { &out.drumsL, &out.drumsR, &out.bassL, &out.bassR,
+                                    &out.otherL, &out.otherR, &out.vocalsL, &out.vocalsR };
+    if (AudioAnalysisCache::Load(audio, "stems", params, [&](AudioAnalysisCache::Reader& r) {
+            r.Get(out.sampleRate);
+            for (auto* stem : stems) {
+                r.GetVector(*stem);
+            }
+            return r.IsOk();
+        })) {
+        if (progress) progress(100);
+        return true;
+    }
+
+    if (!RunSeparateStems(audio, modelPath, out, opts, progress, cancel)) {
+        return false;
+    }
+    AudioAnalysisCache::Store(audio, "stems", params, [&](AudioAnalysisCache::Writer& w) {
+        w.Add(out.sampleRate);
+        for (auto* stem : stems) {
+            w.AddVector(*stem);
+        }
+    });
+    return true;
+}
@@ -1,15 +1,19 @@
 #include "TempoDetector.h"
 
 #include "AudioManager.h"
+#include "AudioAnalysisCache.h"
 #include "OnsetDetector.h"
 
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <string>
 #include <vector>
 
-TempoResult DetectTempo(AudioManager* audio,
-                         const TempoDetectorOptions& opts) {
+namespace {
+
+TempoResult CalculateTempo(AudioManager* audio,
+                           const TempoDetectorOptions& opts) {
     TempoResult out;
     if (!audio || !audio->IsOk()) return out;
 
@@ -127,3 +131,32 @@ TempoResult DetectTempo(AudioManager* audio,
     }
     return out;
 }
+
+} // namespace
+
+TempoResult DetectTempo(AudioManager* audio,
+                         const TempoDetectorOptions& opts) {
+    TempoResult out;
+    if (!audio || !audio->IsOk()) return out;
+
+    const std::string params = "bpm=" + std::to_string(opts.minBPM) +
+                               "-" + std::to_string(opts.maxBPM);
+    if (AudioAnalysisCache::Load(audio, "tempo", params, [&out](AudioAnalysisCache::Reader& r) {
+            r.Get(out.bpm);
+            r.Get(out.confidence);
+            r.GetVector(out.beatMS);
+            return r.IsOk();
+        })) {
+        return out;
+    }
+
+    out = CalculateTempo(audio, opts);
+    if (out.bpm > 0) {
+        AudioAnalysisCache::Store(audio, "tempo", params, [&out](AudioAnalysisCache::Writer& w) {
+            w.Add(out.bpm);
+            w.Add(out.confidence);
+            w.AddVector(out.beatMS);
+        });
+    }
+    return out;
+}
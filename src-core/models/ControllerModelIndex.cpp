@@ -0,0 +1,104 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "ControllerModelIndex.h"
+#include "Model.h"
+#include "ModelManager.h"
+#include "OutputModelManager.h"
+#include "../outputs/Controller.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <log.h>
+
+void ControllerModelIndex::Invalidate() {
+    std::lock_guard<std::mutex> lock(_lock);
+    _valid = false;
+}
+
+bool ControllerModelIndex::IsCurrent() const {
+    if (!_valid || _modelGeneration != _modelManager.GetModelGeneration()) {
+        return false;
+    }
+    auto omm = _modelManager.GetOutputModelManager();
+    return omm == nullptr || _workGeneration == omm->GetControllerModelsGeneration();
+}
+
+void ControllerModelIndex::Build() {
+    auto start = std::chrono::steady_clock::now();
+
+    // read the generations first so a change made while we build forces another build
+    _modelGeneration = _modelManager.GetModelGeneration();
+    auto omm = _modelManager.GetOutputModelManager();
+    _workGeneration = omm == nullptr ? 0 : omm->GetControllerModelsGeneration();
+
+    _entries.clear();
+    for (const auto& it : _modelManager) {
+        Model* m = it.second;
+        if (m->GetDisplayAs() == DisplayAsType::ModelGroup) {
+            continue;
+        }
+        int32_t modelstart = m->GetNumberFromChannelString(m->ModelStartChannel);
+        int32_t modelend = modelstart + m->GetChanCount() - 1;
+        _entries.push_back({ m, modelstart, modelend });
+    }
+
+    _byStart.resize(_entries.size());
+    for (uint32_t i = 0; i < _byStart.size(); i++) {
+        _byStart[i] = i;
+    }
+    _byEnd = _byStart;
+    std::stable_sort(_byStart.begin(), _byStart.end(), [this](uint32_t a, uint32_t b) {
+        return _entries[a].startChannel < _entries[b].startChannel;
+    });
+    std::stable_sort(_byEnd.begin(), _byEnd.end(), [this](uint32_t a, uint32_t b) {
+        return _entries[a].endChannel < _entries[b].endChannel;
+    });
+    _valid = true;
+
+    spdlog::debug("ControllerModelIndex: Indexed {} models in {}ms.", _entries.size(),
+                  (long long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+std::vector<ControllerModelIndex::Entry> ControllerModelIndex::GetModels(const Controller* controller) {
+    const int32_t first = controller->GetStartChannel();
+    const int32_t last = controller->GetEndChannel();
+
+    std::lock_guard<std::mutex> lock(_lock);
+    if (!IsCurrent()) {
+        Build();
+    }
+
+    std::vector<uint32_t> found;
+    auto s = std::lower_bound(_byStart.begin(), _byStart.end(), first, [this](uint32_t i, int32_t ch) {
+        return _entries[i].startChannel < ch;
+    });
+    for (; s != _byStart.end() && _entries[*s].startChannel <= last; ++s) {
+        found.push_back(*s);
+    }
+    auto e = std::lower_bound(_byEnd.begin(), _byEnd.end(), first, [this](uint32_t i, int32_t ch) {
+        return _entries[i].endChannel < ch;
+    });
+    for (; e != _byEnd.end() && _entries[*e].endChannel <= last; ++e) {
+        found.push_back(*e);
+    }
+
+    // back into ModelManager order, a model that starts and ends on the controller was found twice
+    std::sort(found.begin(), found.end());
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+
+    std::vector<Entry> res;
+    res.reserve(found.size());
+    for (auto i : found) {
+        res.push_back(_entries[i]);
+    }
+    return res;
+}
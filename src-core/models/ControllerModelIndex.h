@@ -0,0 +1,66 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+// Which models sit on which controller, worked out in one pass over the
+// ModelManager and shared by every UDController. Without it each UDController
+// walks every model to find its own, which made opening the controller
+// visualiser or uploading to all controllers O(controllers x models).
+//
+// The index holds each model's channel range sorted by first and by last
+// channel, so a controller finds its models with two binary searches however
+// its channels are later renumbered. It is rebuilt on the next lookup after
+// the model set changes (ModelManager::GetModelGeneration), after work that
+// can move channels is queued or picked up (OutputModelManager::
+// GetControllerModelsGeneration) or after Invalidate.
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+class Controller;
+class Model;
+class ModelManager;
+
+class ControllerModelIndex
+{
+public:
+    struct Entry {
+        Model* model = nullptr;
+        int32_t startChannel = 0;
+        int32_t endChannel = 0;
+    };
+
+    explicit ControllerModelIndex(const ModelManager& modelManager) :
+        _modelManager(modelManager) {}
+    ControllerModelIndex(const ControllerModelIndex&) = delete;
+    ControllerModelIndex& operator=(const ControllerModelIndex&) = delete;
+
+    void Invalidate();
+
+    // models (not groups) whose first or last channel is on the controller, in ModelManager order
+    std::vector<Entry> GetModels(const Controller* controller);
+
+private:
+    bool IsCurrent() const;
+    void Build();
+
+    const ModelManager& _modelManager;
+
+    // everything below is protected by _lock
+    std::mutex _lock;
+    bool _valid = false;
+    unsigned int _modelGeneration = 0;
+    uint32_t _workGeneration = 0;
+    std::vector<Entry> _entries;   // in ModelManager order
+    std::vector<uint32_t> _byStart; // indexes into _entries sorted by start channel
+    std::vector<uint32_t> _byEnd;   // indexes into _entries sorted by end channel
+};
@@ -78,7 +78,8 @@ ModelManager::ModelManager(OutputManager* outputManager, RenderContext* rc) :
     _renderContext(rc),
     previewWidth(0),
     previewHeight(0),
-    _modelsLoading(false)
+    _modelsLoading(false),
+    _controllerModelIndex(*this)
 {
     // ctor
 }
@@ -205,6 +206,7 @@ bool ModelManager::Rename(const std::string& oldName, const std::string& newName
         }
         models.erase(models.find(on));
         models[nn] = model;
+        _controllerModelIndex.Invalidate();
 
         // go through all the model groups looking for things that might need to be renamed
         for (const auto& it : models) {
@@ -252,6 +254,7 @@ bool ModelManager::RenameInListOnly(const std::string& oldName, const std::strin
     std::lock_guard<std::recursive_mutex> lock(_modelMutex);
     models.erase(models.find(on));
     models[nn] = model;
+    _controllerModelIndex.Invalidate();
     return true;
 }
 
@@ -683,6 +686,7 @@ bool ModelManager::RecalcStartChannels() const
     }
 
     ResetModelGroups();
+    _controllerModelIndex.Invalidate();
 
     // Commenting out as this doesn't need to happen unless we have changes and when we do it is redundant as the only
     // current caller of this method, xLightsMain>>RecalcStartChannels, already adds RELOAD_MODELLIST work if changes exist
@@ -1123,6 +1127,7 @@ bool ModelManager::ReworkStartChannel() const
         }
     }
 
+    _controllerModelIndex.Invalidate();
     return outputsChanged;
 }
 
@@ -16,6 +16,7 @@
 #include <mutex>
 #include <atomic>
 
+#include "ControllerModelIndex.h"
 #include "ObjectManager.h"
 #include "ModelSetManager.h"
 #include <pugixml.hpp>
@@ -119,6 +120,9 @@ class ModelManager : public ObjectManager
         // parallel.
         unsigned int GetModelGeneration() const { return _modelGeneration.load(); }
 
+        // Which models are on each controller, see ControllerModelIndex.h.
+        ControllerModelIndex& GetControllerModelIndex() const { return _controllerModelIndex; }
+
         // Model Sets - persistent translation-only links between models.
         // See plans/layout-group-move-lock.md and ModelSetManager.h.
         ModelSetManager& GetSetManager() { return _setManager; }
@@ -137,5 +141,6 @@ class ModelManager : public ObjectManager
     std::atomic<unsigned int> _modelGeneration{ 0 };
     mutable std::string lastGeneratedModelName = "";
     ModelSetManager _setManager;
+    mutable ControllerModelIndex _controllerModelIndex;
 };
 
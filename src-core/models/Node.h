@@ -242,11 +242,20 @@ public:
     }
 
     virtual void SetColor(const xlColor& color) {
+        SetColorBase(color);
+    }
+
+    void SetColorBase(const xlColor& color) {
         c[0] = color.red;
         c[1] = color.green;
         c[2] = color.blue;
     }
 
+    // channel within the node that colour x (0=r,1=g,2=b) is written to, 255 for none
+    uint8_t GetChannelOffset(int x) const {
+        return offsets[x];
+    }
+
     // Non-virtual base implementations, callable directly by hot loops that
     // have proven (via exact typeid) the node is a plain NodeBaseClass -
     // skips the per-node indirect call in the seqData copy paths.
@@ -80,6 +80,7 @@ void OutputModelManager::SetSelectedControllerIfASAPWorkExists(const std::string
 
 void OutputModelManager::AddASAPWork(uint32_t work, const std::string& from, BaseObject* m, Controller* o, const std::string& selectedModel)
 {
+    NoteControllerModelsWork(work);
     if (_disableASAPWork) return;
 #ifdef _DEBUG
     _sourceASAP.push_back({ work, from });
@@ -114,6 +115,7 @@ void OutputModelManager::AddASAPWork(uint32_t work, const std::string& from, Bas
 
 void OutputModelManager::AddSetupTabWork(uint32_t work, const std::string& from, BaseObject* m, Controller* o, const std::string& selectedModel)
 {
+    NoteControllerModelsWork(work);
 #ifdef _DEBUG
     _sourceSetup.push_back({ work, from });
 #endif
@@ -136,6 +138,7 @@ void OutputModelManager::AddSetupTabWork(uint32_t work, const std::string& from,
 
 void OutputModelManager::AddLayoutTabWork(uint32_t work, const std::string& from, BaseObject* m, Controller* o, const std::string& selectedModel)
 {
+    NoteControllerModelsWork(work);
 #ifdef _DEBUG
     _sourceLayout.push_back({ work, from });
 #endif
@@ -195,7 +198,9 @@ void OutputModelManager::AddImmediateWork(uint32_t work, const std::string& from
 #else
     logger_work->debug("Doing Immediate Work.");
 #endif
+    NoteControllerModelsWork(work);
     if (_doImmediateWork) _doImmediateWork(work, "Immediate", m, selectedModel);
+    NoteControllerModelsWork(work);
 }
 
 void OutputModelManager::RemoveWork(const std::string& type, uint32_t toremove)
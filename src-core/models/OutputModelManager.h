@@ -10,6 +10,7 @@
  * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
  **************************************************************/
 
+#include <atomic>
 #include <list>
 #include <string>
 #include <cstdint>
@@ -31,6 +32,7 @@ class OutputModelManager {
     std::string _selectedController = "";
     bool _suspendedDeferredWork = false;
     bool _disableASAPWork = true;
+    std::atomic<uint32_t> _controllerModelsGeneration{ 0 };
 #ifdef _DEBUG
     std::list<std::pair<uint32_t, std::string>> _sourceASAP;
     std::list < std::pair<uint32_t, std::string>> _sourceLayout;
@@ -98,6 +100,13 @@ public:
     static const uint32_t WORK_NETWORK_SETTING_CHANGE =
         WORK_NETWORK_CHANGE | WORK_UPDATE_NETWORK_LIST;
 
+    // Work that can move a model's channels or change which models are on a controller
+    // Used by: ControllerModelIndex to know when to rebuild
+    static const uint32_t WORK_CONTROLLER_MODELS_CHANGE =
+        WORK_MODELS_REWORK_STARTCHANNELS | WORK_RELOAD_MODEL_FROM_XML | WORK_RELOAD_ALLMODELS |
+        WORK_MODELS_CHANGE_REQUIRING_RERENDER | WORK_CALCULATE_START_CHANNELS |
+        WORK_NETWORK_CHANNELSCHANGE | WORK_RESEND_CONTROLLER_CONFIG;
+
     OutputModelManager() {}
     void SetCallbacks(std::function<void()> scheduleASAPWork,
                       std::function<void(uint32_t, const std::string&, BaseObject*, const std::string&)> doImmediateWork)
@@ -121,6 +130,18 @@ public:
     {
         return (_workASAP & work) != 0;
     }
+    // Bumped both when such work is queued and when it is picked up to be done, so anything
+    // cached from the models before or while the work is done is rebuilt afterwards
+    uint32_t GetControllerModelsGeneration() const
+    {
+        return _controllerModelsGeneration.load();
+    }
+    void NoteControllerModelsWork(uint32_t work)
+    {
+        if (work & WORK_CONTROLLER_MODELS_CHANGE) {
+            _controllerModelsGeneration++;
+        }
+    }
     uint32_t GetASAPWork()
     {
         if (_suspendedDeferredWork) return WORK_NOTHING;
@@ -128,6 +149,7 @@ public:
         auto res = _workASAP;
         _workASAP = 0;
         _workRequested = false;
+        NoteControllerModelsWork(res);
 #ifdef _DEBUG
         Dump("ASAP", _sourceASAP);
         _sourceASAP.clear();
@@ -139,6 +161,7 @@ public:
         if (_suspendedDeferredWork) return WORK_NOTHING;
         auto res = _setupTabWork;
         _setupTabWork = 0;
+        NoteControllerModelsWork(res);
 #ifdef _DEBUG
         Dump("Setup", _sourceSetup);
         _sourceSetup.clear();
@@ -150,6 +173,7 @@ public:
         if (_suspendedDeferredWork) return WORK_NOTHING;
         auto res = _layoutTabWork;
         _layoutTabWork = 0;
+        NoteControllerModelsWork(res);
 #ifdef _DEBUG
         Dump("Layout", _sourceLayout);
         _sourceLayout.clear();
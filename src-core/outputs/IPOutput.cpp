@@ -10,6 +10,7 @@
  **************************************************************/
 
 #include "IPOutput.h"
+#include "SocketAbstraction.h"
 
 #ifdef _WIN32
 #include <winsock2.h>
@@ -23,7 +24,20 @@
 
 #include <log.h>
 
+thread_local sockets::UDPBatch* IPOutput::__transmitBatch = nullptr;
+thread_local uint32_t IPOutput::__directSends = 0;
+
 #pragma region Private Functions
+bool IPOutput::SendDatagram(sockets::UDPSocket* datagram, const std::string& remoteIp, uint16_t remotePort, const uint8_t* data, size_t length) {
+
+    if (datagram == nullptr) return false;
+    if (__transmitBatch != nullptr && __transmitBatch->Queue(*datagram, remoteIp, remotePort, data, length)) {
+        return true;
+    }
+    ++__directSends;
+    return datagram->SendTo(remoteIp, remotePort, data, length);
+}
+
 void IPOutput::SaveAttr(pugi::xml_node node) {
 
     if (_ip != "") {
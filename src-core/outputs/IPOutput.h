@@ -14,12 +14,24 @@
 
 #include "Output.h"
 
+namespace sockets {
+    class UDPSocket;
+    class UDPBatch;
+}
+
 class IPOutput : public Output
 {
+    // batch the current thread is collecting datagrams into, if any
+    static thread_local sockets::UDPBatch* __transmitBatch;
+    static thread_local uint32_t __directSends;
+
 protected:
 
     #pragma region Private Functions
     virtual void SaveAttr(pugi::xml_node node) override;
+
+    // send via the active transmit batch if there is one otherwise straight out of the socket
+    bool SendDatagram(sockets::UDPSocket* datagram, const std::string& remoteIp, uint16_t remotePort, const uint8_t* data, size_t length);
     #pragma endregion
 
 public:
@@ -34,6 +46,11 @@ public:
 
     #pragma region Static Functions
     static Output::PINGSTATE Ping(const std::string& ip, const std::string& proxy);
+
+    // while set, SendDatagram calls made on this thread are queued into the batch
+    static void SetTransmitBatch(sockets::UDPBatch* batch) { __transmitBatch = batch; }
+    // number of datagrams this thread has sent without a batch since the last call
+    static uint32_t TakeDirectSendCount() { auto c = __directSends; __directSends = 0; return c; }
     #pragma endregion 
 
     #pragma region Getters and Setters
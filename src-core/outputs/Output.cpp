@@ -55,7 +55,10 @@ void Output::SaveAttr(pugi::xml_node node) {
 #pragma endregion
 
 #pragma region Constructors and Destructors
+std::atomic<uint32_t> Output::__lifetimeGeneration{ 0 };
+
 Output::Output(const Output& from) {
+    ++__lifetimeGeneration;
     _ok = true;
     _dirty = from.IsDirty();
     _channels = from.GetChannels();
@@ -71,6 +74,7 @@ Output::Output(const Output& from) {
 }
 
 Output::Output(pugi::xml_node node) {
+    ++__lifetimeGeneration;
     _ok = true;
 
     _channels = node.attribute("MaxChannels").as_int(0);
@@ -86,12 +90,14 @@ Output::Output(pugi::xml_node node) {
 }
 
 Output::Output() {
+    ++__lifetimeGeneration;
     _dirty = true;
     _ok = true;
     _resolvedIp = "";
 }
 
 Output::~Output() {
+    ++__lifetimeGeneration;
     if (_fppProxyOutput != nullptr) {
         delete _fppProxyOutput;
     }
@@ -10,6 +10,7 @@
  * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
  **************************************************************/
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <list>
@@ -55,6 +56,11 @@ private:
     std::string _resolvedIp;
     mutable std::shared_mutex _resolveMutex;
 
+    // Bumped whenever any output is created or destroyed. Lets caches holding
+    // Output pointers (OutputManager's channel map) notice a controller
+    // rebuilding its outputs without every such path having to tell them.
+    static std::atomic<uint32_t> __lifetimeGeneration;
+
 protected:
 #pragma region Member Variables
     bool _dirty = false;
@@ -113,6 +119,7 @@ public:
     #pragma region Static Functions
     static Output* Create(Controller* c, pugi::xml_node node, std::string showDir);
     static std::list<ControllerEthernet*> Discover(OutputManager* outputManager) { return std::list<ControllerEthernet*>(); } // Discovers controllers supporting this protocol
+    static uint32_t GetLifetimeGeneration() { return __lifetimeGeneration.load(std::memory_order_acquire); }
     #pragma endregion Static Functions
 
     #pragma region Getters and Setters
@@ -23,6 +23,7 @@
 #include "DDPOutput.h"
 #include "xxxEthernetOutput.h"
 #include "OPCOutput.h"
+#include "SocketAbstraction.h"
 #include "TestPreset.h"
 #include "Parallel.h"
 #include "UtilFunctions.h"
@@ -30,6 +31,7 @@
 #include "utils/FileUtils.h"
 #include "utils/ip_utils.h"
 #include "render/UICallbacks.h"
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <spdlog/fmt/fmt.h>
@@ -148,6 +150,7 @@ void OutputManager::AsyncPingAll() {
 OutputManager::OutputManager() {
 
     _dirty = false;
+    _batchedTransmission = sockets::UDPBatch::IsNativelyBatched();
 }
 
 OutputManager::~OutputManager()
@@ -627,6 +630,7 @@ void OutputManager::AddController(Controller* controller, int pos)
         std::advance(it, pos);
         _controllers.insert(it, controller);
     }
+    InvalidateChannelMap();
     UpdateUnmanaged();
 }
 
@@ -639,11 +643,13 @@ void OutputManager::DeleteController(const std::string& controllerName) {
             break;
         }
     }
+    InvalidateChannelMap();
     UpdateUnmanaged();
 }
 
 void OutputManager::DeleteAllControllers() {
     ip_utils::waitForAllToResolve();
+    InvalidateChannelMap();
     while (_controllers.size() > 0) {
         delete _controllers.front();
         _controllers.pop_front();
@@ -824,14 +830,21 @@ Output* OutputManager::GetOutput_CONVERT(int outputNumber) const {
 // get an output based on an absolute channel number
 Output* OutputManager::GetOutput(int32_t absoluteChannel, int32_t& startChannel) const {
 
-    auto outputs = GetAllOutputs();
-    for (const auto& it : outputs) {
-        if (absoluteChannel >= it->GetStartChannel() && absoluteChannel <= it->GetEndChannel()) {
-            startChannel = absoluteChannel - it->GetStartChannel() + 1;
-            return it;
-        }
+    auto map = GetChannelMap();
+    const int32_t ch = absoluteChannel - 1;
+    // first range ending after ch ... ranges never overlap so ends are sorted too
+    auto it = std::upper_bound(map->begin(), map->end(), ch, [](int32_t c, const ChannelRange& r) {
+        return c < r.startChannel + r.channels;
+    });
+    if (it == map->end() || ch < it->startChannel) {
+        return nullptr;
     }
-    return nullptr;
+    if (!IsChannelRangeCurrent(*it)) {
+        InvalidateChannelMap();
+        return GetOutput(absoluteChannel, startChannel);
+    }
+    startChannel = ch - it->startChannel + 1;
+    return it->output;
 }
 
 // get an output based on a universe/id number
@@ -862,6 +875,40 @@ Output* OutputManager::GetOutput(int universe, const std::string& ip) const {
 #pragma endregion
 
 #pragma region Channel Mapping
+void OutputManager::InvalidateChannelMap() const {
+    std::lock_guard<std::mutex> lock(_channelMapLock);
+    _channelMap.reset();
+}
+
+// Readers take a reference to the current map so a rebuild on another thread
+// never frees it under them.
+std::shared_ptr<const OutputManager::ChannelMap> OutputManager::GetChannelMap() const {
+    std::lock_guard<std::mutex> lock(_channelMapLock);
+    const uint32_t gen = Output::GetLifetimeGeneration();
+    if (_channelMap == nullptr || _channelMapGeneration != gen) {
+        auto map = std::make_shared<ChannelMap>();
+        for (const auto& c : _controllers) {
+            for (const auto& o : c->GetOutputs()) {
+                if (o->GetChannels() > 0 && o->GetStartChannel() > 0) {
+                    map->push_back({ o->GetStartChannel() - 1, o->GetChannels(), o });
+                }
+            }
+        }
+        std::stable_sort(map->begin(), map->end(), [](const ChannelRange& a, const ChannelRange& b) {
+            return a.startChannel < b.startChannel;
+        });
+        _channelMap = std::move(map);
+        _channelMapGeneration = gen;
+    }
+    return _channelMap;
+}
+
+// True if the output still sits where the map thinks it does. Catches channel
+// count edits that have not been followed by SomethingChanged yet.
+bool OutputManager::IsChannelRangeCurrent(const ChannelRange& r) {
+    return r.output->GetStartChannel() - 1 == r.startChannel && r.output->GetChannels() == r.channels;
+}
+
 int32_t OutputManager::GetTotalChannels() const
 {
     if (_controllers.size() == 0)
@@ -1150,6 +1197,7 @@ void OutputManager::SomethingChanged() const {
     for (auto& it : _controllers) {
         it->SetTransientData(start, nullcnt);
     }
+    InvalidateChannelMap();
 }
 
 bool OutputManager::IsDirty() const {
@@ -1292,6 +1340,8 @@ void OutputManager::StopOutput() {
     for (const auto& it : GetAllOutputs()) {
         it->Close();
     }
+    // the shared sockets are bound to the force local ips in use at the time
+    _transmitBatch.reset();
 
     _outputCriticalSection.unlock();
 }
@@ -1342,18 +1392,42 @@ void OutputManager::EndFrame() {
     if (!_outputting) return;
     if (!_outputCriticalSection.try_lock()) return;
 
+    auto start = std::chrono::steady_clock::now();
     auto outputs = GetAllOutputs();
-    if (_parallelTransmission) {
+    TransmitStats stats;
+    if (_batchedTransmission) {
+        // queuing is just a copy so there is nothing to gain from fanning out across threads
+        if (_transmitBatch == nullptr) {
+            _transmitBatch = std::make_unique<sockets::UDPBatch>();
+        }
+        IPOutput::TakeDirectSendCount();
+        IPOutput::SetTransmitBatch(_transmitBatch.get());
+        for (const auto& it : outputs) {
+            it->EndFrame(_suppressFrames);
+        }
+        IPOutput::SetTransmitBatch(nullptr);
+        stats.datagrams = _transmitBatch->GetQueuedCount();
+        stats.syscalls = _transmitBatch->Flush();
+        auto direct = IPOutput::TakeDirectSendCount();
+        stats.datagrams += direct;
+        stats.syscalls += direct;
+    }
+    else if (_parallelTransmission) {
         std::function<void(Output*&, int)> f = [this](Output*&o, int n) {
             o->EndFrame(_suppressFrames);
         };
         parallel_for(outputs, f);
     }
     else {
+        IPOutput::TakeDirectSendCount();
         for (const auto& it : outputs) {
             it->EndFrame(_suppressFrames);
         }
+        stats.datagrams = stats.syscalls = IPOutput::TakeDirectSendCount();
     }
+    stats.transmitNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    _lastTransmitStats = stats;
+    spdlog::trace("Output frame: {} datagrams, {} send calls, {}us.", stats.datagrams, stats.syscalls, stats.transmitNs / 1000);
 
     if (IsSyncEnabled()) {
         if (_syncUniverse != 0) {
@@ -1407,36 +1481,39 @@ void OutputManager::SetManyChannels(int32_t channel, unsigned char* data, size_t
 
     if (size == 0) return;
 
-    int32_t stch;
-    Output* o = GetOutput(channel + 1, stch);
-
-    // if this doesnt map to an output then skip it
-    if (o == nullptr) return;
-
-    // get an iterator to the output which contains our first channel
-    auto outputs = GetAllOutputs();
-    auto it = outputs.begin();
-    while (it != outputs.end() && *it != o) ++it;
-    if (it == outputs.end()) return;
-
-    size_t left = size;
-    while (left > 0 && o != nullptr) {
-        assert(!o->IsOutputCollection_CONVERT());
-        size_t mx = o->GetChannels() - stch + 1;
-        size_t send = std::min(left, mx);
-        if (o->IsEnabled()) {
-            o->SetManyChannels(stch - 1, &data[size - left], send);
+    auto map = GetChannelMap();
+    const int64_t end = (int64_t)channel + size;
+    auto it = std::upper_bound(map->begin(), map->end(), channel, [](int32_t c, const ChannelRange& r) {
+        return c < r.startChannel + r.channels;
+    });
+    for (; it != map->end() && it->startChannel < end; ++it) {
+        if (!IsChannelRangeCurrent(*it)) {
+            // an output was resized/moved without telling us ... rebuild and redo the lot
+            InvalidateChannelMap();
+            SetManyChannels(channel, data, size);
+            return;
         }
-        stch = 1;
-        left -= send;
+        const int64_t lo = std::max((int64_t)channel, (int64_t)it->startChannel);
+        const int64_t hi = std::min(end, (int64_t)it->startChannel + it->channels);
+        assert(!it->output->IsOutputCollection_CONVERT());
+        if (it->output->IsEnabled()) {
+            it->output->SetManyChannels((int32_t)(lo - it->startChannel), &data[lo - channel], (size_t)(hi - lo));
+        }
+    }
+}
 
-        // Move to the next output
-        ++it;
-        if (it == outputs.end()) {
-            o = nullptr;
+void OutputManager::SetFrame(unsigned char* data, size_t size) {
+
+    auto map = GetChannelMap();
+    for (const auto& r : *map) {
+        if ((size_t)r.startChannel >= size) break;
+        if (!IsChannelRangeCurrent(r)) {
+            InvalidateChannelMap();
+            SetFrame(data, size);
+            return;
         }
-        else {
-            o = *it;
+        if (r.output->IsEnabled()) {
+            r.output->SetManyChannels(0, &data[r.startChannel], std::min((size_t)r.channels, size - r.startChannel));
         }
     }
 }
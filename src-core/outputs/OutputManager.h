@@ -15,6 +15,7 @@
 #include <functional>
 #include <list>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -24,6 +25,7 @@ class Controller;
 class TestPreset;
 class UICallbacks;
 class ControllerEthernet;
+namespace sockets { class UDPBatch; }
 
 #define NETWORKSFILE "xlights_networks.xml";
 
@@ -51,6 +53,35 @@ class OutputManager
     // form of `_baseShowDir` so the base-folder link survives
     // moving the show between machines (e.g. desktop ↔ iPad).
     std::string _showDir = "";
+
+    // Flat channel -> output dispatch table for the per-frame data setters.
+    // One entry per output with channels, sorted by start channel, so a frame
+    // scatter is a linear walk and a single channel a binary search. Rebuilt
+    // lazily after SomethingChanged / controller add, delete or move, or when
+    // any Output is created or destroyed (Output::GetLifetimeGeneration).
+    struct ChannelRange {
+        int32_t startChannel; // zero based absolute channel
+        int32_t channels;
+        Output* output;
+    };
+    using ChannelMap = std::vector<ChannelRange>;
+    mutable std::mutex _channelMapLock;
+    mutable std::shared_ptr<const ChannelMap> _channelMap;
+    mutable uint32_t _channelMapGeneration = 0;
+
+public:
+    // What the last EndFrame cost to put on the wire
+    struct TransmitStats {
+        uint32_t datagrams = 0; // IP datagrams sent
+        uint32_t syscalls = 0;  // send calls made for them
+        uint64_t transmitNs = 0; // EndFrame time excluding sync packets
+    };
+private:
+    // Per frame E1.31 / ArtNet / DDP datagrams are queued here and flushed together
+    // (sendmmsg on Linux) rather than sent one syscall each
+    bool _batchedTransmission = false;
+    std::unique_ptr<sockets::UDPBatch> _transmitBatch;
+    TransmitStats _lastTransmitStats;
     #pragma endregion
 
     #pragma region Static Variables
@@ -68,6 +99,9 @@ class OutputManager
     #pragma region Private Functions
     bool ConvertStartChannel(const std::string sc, std::string& newsc) const;
     void AsyncPingAll();
+    void InvalidateChannelMap() const;
+    std::shared_ptr<const ChannelMap> GetChannelMap() const;
+    static bool IsChannelRangeCurrent(const ChannelRange& r);
     #pragma endregion 
 
 public:
@@ -192,6 +226,11 @@ public:
     
     void SetParallelTransmission(bool parallel) { _parallelTransmission = parallel; }
     bool GetParallelTransmission() const { return _parallelTransmission; }
+
+    // on by default where the OS can send a batch in one call; takes precedence over parallel transmission
+    void SetBatchedTransmission(bool batched) { _batchedTransmission = batched; }
+    bool GetBatchedTransmission() const { return _batchedTransmission; }
+    const TransmitStats& GetLastTransmitStats() const { return _lastTransmitStats; }
     
     int GetPacketsPerSecond() const;
     
@@ -248,6 +287,9 @@ public:
     #pragma region Data Setting
     void SetOneChannel(int32_t channel, unsigned char data);
     void SetManyChannels(int32_t channel, unsigned char* data, size_t size);
+    // Scatter a whole frame (channel 0 onwards, e.g. a SequenceData frame) to
+    // every output in one walk of the channel map.
+    void SetFrame(unsigned char* data, size_t size);
     void AllOff(bool send = true);
     #pragma endregion 
 
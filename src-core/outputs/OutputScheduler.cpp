@@ -0,0 +1,215 @@
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "OutputScheduler.h"
+#include "OutputManager.h"
+#include "render/SequenceData.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <log.h>
+
+// how long the UI can go without reporting the play position before we stop sending
+static constexpr auto WATCHDOG_PERIOD = std::chrono::milliseconds(500);
+// the last part of the wait before a frame is spun rather than slept as sleeps overshoot
+static constexpr auto SPIN_PERIOD = std::chrono::microseconds(1000);
+
+#pragma region Constructors and Destructors
+OutputScheduler::OutputScheduler(OutputManager* outputManager) :
+    _outputManager(outputManager) {
+}
+
+OutputScheduler::~OutputScheduler() {
+    Stop();
+}
+#pragma endregion
+
+#pragma region Start and Stop
+void OutputScheduler::Play(SequenceData* data, long ms) {
+
+    if (data == nullptr || data->FrameTime() == 0) {
+        Stop();
+        return;
+    }
+
+    auto now = clock::now();
+    bool seek = false;
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        if (data != _data || now - _lastReport > WATCHDOG_PERIOD) {
+            seek = true;
+        } else {
+            // only move the anchor if the UI's idea of the position has drifted, it is
+            // sampled whenever the UI gets around to it so is noisier than our clock
+            long expected = _anchorMS + (long)std::chrono::duration_cast<std::chrono::milliseconds>(now - _anchorTime).count();
+            long drift = std::labs(expected - ms);
+            if (drift > 2 * (long)data->FrameTime()) {
+                seek = true;
+            }
+            if (drift * 2 <= (long)data->FrameTime()) {
+                _lastReport = now;
+                return;
+            }
+        }
+        _data = data;
+        _anchorMS = ms;
+        _anchorTime = now;
+        _lastReport = now;
+        _seek = _seek || seek;
+    }
+    if (seek) {
+        _signal.notify_all();
+    }
+
+    if (!_running) {
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+        _stop = false;
+        _running = true;
+        _thread = std::thread(&OutputScheduler::Run, this);
+    }
+}
+
+void OutputScheduler::Stop() {
+
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        _stop = true;
+        _data = nullptr;
+    }
+    _signal.notify_all();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    _running = false;
+}
+#pragma endregion
+
+#pragma region Statistics
+OutputScheduler::Stats OutputScheduler::GetStats() const {
+    std::unique_lock<std::mutex> lock(_statsLock);
+    return _stats;
+}
+
+void OutputScheduler::ResetStats() {
+    std::unique_lock<std::mutex> lock(_statsLock);
+    _stats = Stats();
+}
+
+void OutputScheduler::RecordFrame(int64_t latenessUS, uint64_t dropped) {
+
+    size_t bucket = 0;
+    while (bucket < LATENESS_BUCKETS_US.size() && latenessUS >= LATENESS_BUCKETS_US[bucket]) {
+        ++bucket;
+    }
+
+    std::unique_lock<std::mutex> lock(_statsLock);
+    ++_stats.framesSent;
+    _stats.framesDropped += dropped;
+    ++_stats.latenessHistogram[bucket];
+    if (latenessUS > _stats.maxLatenessUS) {
+        _stats.maxLatenessUS = latenessUS;
+    }
+}
+#pragma endregion
+
+#pragma region Private Functions
+void OutputScheduler::RaiseThreadPriority() {
+
+#ifdef _WIN32
+    if (!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL)) {
+        spdlog::debug("OutputScheduler: Unable to raise output thread priority {}.", (int)GetLastError());
+    }
+#elif defined(__APPLE__)
+    pthread_set_qos_class_self_np(QOS_CLASS_USER_INTERACTIVE, 0);
+#else
+    // real time scheduling usually needs CAP_SYS_NICE, without it we just run at normal priority
+    sched_param param{};
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 10;
+    int res = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (res != 0) {
+        spdlog::debug("OutputScheduler: Unable to use real time scheduling for output thread {}.", res);
+    }
+#endif
+}
+
+void OutputScheduler::SendFrame(SequenceData* data, unsigned int frame, long ms) {
+
+    _outputManager->StartFrame(ms);
+    _outputManager->SetFrame(&(*data)[frame][0], data->NumChannels());
+    _outputManager->EndFrame();
+}
+
+void OutputScheduler::Run() {
+
+    spdlog::debug("OutputScheduler: Output thread started.");
+    RaiseThreadPriority();
+
+    int64_t lastSent = -1;
+    std::unique_lock<std::mutex> lock(_lock);
+    while (!_stop) {
+        if (_data == nullptr || clock::now() - _lastReport > WATCHDOG_PERIOD) {
+            // nobody is telling us where playback is so there is nothing sensible to send
+            _signal.wait_for(lock, std::chrono::milliseconds(50));
+            _seek = true;
+            continue;
+        }
+
+        const int64_t frameMS = _data->FrameTime();
+        if (_seek) {
+            int64_t pos = _anchorMS + std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - _anchorTime).count();
+            lastSent = pos / frameMS - 1;
+            _seek = false;
+        }
+
+        const int64_t target = lastSent + 1;
+        const auto deadline = _anchorTime + std::chrono::milliseconds(target * frameMS - _anchorMS);
+        if (_signal.wait_until(lock, deadline - SPIN_PERIOD, [this] { return _stop || _seek; })) {
+            continue;
+        }
+        lock.unlock();
+        while (clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        lock.lock();
+        if (_stop || _seek || _data == nullptr) {
+            continue;
+        }
+
+        auto now = clock::now();
+        int64_t pos = _anchorMS + std::chrono::duration_cast<std::chrono::milliseconds>(now - _anchorTime).count();
+        int64_t frame = std::max(target, pos / frameMS);
+        lastSent = frame;
+        if (frame >= (int64_t)_data->NumFrames()) {
+            // past the end, the UI will stop or loop us
+            continue;
+        }
+
+        int64_t latenessUS = std::chrono::duration_cast<std::chrono::microseconds>(now - deadline).count();
+        // Stop joins us before the data can go away so it is safe to use unlocked
+        SequenceData* data = _data;
+        lock.unlock();
+        SendFrame(data, (unsigned int)frame, (long)(frame * frameMS));
+        RecordFrame(latenessUS, (uint64_t)(frame - target));
+        lock.lock();
+    }
+    spdlog::debug("OutputScheduler: Output thread stopped.");
+}
+#pragma endregion
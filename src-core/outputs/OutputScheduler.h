@@ -0,0 +1,86 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+class OutputManager;
+class SequenceData;
+
+// Sends sequence frames to the OutputManager from its own high priority thread.
+//
+// The UI tells the scheduler where playback is (Play) each time it ticks and the
+// scheduler extrapolates from that anchor against a monotonic clock, sending each
+// frame on its frame boundary. This keeps packet timing independent of how busy
+// the UI thread is. If the UI stops reporting for longer than the watchdog period
+// the scheduler stops sending until it is told the position again.
+class OutputScheduler
+{
+public:
+    // upper bound (in microseconds) of each lateness histogram bucket, the last bucket is open ended
+    static constexpr std::array<int64_t, 8> LATENESS_BUCKETS_US = { 100, 250, 500, 1000, 2000, 5000, 10000, 20000 };
+
+    struct Stats {
+        uint64_t framesSent = 0;
+        uint64_t framesDropped = 0; // frames whose slot passed before we could send them
+        int64_t maxLatenessUS = 0;
+        std::array<uint64_t, LATENESS_BUCKETS_US.size() + 1> latenessHistogram = {};
+    };
+
+    #pragma region Constructors and Destructors
+    explicit OutputScheduler(OutputManager* outputManager);
+    virtual ~OutputScheduler();
+    #pragma endregion
+
+    #pragma region Start and Stop
+    // report that playback of data is at ms, starting the thread if it is not running
+    void Play(SequenceData* data, long ms);
+    // stop sending and join the thread, must be called before the sequence data is reallocated
+    void Stop();
+    bool IsRunning() const { return _running; }
+    #pragma endregion
+
+    #pragma region Statistics
+    Stats GetStats() const;
+    void ResetStats();
+    #pragma endregion
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    void Run();
+    void SendFrame(SequenceData* data, unsigned int frame, long ms);
+    void RecordFrame(int64_t latenessUS, uint64_t dropped);
+    static void RaiseThreadPriority();
+
+    OutputManager* _outputManager = nullptr;
+    std::thread _thread;
+    std::atomic<bool> _running{ false };
+
+    // everything below is protected by _lock
+    mutable std::mutex _lock;
+    std::condition_variable _signal;
+    bool _stop = false;
+    SequenceData* _data = nullptr;
+    long _anchorMS = 0;
+    clock::time_point _anchorTime;
+    clock::time_point _lastReport;
+    bool _seek = true;
+
+    mutable std::mutex _statsLock;
+    Stats _stats;
+};
@@ -10,12 +10,15 @@
  * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
  **************************************************************/
 
+#include <algorithm>
 #include <array>
 #include <cerrno>
 #include <cstdint>
 #include <cstring>
+#include <memory>
 #include <string>
 #include <chrono>
+#include <vector>
 
 #ifdef _WIN32
 #include <winsock2.h>
@@ -29,6 +32,10 @@
 #include <unistd.h>
 #endif
 
+#ifdef __linux__
+#include <sys/uio.h>
+#endif
+
 namespace sockets {
 
 #ifdef _WIN32
@@ -395,10 +402,19 @@ public:
             return false;
         }
 
+        _localIp = localIp;
+        _localPort = localPort;
+        _reuseAddr = reuseAddr;
         _lastError.clear();
         return true;
     }
 
+    // what the socket was bound with, so a UDPBatch can send from an equivalent socket
+    const std::string& LocalIP() const { return _localIp; }
+    uint16_t LocalPort() const { return _localPort; }
+    bool ReuseAddr() const { return _reuseAddr; }
+    SocketHandle Handle() const { return _socket; }
+
     bool SendTo(const std::string& remoteIp, uint16_t remotePort, const uint8_t* data, size_t length)
     {
         if (_socket == INVALID_SOCKET_HANDLE || data == nullptr || length == 0) {
@@ -545,6 +561,169 @@ public:
 private:
     SocketHandle _socket = INVALID_SOCKET_HANDLE;
     std::string _lastError;
+    std::string _localIp;
+    uint16_t _localPort = 0;
+    bool _reuseAddr = false;
+};
+
+// Collects the datagrams produced during one output frame and hands them to the
+// kernel together. Datagrams are grouped by the local address their output socket
+// was bound to and each group goes out through one shared socket, so on Linux a
+// frame costs one sendmmsg per local address rather than one sendto per universe.
+// Elsewhere Flush falls back to a sendto per datagram.
+class UDPBatch {
+public:
+    UDPBatch() = default;
+    UDPBatch(const UDPBatch&) = delete;
+    UDPBatch& operator=(const UDPBatch&) = delete;
+
+    static constexpr bool IsNativelyBatched()
+    {
+#ifdef __linux__
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Copies the datagram so the caller can reuse its buffer immediately.
+    // Returns false if the datagram could not be queued and should be sent directly.
+    bool Queue(const UDPSocket& from, const std::string& remoteIp, uint16_t remotePort, const uint8_t* data, size_t length)
+    {
+        if (data == nullptr || length == 0) {
+            return false;
+        }
+
+        Pending p;
+        p.remoteAddr.sin_family = AF_INET;
+        p.remoteAddr.sin_port = htons(remotePort);
+        if (!parseIPv4(remoteIp, p.remoteAddr.sin_addr)) {
+            return false;
+        }
+
+        Group* group = GetGroup(from);
+        if (group == nullptr) {
+            return false;
+        }
+
+        p.offset = _buffer.size();
+        p.length = length;
+        _buffer.insert(_buffer.end(), data, data + length);
+        group->pending.push_back(p);
+        ++_queued;
+        return true;
+    }
+
+    // Sends everything queued since the last flush. Returns the number of send syscalls made.
+    uint32_t Flush()
+    {
+        uint32_t syscalls = 0;
+        for (auto& g : _groups) {
+            if (g.pending.empty()) continue;
+#ifdef __linux__
+            syscalls += FlushGroup(g);
+#else
+            for (const auto& p : g.pending) {
+                sendto(g.socket->Handle(), reinterpret_cast<const char*>(_buffer.data() + p.offset), static_cast<int>(p.length), 0,
+                       reinterpret_cast<const sockaddr*>(&p.remoteAddr), sizeof(p.remoteAddr));
+                ++syscalls;
+            }
+#endif
+            g.pending.clear();
+        }
+        _buffer.clear();
+        _queued = 0;
+        return syscalls;
+    }
+
+    uint32_t GetQueuedCount() const { return _queued; }
+
+    // drops the shared sockets, eg when the output configuration changes
+    void Reset()
+    {
+        _groups.clear();
+        _buffer.clear();
+        _queued = 0;
+    }
+
+private:
+    struct Pending {
+        sockaddr_in remoteAddr{};
+        size_t offset = 0;
+        size_t length = 0;
+    };
+
+    struct Group {
+        std::string localIp;
+        uint16_t localPort = 0;
+        std::unique_ptr<UDPSocket> socket;
+        std::vector<Pending> pending;
+    };
+
+    Group* GetGroup(const UDPSocket& from)
+    {
+        for (auto& g : _groups) {
+            if (g.localIp == from.LocalIP() && g.localPort == from.LocalPort()) {
+                return g.socket == nullptr ? nullptr : &g;
+            }
+        }
+
+        // remember failures too so we dont retry the bind every frame
+        Group g;
+        g.localIp = from.LocalIP();
+        g.localPort = from.LocalPort();
+        g.socket = std::make_unique<UDPSocket>();
+        if (!g.socket->Bind(g.localIp, g.localPort, g.localPort != 0 || from.ReuseAddr())) {
+            g.socket.reset();
+        }
+        _groups.push_back(std::move(g));
+        return _groups.back().socket == nullptr ? nullptr : &_groups.back();
+    }
+
+#ifdef __linux__
+    uint32_t FlushGroup(Group& g)
+    {
+        // UIO_MAXIOV is the most the kernel will take in one call
+        constexpr size_t MAX_BATCH = 1024;
+        const size_t count = g.pending.size();
+        _iov.resize(count);
+        _msgs.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto& p = g.pending[i];
+            _iov[i].iov_base = _buffer.data() + p.offset;
+            _iov[i].iov_len = p.length;
+            auto& m = _msgs[i];
+            memset(&m, 0, sizeof(m));
+            m.msg_hdr.msg_name = &p.remoteAddr;
+            m.msg_hdr.msg_namelen = sizeof(p.remoteAddr);
+            m.msg_hdr.msg_iov = &_iov[i];
+            m.msg_hdr.msg_iovlen = 1;
+        }
+
+        uint32_t syscalls = 0;
+        size_t sent = 0;
+        while (sent < count) {
+            const unsigned int n = static_cast<unsigned int>(std::min(count - sent, MAX_BATCH));
+            const int r = sendmmsg(g.socket->Handle(), &_msgs[sent], n, 0);
+            ++syscalls;
+            if (r <= 0) {
+                if (r < 0 && errno == EINTR) continue;
+                // the first datagram failed, skip it like a failed sendto would and carry on
+                ++sent;
+            } else {
+                sent += static_cast<size_t>(r);
+            }
+        }
+        return syscalls;
+    }
+
+    std::vector<iovec> _iov;
+    std::vector<mmsghdr> _msgs;
+#endif
+
+    std::vector<Group> _groups;
+    std::vector<uint8_t> _buffer;
+    uint32_t _queued = 0;
 };
 
 } // namespace sockets
@@ -264,7 +264,9 @@ Effect::~Effect()
         }
     }
     if (mCache) {
-        mCache->Delete();
+        // the cached frames may be shared and stay valid for any effect with the same settings,
+        // RenderCache::CleanupCache removes them once nothing in the sequence matches
+        mCache->Release(false);
         mCache = nullptr;
     }
     if (mName != nullptr)
@@ -377,6 +379,8 @@ void Effect::SetStartTimeMS(int startTimeMS)
     if (startTimeMS > mStartTime) {
         IncrementChangeCount();
         mStartTime = startTimeMS;
+        // the change count above went out before the move landed
+        mParentLayer->InvalidateTimeIndex();
     } else {
         mStartTime = startTimeMS;
         IncrementChangeCount();
@@ -390,6 +394,7 @@ void Effect::SetEndTimeMS(int endTimeMS)
     if (endTimeMS < mEndTime) {
         IncrementChangeCount();
         mEndTime = endTimeMS;
+        mParentLayer->InvalidateTimeIndex();
     } else {
         mEndTime = endTimeMS;
         IncrementChangeCount();
@@ -496,7 +501,8 @@ void Effect::IncrementChangeCount()
     {
         std::unique_lock<std::recursive_mutex> lock(settingsLock);
         if (mCache) {
-            mCache->Delete();
+            // look the cache up again next render as the changed effect may no longer match
+            mCache->Release(false);
             mCache = nullptr;
         }
     }
@@ -925,10 +931,10 @@ bool operator<(const Effect &e1, const Effect &e2)
     return false;
 }
 
-bool Effect::GetFrame(RenderBuffer &buffer, RenderCache &renderCache) {
+bool Effect::GetFrame(RenderBuffer &buffer, RenderCache &renderCache, bool timeDependent, bool modelDependent) {
     std::unique_lock<std::recursive_mutex> lock(settingsLock);
     if (mCache == nullptr) {
-        mCache = renderCache.GetItem(this, &buffer);
+        mCache = renderCache.GetItem(this, &buffer, timeDependent, modelDependent);
     }
     return mCache && mCache->GetFrame(&buffer);
 }
@@ -943,11 +949,7 @@ void Effect::AddFrame(RenderBuffer &buffer, RenderCache &renderCache) {
 void Effect::PurgeCache(bool deleteCache) {
     std::unique_lock<std::recursive_mutex> lock(settingsLock);
     if (mCache) {
-        // Even though delete also calls PurgeFrames we have to call this here otherwise delete removes the cache files
-        if (!deleteCache) {
-            mCache->PurgeFrames();
-        }
-        mCache->Delete();
+        mCache->Release(deleteCache);
         mCache = nullptr;
     }
 }
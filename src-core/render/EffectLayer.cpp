@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <climits>
 #include <thread>
 #include <vector>
 
@@ -83,6 +84,10 @@ Effect* EffectLayer::GetEffect(int index) const
 }
 
 Effect* EffectLayer::GetEffectByTime(int timeMS) {
+    auto idx = GetTimeIndex();
+    if (idx != nullptr) {
+        return FindEffectAtTime(*idx, timeMS, "", false);
+    }
     std::unique_lock<std::recursive_mutex> locker(acquireLockWaitForRender());
     for(const auto& it : mEffects) {
         if (timeMS >= it->GetStartTimeMS() &&
@@ -244,6 +249,64 @@ void EffectLayer::SortEffects()
 {
     std::sort(mEffects.begin(), mEffects.end(), SortEffectByStartTime);
     NumberEffects();
+    InvalidateTimeIndex();
+}
+
+void EffectLayer::InvalidateTimeIndex()
+{
+    std::unique_lock<std::mutex> indexLocker(timeIndexLock);
+    ++timeIndexGen;
+    timeIndex.reset();
+}
+
+std::shared_ptr<const EffectLayer::TimeIndex> EffectLayer::GetTimeIndex() const
+{
+    {
+        std::unique_lock<std::mutex> indexLocker(timeIndexLock);
+        if (timeIndex != nullptr) {
+            return timeIndex;
+        }
+    }
+    // Building reads mEffects so needs the layer lock, but a lookup must never
+    // block on (or deadlock against) an edit or render holding it - callers
+    // fall back to scanning when it is busy.
+    std::unique_lock<std::recursive_mutex> locker(lock, std::try_to_lock);
+    if (!locker.owns_lock()) {
+        return nullptr;
+    }
+    uint32_t gen = timeIndexGen;
+
+    std::vector<Effect*> sorted(mEffects);
+    std::stable_sort(sorted.begin(), sorted.end(), SortEffectByStartTime);
+    auto idx = std::make_shared<TimeIndex>();
+    idx->effects = std::move(sorted);
+    idx->starts.reserve(idx->effects.size());
+    idx->ends.reserve(idx->effects.size());
+    idx->maxEnds.reserve(idx->effects.size());
+    int maxEnd = INT_MIN;
+    for (const auto& e : idx->effects) {
+        idx->starts.push_back(e->GetStartTimeMS());
+        idx->ends.push_back(e->GetEndTimeMS());
+        maxEnd = std::max(maxEnd, idx->ends.back());
+        idx->maxEnds.push_back(maxEnd);
+    }
+
+    std::unique_lock<std::mutex> indexLocker(timeIndexLock);
+    if (gen == timeIndexGen) {
+        timeIndex = idx;
+    }
+    return idx;
+}
+
+Effect* EffectLayer::FindEffectAtTime(const TimeIndex& idx, int timeMS, const std::string& filterText, bool isFilterTextRegex)
+{
+    size_t i = std::lower_bound(idx.maxEnds.begin(), idx.maxEnds.end(), timeMS) - idx.maxEnds.begin();
+    for (; i < idx.starts.size() && idx.starts[i] <= timeMS; ++i) {
+        if (idx.ends[i] >= timeMS && idx.effects[i]->FilteredIn(filterText, isFilterTextRegex)) {
+            return idx.effects[i];
+        }
+    }
+    return nullptr;
 }
 
 bool EffectLayer::IsStartTimeLinked(int index) const
@@ -364,6 +427,10 @@ Effect* EffectLayer::GetEffectAfterTime(int ms, const std::string& filterText, b
 }
 
 Effect* EffectLayer::GetEffectAtTime(int timeMS, const std::string& filterText, bool isFilterTextRegex) const {
+    auto idx = GetTimeIndex();
+    if (idx != nullptr) {
+        return FindEffectAtTime(*idx, timeMS, filterText, isFilterTextRegex);
+    }
     for (int i = 0; i < (int)mEffects.size(); ++i) {
         if (timeMS >= mEffects[i]->GetStartTimeMS() &&
             timeMS <= mEffects[i]->GetEndTimeMS() && mEffects[i]->FilteredIn(filterText, isFilterTextRegex)) {
@@ -374,6 +441,16 @@ Effect* EffectLayer::GetEffectAtTime(int timeMS, const std::string& filterText,
 }
 
 Effect* EffectLayer::GetEffectStartingAtTime(int timeMS, const std::string& filterText, bool isFilterTextRegex) const {
+    auto idx = GetTimeIndex();
+    if (idx != nullptr) {
+        size_t i = std::lower_bound(idx->starts.begin(), idx->starts.end(), timeMS) - idx->starts.begin();
+        for (; i < idx->starts.size() && idx->starts[i] == timeMS; ++i) {
+            if (idx->effects[i]->FilteredIn(filterText, isFilterTextRegex)) {
+                return idx->effects[i];
+            }
+        }
+        return nullptr;
+    }
     for (int i = 0; i < (int)mEffects.size(); ++i) {
         if (timeMS == mEffects[i]->GetStartTimeMS() && mEffects[i]->FilteredIn(filterText, isFilterTextRegex)) {
             return mEffects[i];
@@ -1301,6 +1378,7 @@ bool EffectLayer::SortEffectByStartTime(Effect *e1,Effect *e2)
 
 void EffectLayer::IncrementChangeCount(int startMS, int endMS)
 {
+    InvalidateTimeIndex();
     if (mParentElement) {
         mParentElement->IncrementChangeCount(startMS, endMS);
     }
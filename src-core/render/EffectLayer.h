@@ -16,8 +16,10 @@
 #include <atomic>
 #include <tuple>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #define NO_MIN_MAX_TIME 0
 
@@ -117,6 +119,9 @@ public:
     void UpdateAllSelectedEffects(const std::string& palette);
 
     void IncrementChangeCount(int startMS, int endMS);
+    // Drops the time index so the next time lookup rebuilds it. Called on
+    // every edit that can move an effect or change the layer's effect set.
+    void InvalidateTimeIndex();
 
     std::recursive_mutex& GetLock() {
         return lock;
@@ -127,6 +132,8 @@ public:
 
     void CleanupAfterRender();
     void NumberEffects();
+    // sorts by start time and renumbers, for callers that added with suppress_sort
+    void SortEffects();
 
     const std::string& GetLayerName() const {
         if (name == nullptr) {
@@ -148,7 +155,18 @@ protected:
 private:
     std::unique_lock<std::recursive_mutex> acquireLockWaitForRender();
 
-    void SortEffects();
+    // Start-ordered snapshot of the effect times backing GetEffectByTime,
+    // GetEffectAtTime and GetEffectStartingAtTime. maxEnds[i] is the largest
+    // end time of effects[0..i], so it is sorted and the first effect that can
+    // still contain a time is found with a binary search.
+    struct TimeIndex {
+        std::vector<Effect*> effects;
+        std::vector<int> starts;
+        std::vector<int> ends;
+        std::vector<int> maxEnds;
+    };
+    std::shared_ptr<const TimeIndex> GetTimeIndex() const;
+    static Effect* FindEffectAtTime(const TimeIndex& idx, int timeMS, const std::string& filterText, bool isFilterTextRegex);
 
     static std::atomic_int exclusive_index;
 
@@ -161,8 +179,13 @@ private:
     std::list<Effect*> mEffectsToDelete;
     int mIndex = 0;
     Element* mParentElement = nullptr;
-    std::recursive_mutex lock;
+    mutable std::recursive_mutex lock;
     std::mutex effectsToDeleteLock;
+    // the index is built under `lock` and swapped in under timeIndexLock; an
+    // edit racing a build bumps timeIndexGen so the stale build is not kept
+    mutable std::mutex timeIndexLock;
+    mutable std::shared_ptr<const TimeIndex> timeIndex;
+    std::atomic_uint32_t timeIndexGen{ 0 };
 
     std::string* name = nullptr;
 
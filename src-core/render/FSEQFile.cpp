@@ -2,6 +2,7 @@
 #define _FILE_OFFSET_BITS 64
 #define __STDC_FORMAT_MACROS
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 
@@ -38,7 +39,9 @@ int gettimeofday(struct timeval* tp, struct timezone* tzp) {
 
 #else
 #include <sys/time.h>
+#include <sys/mman.h>
 #include <unistd.h>
+#define FSEQ_USE_MMAP
 #endif
 
 #include "FSEQFile.h"
@@ -125,6 +128,10 @@ inline void AddSlowStorageWarning() {}
 #define ZSTD_STATIC_LINKING_ONLY
 #endif
 #include <zstd.h>
+#if __has_include(<zdict.h>)
+#include <zdict.h>
+#define FSEQ_HAS_ZDICT
+#endif
 #include <thread>
 #include <future>
 #include <deque>
@@ -159,6 +166,7 @@ ZSTDThreadPoolHolder ZSTDThreadPoolHolder::INSTANCE;
 #endif
 
 using FrameData = FSEQFile::FrameData;
+using FrameView = FSEQFile::FrameView;
 
 inline void DumpHeader(const char* title, unsigned char data[], int len) {
     int x = 0;
@@ -232,6 +240,13 @@ static const int V1FSEQ_MAJOR_VERSION = 1;
 
 static const int V2FSEQ_MINOR_VERSION = 0;
 static const int V2FSEQ_MAJOR_VERSION = 2;
+// blocks are compressed with the zstd dictionary in the 'ZD' variable header
+static const int V2FSEQ_ZSTD_DICTIONARY_MINOR_VERSION = 3;
+// frames after the first of each block are stored as differences, see the 'TD' variable header
+static const int V2FSEQ_TEMPORAL_DELTA_MINOR_VERSION = 4;
+static const int V2FSEQ_MAX_MINOR_VERSION = V2FSEQ_TEMPORAL_DELTA_MINOR_VERSION;
+// 'TD' payload: each byte is the difference (mod 256) from the same byte of the previous frame
+static const uint8_t V2FSEQ_TEMPORAL_DELTA_BYTE_DIFFERENCE = 1;
 
 static const int V1ESEQ_MINOR_VERSION = 0;
 static const int V1ESEQ_MAJOR_VERSION = 2;
@@ -443,11 +458,74 @@ FSEQFile::FSEQFile(const std::string& fn, FILE* file, const std::vector<uint8_t>
     }
 }
 FSEQFile::~FSEQFile() {
+#ifdef FSEQ_USE_MMAP
+    if (m_mappedData) {
+        munmap(m_mappedData, m_mappedSize);
+    }
+#endif
     if (m_seqFile) {
         fclose(m_seqFile);
     }
 }
 
+// When streaming from a mapping, how far ahead of the current frame the kernel
+// is asked to read.  At least this many bytes and this many frames.
+static const uint64_t FSEQ_MMAP_READAHEAD_BYTES = 2 * 1024 * 1024;
+static const uint64_t FSEQ_MMAP_READAHEAD_FRAMES = 20;
+
+bool FSEQFile::mapFile() {
+#ifdef FSEQ_USE_MMAP
+    if (m_mappedData) {
+        return true;
+    }
+    if (m_seqFile == nullptr || m_seqFileSize == 0) {
+        return false;
+    }
+    void* p = mmap(nullptr, m_seqFileSize, PROT_READ, MAP_SHARED, fileno(m_seqFile), 0);
+    if (p == MAP_FAILED) {
+        LogDebug(VB_SEQUENCE, "Could not memory map %s, reading frames with copies.\n", m_filename.c_str());
+        return false;
+    }
+    m_mappedData = (uint8_t*)p;
+    m_mappedSize = m_seqFileSize;
+    if (m_readPattern == ReadPattern::Bulk) {
+        // every page is going to be needed, in order
+        madvise(p, m_mappedSize, MADV_SEQUENTIAL);
+        madvise(p, m_mappedSize, MADV_WILLNEED);
+    } else {
+        // playback may seek, the read ahead is done in mappedData where the
+        // position is known
+        madvise(p, m_mappedSize, MADV_RANDOM);
+    }
+    m_advisedStart = m_advisedEnd = 0;
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint8_t* FSEQFile::mappedData(uint64_t offset, uint64_t len) {
+    if (m_mappedData == nullptr || offset + len > m_mappedSize) {
+        return nullptr;
+    }
+#ifdef FSEQ_USE_MMAP
+    if (m_readPattern == ReadPattern::Streaming) {
+        uint64_t window = std::max(FSEQ_MMAP_READAHEAD_BYTES, len * FSEQ_MMAP_READAHEAD_FRAMES);
+        uint64_t end = offset + len;
+        // re-advise on a seek or once half of the last window has been used
+        if (offset < m_advisedStart || end + window / 2 > m_advisedEnd) {
+            static const uint64_t pageSize = sysconf(_SC_PAGESIZE);
+            uint64_t start = offset - (offset % pageSize);
+            uint64_t stop = std::min(m_mappedSize, end + window);
+            madvise(m_mappedData + start, stop - start, MADV_WILLNEED);
+            m_advisedStart = start;
+            m_advisedEnd = stop;
+        }
+    }
+#endif
+    return m_mappedData + offset;
+}
+
 int FSEQFile::seek(uint64_t location, int origin) {
     if (m_seqFile) {
         return fseeko(m_seqFile, location, origin);
@@ -502,7 +580,9 @@ inline bool isRecognizedBinaryVariableHeader(uint8_t a, uint8_t b) {
     // FC - FPP Commands
     // FE - FPP Effects
     // ED - Extended data
-    return (a == 'F' && b == 'C') || (a == 'F' && b == 'E') || (a == 'E' && b == 'D');
+    // ZD - zstd dictionary
+    // TD - temporal delta filter
+    return (a == 'F' && b == 'C') || (a == 'F' && b == 'E') || (a == 'E' && b == 'D') || (a == 'Z' && b == 'D') || (a == 'T' && b == 'D');
 }
 
 void FSEQFile::parseVariableHeaders(const std::vector<uint8_t>& header, int readIndex) {
@@ -743,6 +823,23 @@ public:
     std::vector<std::pair<uint32_t, uint32_t>> m_ranges;
 };
 
+bool FSEQFile::FrameView::readFrame(uint8_t* data, uint32_t maxChannels) {
+    if (m_data == nullptr || m_ranges == nullptr)
+        return false;
+    uint32_t offset = 0;
+    for (auto& rng : *m_ranges) {
+        uint32_t toRead = rng.second;
+        if (offset + toRead <= m_size) {
+            uint32_t toCopy = std::min(toRead, maxChannels - rng.first);
+            memcpy(&data[rng.first], &m_data[offset], toCopy);
+            offset += toRead;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
 void V1FSEQFile::prepareRead(const std::vector<std::pair<uint32_t, uint32_t>>& ranges, uint32_t startFrame) {
     m_rangesToRead = ranges;
     m_dataBlockSize = 0;
@@ -755,18 +852,42 @@ void V1FSEQFile::prepareRead(const std::vector<std::pair<uint32_t, uint32_t>>& r
         }
         m_dataBlockSize += toRead;
     }
+    mapFile();
     FrameData* f = getFrame(startFrame);
     if (f) {
         delete f;
     }
 }
 
+bool V1FSEQFile::getFrameView(uint32_t frame, FrameView& view) {
+    // the view can only point at the data if the ranges are one contiguous run
+    if (frame >= m_seqNumFrames || m_rangesToRead.size() != 1) {
+        return false;
+    }
+    uint64_t offset = m_seqChannelCount;
+    offset *= frame;
+    offset += m_seqChanDataOffset + m_rangesToRead[0].first;
+    uint8_t* d = mappedData(offset, m_dataBlockSize);
+    if (d == nullptr) {
+        return false;
+    }
+    view.frame = frame;
+    view.m_data = d;
+    view.m_size = m_dataBlockSize;
+    view.m_ranges = &m_rangesToRead;
+    return true;
+}
+
 FrameData* V1FSEQFile::getFrame(uint32_t frame) {
     if (m_rangesToRead.empty()) {
         std::vector<std::pair<uint32_t, uint32_t>> range;
         range.push_back(std::pair<uint32_t, uint32_t>(0, m_seqChannelCount));
         prepareRead(range, frame);
     }
+    FrameView view;
+    if (getFrameView(frame, view)) {
+        return new FrameView(view);
+    }
     uint64_t offset = m_seqChannelCount;
     offset *= frame;
     offset += m_seqChanDataOffset;
@@ -817,6 +938,34 @@ static const int V2FSEQ_OUT_BUFFER_FLUSH_SIZE = 16 * 1024 * 1024;  // 50% full,
 static const int V2FSEQ_OUT_COMPRESSION_BLOCK_SIZE = 64 * 1024; // 64KB blocks
 #endif
 
+// Temporal delta: within a block, every frame after the first is stored as the
+// byte wise difference from the frame before it.  The first frame of each block
+// is kept whole so a block still decodes on its own.  The frames of a block never
+// overlap, telling the compiler so (__restrict) lets it vectorise the loops.
+static void subtractFrame(uint8_t* __restrict cur, const uint8_t* __restrict prev, size_t frameSize) {
+    for (size_t c = 0; c < frameSize; c++) {
+        cur[c] -= prev[c];
+    }
+}
+static void addFrame(uint8_t* __restrict cur, const uint8_t* __restrict prev, size_t frameSize) {
+    for (size_t c = 0; c < frameSize; c++) {
+        cur[c] += prev[c];
+    }
+}
+static void encodeTemporalDelta(uint8_t* data, size_t frames, size_t frameSize) {
+    // back to front so each frame is diffed against the unmodified one before it
+    for (size_t f = frames; f > 1; f--) {
+        subtractFrame(&data[(f - 1) * frameSize], &data[(f - 2) * frameSize], frameSize);
+    }
+}
+// Undo encodeTemporalDelta for frames [first, end) of a block whose frames
+// before first have already been decoded.
+static void decodeTemporalDelta(uint8_t* data, size_t first, size_t end, size_t frameSize) {
+    for (size_t f = std::max(first, (size_t)1); f < end; f++) {
+        addFrame(&data[f * frameSize], &data[(f - 1) * frameSize], frameSize);
+    }
+}
+
 class V2Handler {
 public:
     V2Handler(V2FSEQFile* f) :
@@ -847,6 +996,21 @@ public:
     void preload(uint64_t pos, uint64_t size) {
         m_file->preload(pos, size);
     }
+    bool hasBlockSource() const {
+        return m_file->m_blockSource != nullptr;
+    }
+    bool readReusableBlock(uint32_t startFrame, uint32_t endFrame, std::vector<uint8_t>& comp) {
+        return m_file->readReusableBlock(startFrame, endFrame, comp);
+    }
+    const std::vector<uint8_t>& zstdDictionary() const {
+        return m_file->m_zstdDictionary;
+    }
+    bool temporalDelta() const {
+        return m_file->m_temporalDelta;
+    }
+    const std::function<void(std::function<void()>)>& blockExecutor() const {
+        return m_file->m_blockExecutor;
+    }
 
     virtual void prepareRead(uint32_t frame) {}
 
@@ -888,6 +1052,10 @@ public:
         }
     }
     virtual FrameData* getFrame(uint32_t frame) override {
+        FrameView view;
+        if (m_file->getFrameView(frame, view)) {
+            return new FrameView(view);
+        }
         UncompressedFrameData* data = new UncompressedFrameData(frame, m_file->m_dataBlockSize, m_file->m_rangesToRead);
         uint64_t offset = m_file->getChannelCount();
         offset *= frame;
@@ -1052,10 +1220,24 @@ public:
         unsigned int hw = std::thread::hardware_concurrency();
         m_numWorkers = hw > 1 ? (int)hw : 1;
         m_maxBlocksInFlight = m_numWorkers > 1 ? m_numWorkers : 0;
+        for (auto& h : m_file->getVariableHeaders()) {
+            if (h.code[0] == 'Z' && h.code[1] == 'D' && !h.data.empty()) {
+                m_ddict = ZSTD_createDDict(h.data.data(), h.data.size());
+                if (m_ddict == nullptr) {
+                    LogErr(VB_SEQUENCE, "Could not load the zstd dictionary, frames will not decompress.\n");
+                }
+            }
+        }
         LogDebug(VB_SEQUENCE, "  Prepared to read/write a ZSTD compress fseq file.\n");
     }
     virtual ~V2ZSTDCompressionHandler() {
         bulkShutdown();
+        if (m_cdict) {
+            ZSTD_freeCDict(m_cdict);
+        }
+        if (m_ddict) {
+            ZSTD_freeDDict(m_ddict);
+        }
         free(m_outBuffer.dst);
         if (m_inBuffer.src != nullptr) {
             free((void*)m_inBuffer.src);
@@ -1070,6 +1252,29 @@ public:
     virtual uint8_t getCompressionType() override { return 1; }
     virtual std::string GetType() const override { return "Compressed ZSTD"; }
 
+    // Start a new frame on a decompression stream.  ZSTD_initDStream also drops
+    // any dictionary, so with one it has to be referenced again.
+    void resetDStream(ZSTD_DStream* dctx) {
+        if (m_ddict == nullptr) {
+            ZSTD_initDStream(dctx);
+            return;
+        }
+        ZSTD_DCtx_reset(dctx, ZSTD_reset_session_only);
+        ZSTD_DCtx_refDDict(dctx, m_ddict);
+    }
+    // The compression dictionary, built on first use at the file's level.  Every
+    // block (including the normally faster first one) uses its level.
+    const ZSTD_CDict* getCDict() {
+        if (m_cdict == nullptr && !zstdDictionary().empty()) {
+            int clevel = m_file->m_compressionLevel == -99 ? 3 : m_file->m_compressionLevel;
+            if (clevel < -25 || clevel > 25) {
+                clevel = 3;
+            }
+            m_cdict = ZSTD_createCDict(zstdDictionary().data(), zstdDictionary().size(), clevel);
+        }
+        return m_cdict;
+    }
+
     // ---- ReadPattern::Bulk: decompress whole blocks ahead, in parallel ----
     //
     // Each seekable block is an independent zstd frame, so blocks can be
@@ -1180,7 +1385,7 @@ public:
             // decompresses as a stream and stops once the frames the block
             // contributes are out.  One-shot ZSTD_decompress would instead
             // insist on room for every concatenated frame in the range.
-            ZSTD_initDStream(dctx);
+            resetDStream(dctx);
             ZSTD_inBuffer_s in = { s.comp.data(), s.comp.size(), 0 };
             ZSTD_outBuffer_s out = { s.out.data(), outSize, 0 };
             while (out.pos < outSize && in.pos < in.size) {
@@ -1190,13 +1395,17 @@ public:
                     break;
                 }
                 if (r == 0 && out.pos < outSize && in.pos < in.size) {
-                    ZSTD_initDStream(dctx); // on to the next concatenated frame
+                    resetDStream(dctx); // on to the next concatenated frame
                 }
             }
             if (out.pos < outSize) {
                 // Leave no stale bytes from whatever block used this slot last.
                 memset(&s.out[out.pos], 0, outSize - out.pos);
             }
+            if (temporalDelta()) {
+                size_t frameSize = m_file->getChannelCount();
+                decodeTemporalDelta(s.out.data(), 0, out.pos / frameSize, frameSize);
+            }
 
             lk.lock();
             s.state = SLOT_DONE;
@@ -1368,7 +1577,7 @@ public:
                 m_dctx = ZSTD_createDStream();
                 if (m_dctx == nullptr) LogDebug(VB_SEQUENCE, " getFrame ZSTD_createDStream failed.\n");
             }
-            ZSTD_initDStream(m_dctx);
+            resetDStream(m_dctx);
             seek(m_file->m_frameOffsets[m_curBlock].second, SEEK_SET);
 
             uint64_t len = m_file->m_frameOffsets[m_curBlock + 1].second;
@@ -1431,6 +1640,11 @@ public:
             }
             m_outBuffer.size = (fidx + 1) * m_file->getChannelCount();
             ZSTD_decompressStream(m_dctx, &m_outBuffer, &m_inBuffer);
+            if (temporalDelta()) {
+                // only the frames that came out whole, each needs the one before
+                size_t frameSize = m_file->getChannelCount();
+                decodeTemporalDelta((uint8_t*)m_outBuffer.dst, m_curFrameInBlock, m_outBuffer.pos / frameSize, frameSize);
+            }
             m_curFrameInBlock = fidx + 1;
         }
 
@@ -1484,14 +1698,23 @@ public:
     struct ParallelBlock {
         uint32_t startFrame = 0;
         int level = 3;
+        const ZSTD_CDict* cdict = nullptr; // when set, supersedes level
+        uint32_t deltaFrameSize = 0;       // when set, raw is delta encoded with this frame size first
         std::vector<uint8_t> raw;
         std::vector<uint8_t> comp;
     };
     static void compressParallelBlock(ParallelBlock* b) {
+        if (b->deltaFrameSize) {
+            encodeTemporalDelta(b->raw.data(), b->raw.size() / b->deltaFrameSize, b->deltaFrameSize);
+        }
         size_t bound = ZSTD_compressBound(b->raw.size());
         b->comp.resize(bound);
         ZSTD_CCtx* cctx = ZSTD_createCCtx();
-        ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, b->level);
+        if (b->cdict != nullptr) {
+            ZSTD_CCtx_refCDict(cctx, b->cdict);
+        } else {
+            ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, b->level);
+        }
         size_t r = ZSTD_compress2(cctx, b->comp.data(), bound, b->raw.data(), b->raw.size());
         ZSTD_freeCCtx(cctx);
         if (ZSTD_isError(r)) {
@@ -1515,6 +1738,17 @@ public:
         auto b = std::make_shared<ParallelBlock>();
         b->startFrame = m_curBlockStartFrame;
         b->level = m_curBlockLevel;
+        if (readReusableBlock(m_curBlockStartFrame, m_curBlockStartFrame + m_curFrameInBlock, b->comp)) {
+            // untouched since the source was written, no need to compress it again
+            m_curRaw.clear();
+            std::promise<std::shared_ptr<ParallelBlock>> p;
+            p.set_value(b);
+            m_pendingBlocks.push_back(p.get_future());
+            m_curFrameInBlock = 0;
+            return;
+        }
+        b->cdict = getCDict();
+        b->deltaFrameSize = temporalDelta() ? m_file->getChannelCount() : 0;
         b->raw = std::move(m_curRaw);
         m_curRaw = std::vector<uint8_t>();
         // Bound the work in flight by both block count (keep the workers fed) and
@@ -1525,6 +1759,16 @@ public:
             writeOldestBlock();
         }
         m_inFlightBytes += blockBytes;
+        if (blockExecutor()) {
+            auto task = std::make_shared<std::packaged_task<std::shared_ptr<ParallelBlock>()>>([b]() {
+                compressParallelBlock(b.get());
+                return b;
+            });
+            m_pendingBlocks.push_back(task->get_future());
+            blockExecutor()([task]() { (*task)(); });
+            m_curFrameInBlock = 0;
+            return;
+        }
         try {
             m_pendingBlocks.push_back(std::async(std::launch::async, [b]() {
                 compressParallelBlock(b.get());
@@ -1580,8 +1824,15 @@ public:
         V2CompressedHandler::finalize();
     }
 
+    // Reusing blocks from a previous write, dictionary compression and the
+    // temporal delta filter all need whole blocks buffered, so the block path is
+    // also used on single core hosts for them.
+    bool useBlockPath() const {
+        return m_maxBlocksInFlight > 0 || hasBlockSource() || !zstdDictionary().empty() || temporalDelta();
+    }
+
     virtual void addFrame(uint32_t frame, const uint8_t* data) override {
-        if (m_maxBlocksInFlight > 0) {
+        if (useBlockPath()) {
             addFrameParallel(frame, data);
             return;
         }
@@ -1663,7 +1914,7 @@ public:
         }
     }
     virtual void finalize() override {
-        if (m_maxBlocksInFlight > 0) {
+        if (useBlockPath()) {
             finalizeParallel();
             return;
         }
@@ -1686,6 +1937,8 @@ public:
 
     ZSTD_CCtx* m_cctx = nullptr;
     ZSTD_DStream* m_dctx = nullptr;
+    ZSTD_CDict* m_cdict = nullptr;
+    ZSTD_DDict* m_ddict = nullptr;
     ZSTD_outBuffer_s m_outBuffer;
     ZSTD_inBuffer_s m_inBuffer;
 
@@ -1956,6 +2209,26 @@ void V2FSEQFile::writeHeader() {
         }
     }
 
+    // A dictionary header copied from another file (initializeFromFSEQ) does
+    // not match these blocks
+    if (m_zstdDictionary.empty()) {
+        removeVariableHeader('Z', 'D');
+    } else if (m_seqVersionMinor < V2FSEQ_ZSTD_DICTIONARY_MINOR_VERSION) {
+        enableMinorVersionFeatures(V2FSEQ_ZSTD_DICTIONARY_MINOR_VERSION);
+    }
+    // Likewise for a copied temporal delta header
+    removeVariableHeader('T', 'D');
+    if (m_temporalDelta) {
+        VariableHeader header;
+        header.code[0] = 'T';
+        header.code[1] = 'D';
+        header.data.push_back(V2FSEQ_TEMPORAL_DELTA_BYTE_DIFFERENCE);
+        addVariableHeader(header);
+        if (m_seqVersionMinor < V2FSEQ_TEMPORAL_DELTA_MINOR_VERSION) {
+            enableMinorVersionFeatures(V2FSEQ_TEMPORAL_DELTA_MINOR_VERSION);
+        }
+    }
+
     // Additional file format documentation available at:
     // https://github.com/FalconChristmas/fpp/blob/master/docs/FSEQ_Sequence_File_Format.txt#L17
 
@@ -2113,7 +2386,7 @@ V2FSEQFile::V2FSEQFile(const std::string& fn, FILE* file, const std::vector<uint
     m_compressionType(none),
     m_allowExtendedBlocks(false),
     m_handler(nullptr) {
-    if (m_seqVersionMajor == 2 && m_seqVersionMinor > 2) {
+    if (m_seqVersionMajor == 2 && m_seqVersionMinor > V2FSEQ_MAX_MINOR_VERSION) {
         LogErr(VB_SEQUENCE, "Unknown minor version: %d.  FSEQ may not load properly.\n", m_seqVersionMinor);
     }
 
@@ -2229,6 +2502,15 @@ V2FSEQFile::V2FSEQFile(const std::string& fn, FILE* file, const std::vector<uint
         // This will loop and continue reading until it hits padding or m_seqChanDataOffset
         // As long as readPos == headerSize prior to this call, the read is a success
         parseVariableHeaders(header, readPos);
+        for (auto& h : m_variableHeaders) {
+            if (h.code[0] == 'T' && h.code[1] == 'D' && !h.data.empty()) {
+                if (h.data[0] == V2FSEQ_TEMPORAL_DELTA_BYTE_DIFFERENCE && m_compressionType == CompressionType::zstd) {
+                    m_temporalDelta = true;
+                } else {
+                    LogErr(VB_SEQUENCE, "Unsupported temporal delta filter %d.  FSEQ will not load properly.\n", (int)h.data[0]);
+                }
+            }
+        }
     }
 
     createHandler();
@@ -2248,6 +2530,9 @@ void V2FSEQFile::dumpInfo(bool indent) {
     LogDebug(VB_SEQUENCE, "%sSequence File Information\n", ind);
     LogDebug(VB_SEQUENCE, "%scompressionType       : %d(%s)\n", ind, m_compressionType, CompressionTypeString().c_str());
     LogDebug(VB_SEQUENCE, "%snumBlocks             : %d\n", ind, m_handler->computeMaxBlocks());
+    if (m_temporalDelta) {
+        LogDebug(VB_SEQUENCE, "%stemporalDelta         : yes\n", ind);
+    }
     // Commented out to declutter the logs ... we can add it back in if we start seeing issues
     //for (auto &a : m_frameOffsets) {
     //    LogDebug(VB_SEQUENCE, "%s      %d              : %" PRIu64 "\n", ind, a.first, a.second);
@@ -2310,8 +2595,35 @@ void V2FSEQFile::prepareRead(const std::vector<std::pair<uint32_t, uint32_t>>& r
             LogErr(VB_SEQUENCE, "Requested range outside Read Ranges. Requested %d channels starting at %d. FSEQ expects %d channels.\n", cnt, st, m_seqChannelCount);
         }
     }
+    if (m_compressionType == CompressionType::none) {
+        mapFile();
+    }
     m_handler->prepareRead(startFrame);
 }
+bool V2FSEQFile::getFrameView(uint32_t frame, FrameView& view) {
+    if (m_compressionType != CompressionType::none || frame >= m_seqNumFrames || m_rangesToRead.empty()) {
+        return false;
+    }
+    uint64_t offset = m_seqChannelCount;
+    offset *= frame;
+    offset += m_seqChanDataOffset;
+    if (m_sparseRanges.empty()) {
+        // the view can only point at the data if the ranges are one contiguous run
+        if (m_rangesToRead.size() != 1) {
+            return false;
+        }
+        offset += m_rangesToRead[0].first;
+    }
+    uint8_t* d = mappedData(offset, m_dataBlockSize);
+    if (d == nullptr) {
+        return false;
+    }
+    view.frame = frame;
+    view.m_data = d;
+    view.m_size = m_dataBlockSize;
+    view.m_ranges = &m_rangesToRead;
+    return true;
+}
 FrameData* V2FSEQFile::getFrame(uint32_t frame) {
     if (m_rangesToRead.empty()) {
         std::vector<std::pair<uint32_t, uint32_t>> range;
@@ -2346,6 +2658,159 @@ void V2FSEQFile::finalize() {
     FSEQFile::finalize();
 }
 
+void V2FSEQFile::setBlockSource(V2FSEQFile* source, const std::vector<std::pair<uint32_t, uint32_t>>& dirtyFrames) {
+    m_blockSource = nullptr;
+    m_dirtyFrames.clear();
+    if (source == nullptr || source->m_compressionType != m_compressionType || source->m_frameOffsets.size() < 2) {
+        return;
+    }
+    bool sourceDictionary = false;
+    for (auto& h : source->getVariableHeaders()) {
+        sourceDictionary |= h.code[0] == 'Z' && h.code[1] == 'D';
+    }
+    if (sourceDictionary || hasZstdDictionary() || source->m_temporalDelta != m_temporalDelta) {
+        // blocks are only interchangeable when compressed with the same dictionary and filter
+        return;
+    }
+    if (source->getNumFrames() != getNumFrames() || source->getChannelCount() != getChannelCount() || source->m_sparseRanges != m_sparseRanges) {
+        LogDebug(VB_SEQUENCE, "Block source %s has a different layout, all blocks will be compressed.\n", source->getFilename().c_str());
+        return;
+    }
+    m_blockSource = source;
+    m_dirtyFrames = dirtyFrames;
+    std::sort(m_dirtyFrames.begin(), m_dirtyFrames.end());
+}
+
+bool V2FSEQFile::enableTemporalDelta(bool enable) {
+    if (enable && m_compressionType != CompressionType::zstd) {
+        return false;
+    }
+    m_temporalDelta = enable;
+    return true;
+}
+
+// Limits on the frames sampled to train a zstd dictionary, and the size of the
+// pieces they are cut into (zdict works best with many smallish samples)
+static const uint32_t ZSTD_DICTIONARY_SAMPLE_FRAMES = 1024;
+static const size_t ZSTD_DICTIONARY_SAMPLE_BYTES = 16 * 1024 * 1024;
+static const size_t ZSTD_DICTIONARY_SAMPLE_CHUNK = 16 * 1024;
+static const size_t ZSTD_DICTIONARY_MAX_SIZE = 110 * 1024;
+
+bool V2FSEQFile::trainZstdDictionary(const std::function<bool(uint32_t frame, uint8_t* data)>& getFrame) {
+    m_zstdDictionary.clear();
+    removeVariableHeader('Z', 'D');
+#if !defined(NO_ZSTD) && defined(FSEQ_HAS_ZDICT)
+    if (m_compressionType != CompressionType::zstd || m_seqNumFrames == 0 || m_seqChannelCount == 0) {
+        return false;
+    }
+    // the channels of each frame as they will be laid out in the file, see writeHeader
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;
+    for (auto& a : m_sparseRanges) {
+        if (a.first < m_seqChannelCount) {
+            ranges.emplace_back(a.first, std::min(a.second, m_seqChannelCount - a.first));
+        }
+    }
+    if (ranges.empty()) {
+        ranges.emplace_back(0, m_seqChannelCount);
+    }
+    size_t frameBytes = 0;
+    for (auto& a : ranges) {
+        frameBytes += a.second;
+    }
+    uint32_t count = std::min(m_seqNumFrames, ZSTD_DICTIONARY_SAMPLE_FRAMES);
+    count = (uint32_t)std::max((size_t)1, std::min((size_t)count, ZSTD_DICTIONARY_SAMPLE_BYTES / frameBytes));
+
+    std::vector<uint8_t> frame(getMaxChannel());
+    std::vector<uint8_t> next;
+    std::vector<uint8_t> samples;
+    std::vector<size_t> sampleSizes;
+    samples.reserve(frameBytes * count);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t f = (uint32_t)((uint64_t)i * m_seqNumFrames / count);
+        memset(frame.data(), 0, frame.size());
+        if (!getFrame(f, frame.data())) {
+            continue;
+        }
+        if (m_temporalDelta && f + 1 < m_seqNumFrames) {
+            // nearly every stored frame is a difference, so learn from those
+            next.assign(frame.size(), 0);
+            if (!getFrame(f + 1, next.data())) {
+                continue;
+            }
+            for (size_t c = 0; c < frame.size(); c++) {
+                frame[c] = next[c] - frame[c];
+            }
+        }
+        for (auto& a : ranges) {
+            samples.insert(samples.end(), &frame[a.first], &frame[a.first] + a.second);
+        }
+        for (size_t left = frameBytes; left > 0;) {
+            size_t sz = std::min(left, ZSTD_DICTIONARY_SAMPLE_CHUNK);
+            sampleSizes.push_back(sz);
+            left -= sz;
+        }
+    }
+    if (sampleSizes.size() < 8) {
+        LogInfo(VB_SEQUENCE, "Too few samples to train a zstd dictionary.\n");
+        return false;
+    }
+    std::vector<uint8_t> dict(std::min(ZSTD_DICTIONARY_MAX_SIZE, std::max((size_t)1024, samples.size() / 10)));
+    size_t sz = ZDICT_trainFromBuffer(dict.data(), dict.size(), samples.data(), sampleSizes.data(), (unsigned)sampleSizes.size());
+    if (ZDICT_isError(sz)) {
+        LogInfo(VB_SEQUENCE, "Could not train a zstd dictionary: %s\n", ZDICT_getErrorName(sz));
+        return false;
+    }
+    dict.resize(sz);
+    m_zstdDictionary = dict;
+
+    VariableHeader header;
+    header.code[0] = 'Z';
+    header.code[1] = 'D';
+    header.extendedData = true;
+    header.data = std::move(dict);
+    addVariableHeader(header);
+    LogDebug(VB_SEQUENCE, "Trained a %d byte zstd dictionary from %d frames.\n", (int)sz, (int)count);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool V2FSEQFile::readReusableBlock(uint32_t startFrame, uint32_t endFrame, std::vector<uint8_t>& comp) {
+    if (m_blockSource == nullptr || endFrame <= startFrame) {
+        return false;
+    }
+    // any dirty range that starts before the end of the block and ends inside or after it
+    for (auto& d : m_dirtyFrames) {
+        if (d.first >= endFrame) {
+            break;
+        }
+        if (d.second >= startFrame) {
+            return false;
+        }
+    }
+    // the source offsets are sorted by frame and end with a terminating entry
+    auto& offsets = m_blockSource->m_frameOffsets;
+    auto it = std::lower_bound(offsets.begin(), offsets.end() - 1, startFrame,
+                               [](const std::pair<uint32_t, uint64_t>& a, uint32_t f) { return a.first < f; });
+    if (it == offsets.end() - 1 || it->first != startFrame) {
+        return false;
+    }
+    uint32_t srcEnd = std::min((uint32_t)(it + 1)->first, (uint32_t)m_blockSource->getNumFrames());
+    if (srcEnd != endFrame) {
+        return false;
+    }
+    uint64_t len = (it + 1)->second - it->second;
+    comp.resize(len);
+    if (m_blockSource->seek(it->second, SEEK_SET) || m_blockSource->read(comp.data(), len) != len) {
+        LogErr(VB_SEQUENCE, "Failed to read block at frame %d from %s, compressing it instead.\n", (int)startFrame, m_blockSource->getFilename().c_str());
+        comp.clear();
+        return false;
+    }
+    m_reusedBlocks++;
+    return true;
+}
+
 uint32_t V2FSEQFile::getMaxChannel() const {
     uint32_t ret = m_seqChannelCount;
     for (auto& a : m_sparseRanges) {
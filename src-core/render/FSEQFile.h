@@ -2,7 +2,9 @@
 
 #include <stdio.h>
 #include <cstdint>
+#include <functional>
 #include <string>
+#include <utility>
 #include <vector>
 
 class FSEQFile {
@@ -34,6 +36,23 @@ public:
         uint32_t frame;
     };
 
+    //Non-owning frame data that points straight at the channel data of a memory
+    //mapped file, laid out the same as the data of the FrameData from getFrame.
+    //Only valid while the FSEQFile is open and until the next prepareRead.
+    class FrameView : public FrameData {
+        public:
+        FrameView() : FrameData(0) {};
+        virtual ~FrameView() {};
+
+        virtual bool readFrame(uint8_t *data, uint32_t maxChannels) override;
+        [[nodiscard]] virtual uint8_t* GetData() const override { return m_data; }
+        [[nodiscard]] virtual size_t GetSize() const override { return m_size; }
+
+        uint8_t *m_data = nullptr;
+        uint32_t m_size = 0;
+        const std::vector<std::pair<uint32_t, uint32_t>> *m_ranges = nullptr;
+    };
+
     enum CompressionType {
         none,
         zstd,
@@ -93,6 +112,12 @@ public:
     //It may not be used right away and will be deleted at some point in the future
     virtual FrameData *getFrame(uint32_t frame) = 0;
 
+    //Zero copy, allocation free alternative to getFrame for playback.  When the
+    //channel data of the file is memory mapped (uncompressed files, after
+    //prepareRead, on platforms with mmap) this points view at the frame and
+    //returns true.  Otherwise it returns false and getFrame must be used.
+    virtual bool getFrameView(uint32_t frame, FrameView &view) { return false; }
+
     //For writing to the fseq file
     virtual void enableMinorVersionFeatures(uint8_t ver) {}
     virtual void initializeFromFSEQ(const FSEQFile& fseq);
@@ -156,8 +181,19 @@ protected:
     uint64_t read(void *ptr, uint64_t size);
     void preload(uint64_t pos, uint64_t size);
 
+    //memory map the whole file for reading, returns false if it can't be
+    bool mapFile();
+    bool isMapped() const { return m_mappedData != nullptr; }
+    //pointer to len bytes at offset in the mapping, advises the kernel to read
+    //ahead of it when streaming, nullptr if outside the mapping
+    uint8_t *mappedData(uint64_t offset, uint64_t len);
+
 private:
     FILE* volatile  m_seqFile;
+    uint8_t*      m_mappedData = nullptr;
+    uint64_t      m_mappedSize = 0;
+    uint64_t      m_advisedStart = 0;
+    uint64_t      m_advisedEnd = 0;
     std::vector<uint8_t> m_memoryBuffer;
     uint64_t      m_memoryBufferPos;
 };
@@ -172,6 +208,7 @@ public:
 
     virtual void prepareRead(const std::vector<std::pair<uint32_t, uint32_t>> &ranges, uint32_t startFrame = 0) override;
     virtual FrameData *getFrame(uint32_t frame) override;
+    virtual bool getFrameView(uint32_t frame, FrameView &view) override;
 
     virtual void writeHeader() override;
     virtual void addFrame(uint32_t frame,
@@ -199,6 +236,7 @@ public:
 
     virtual void prepareRead(const std::vector<std::pair<uint32_t, uint32_t>> &ranges, uint32_t startFrame = 0) override;
     virtual FrameData *getFrame(uint32_t frame) override;
+    virtual bool getFrameView(uint32_t frame, FrameView &view) override;
 
     virtual void writeHeader() override;
     virtual void addFrame(uint32_t frame,
@@ -223,6 +261,42 @@ public:
         return CompressionTypeStrings[(int)m_compressionType];
     }
 
+    //For writing, reuse the compressed blocks of an earlier write of the same
+    //data instead of compressing them again.  A block is copied from source when
+    //it covers exactly the same frames and none of them are in dirtyFrames
+    //(inclusive first/last frame ranges).  Must be called after writeHeader(),
+    //source must stay open until finalize() and must have the same channel
+    //layout as this file.  Currently only used by the zstd writer.
+    void setBlockSource(V2FSEQFile *source, const std::vector<std::pair<uint32_t, uint32_t>> &dirtyFrames);
+    uint32_t getReusedBlockCount() const { return m_reusedBlocks; }
+
+    //For writing with zstd, train a dictionary from frames sampled across the
+    //sequence and compress every block with it.  Each block otherwise starts
+    //from an empty history, so this mostly helps files with many small blocks.
+    //getFrame must fill the zeroed getMaxChannel() sized buffer with the full
+    //channel data of the frame.  Call after the sparse ranges are set and
+    //before writeHeader().  The dictionary is stored in a 'ZD' variable header
+    //and the file becomes minor version 3.  Returns false, and the file is
+    //written without a dictionary, if one could not be trained.
+    bool trainZstdDictionary(const std::function<bool(uint32_t frame, uint8_t *data)> &getFrame);
+    bool hasZstdDictionary() const { return !m_zstdDictionary.empty(); }
+
+    //For writing with zstd, store every frame after the first of a block as the
+    //byte wise difference from the frame before it, so static passages and slow
+    //fades compress to runs of (nearly) zero bytes.  The first frame of each
+    //block is kept whole, so seeking still only decodes one block.  Recorded in
+    //a 'TD' variable header and the file becomes minor version 4.  Call before
+    //trainZstdDictionary() and writeHeader().  Returns false if the file is not
+    //zstd compressed.
+    bool enableTemporalDelta(bool enable = true);
+    bool hasTemporalDelta() const { return m_temporalDelta; }
+
+    //For writing with zstd, run the compression of each block through executor
+    //instead of starting a thread per block.  Lets a caller writing several files
+    //at once share one set of worker threads between them.  The executor must
+    //run every task it is given, on any thread, without waiting for this file.
+    void setBlockExecutor(std::function<void(std::function<void()>)> executor) { m_blockExecutor = std::move(executor); }
+
     CompressionType m_compressionType;
     int             m_compressionLevel;
     std::vector<std::pair<uint32_t, uint32_t>> m_sparseRanges;
@@ -233,7 +307,14 @@ public:
 private:
 
     void createHandler();
+    bool readReusableBlock(uint32_t startFrame, uint32_t endFrame, std::vector<uint8_t> &comp);
 
     V2Handler *m_handler;
+    V2FSEQFile *m_blockSource = nullptr;
+    std::vector<std::pair<uint32_t, uint32_t>> m_dirtyFrames;
+    uint32_t m_reusedBlocks = 0;
+    std::vector<uint8_t> m_zstdDictionary;
+    bool m_temporalDelta = false;
+    std::function<void(std::function<void()>)> m_blockExecutor;
     friend class V2Handler;
 };
@@ -10,6 +10,7 @@
 
 #include "render/FSEQFileIO.h"
 
+#include "render/FrameChunkQueue.h"
 #include "render/SequenceData.h"
 #include "render/SequenceElements.h"
 #include "render/Element.h"
@@ -24,11 +25,14 @@
 #include <spdlog/spdlog.h>
 #include <zstd.h>
 
+#include <algorithm>
 #include <climits>
 #include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <map>
 #include <memory>
+#include <thread>
 #include <utility>
 
 namespace {
@@ -130,6 +134,11 @@ FSEQFile::VariableHeader buildFppCommandHeader(TimingElement* te, int stepTime)
     return header;
 }
 
+// FanOutFrames hands the decoded frames to the sinks in chunks of a few MB,
+// each queue holding at most FANOUT_QUEUE_DEPTH of them.
+constexpr size_t FANOUT_CHUNK_BYTES = 4 * 1024 * 1024;
+constexpr size_t FANOUT_QUEUE_DEPTH = 4;
+
 } // namespace
 
 namespace FSEQFileIO {
@@ -178,10 +187,11 @@ bool Write(const std::string& path,
         return false;
     }
 
+    const std::string tmpPath = path + ".tmp";
     std::unique_ptr<FSEQFile> file(
-        FSEQFile::createFSEQFile(path, options.version, options.compression, options.compressionLevel));
+        FSEQFile::createFSEQFile(tmpPath, options.version, options.compression, options.compressionLevel));
     if (!file) {
-        spdlog::error("FSEQFileIO::Write: createFSEQFile failed for {}", path);
+        spdlog::error("FSEQFileIO::Write: createFSEQFile failed for {}", tmpPath);
         return false;
     }
 
@@ -259,16 +269,133 @@ bool Write(const std::string& path,
         file->addVariableHeader(h);
     }
 
+    if (options.temporalDelta && options.compression == FSEQFile::CompressionType::zstd) {
+        if (auto* v2 = dynamic_cast<V2FSEQFile*>(file.get())) {
+            v2->enableTemporalDelta();
+        }
+    }
+
+    if (options.zstdDictionary && options.compression == FSEQFile::CompressionType::zstd) {
+        if (auto* v2 = dynamic_cast<V2FSEQFile*>(file.get())) {
+            const unsigned int numChannels = seqData.NumChannels();
+            v2->trainZstdDictionary([&seqData, numChannels](uint32_t frame, uint8_t* data) {
+                std::memcpy(data, &seqData[frame][0], numChannels);
+                return true;
+            });
+        }
+    }
+
     file->writeHeader();
+
+    // frames a background render marks dirty from here on stay dirty after the write
+    const uint64_t dirtyGeneration = seqData.GetDirtyGeneration();
+
+    // The existing file can only supply blocks if it is the exact file seqData
+    // was last synced with; the layout checks are done by setBlockSource.
+    std::unique_ptr<FSEQFile> previous;
+    auto* v2 = dynamic_cast<V2FSEQFile*>(file.get());
+    if (options.incremental && v2 != nullptr && options.compression == FSEQFile::CompressionType::zstd
+        && seqData.GetSyncedFseqId() != 0 && FileExists(path)) {
+        previous.reset(FSEQFile::openFSEQFile(path));
+        auto* prev2 = dynamic_cast<V2FSEQFile*>(previous.get());
+        if (prev2 != nullptr && prev2->getUniqueId() == seqData.GetSyncedFseqId()) {
+            v2->setBlockSource(prev2, seqData.GetDirtyFrames());
+        } else {
+            previous.reset();
+        }
+    }
+
     const uint32_t numFrames = static_cast<uint32_t>(seqData.NumFrames());
     for (uint32_t fr = 0; fr < numFrames; ++fr) {
         file->addFrame(fr, &seqData[fr][0]);
     }
     file->finalize();
 
-    spdlog::info("FSEQFileIO::Write: wrote {} frames x {} channels to {}",
-                 numFrames, seqData.NumChannels(), path);
+    const uint64_t uniqueId = file->getUniqueId();
+    const uint32_t reused = v2 != nullptr ? v2->getReusedBlockCount() : 0;
+    const size_t blocks = v2 != nullptr ? v2->m_frameOffsets.size() : 0;
+    file.reset();
+    previous.reset();
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        spdlog::error("FSEQFileIO::Write: unable to replace {}: {}", path, ec.message());
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    seqData.SetSyncedFseq(uniqueId, dirtyGeneration);
+
+    spdlog::info("FSEQFileIO::Write: wrote {} frames x {} channels to {} ({} of {} blocks reused)",
+                 numFrames, seqData.NumChannels(), path, reused, blocks);
     return true;
 }
 
+FanOutResult FanOutFrames(FSEQFile& src,
+                          const std::vector<FrameSink>& sinks,
+                          const std::function<bool(int permille)>& progress) {
+    const uint32_t numFrames = src.getNumFrames();
+    const size_t frameSize = src.getMaxChannel() + 1;
+    if (sinks.empty() || numFrames == 0) {
+        return FanOutResult::Done;
+    }
+    const uint32_t chunkFrames = (uint32_t)std::clamp(FANOUT_CHUNK_BYTES / frameSize, (size_t)1, (size_t)numFrames);
+
+    std::vector<std::unique_ptr<FrameChunkQueue>> queues;
+    for (size_t i = 0; i < sinks.size(); ++i) {
+        queues.push_back(std::make_unique<FrameChunkQueue>(FANOUT_QUEUE_DEPTH));
+    }
+    std::vector<std::thread> threads;
+    threads.reserve(sinks.size());
+    for (size_t i = 0; i < sinks.size(); ++i) {
+        threads.emplace_back([&sink = sinks[i], &queue = *queues[i], frameSize] {
+            while (auto chunk = queue.pop()) {
+                for (uint32_t f = 0; f < chunk->frames; ++f) {
+                    sink(chunk->firstFrame + f, &chunk->data[f * frameSize]);
+                }
+            }
+        });
+    }
+
+    bool completed = true;
+    bool readErrors = false;
+    int lastDone = -1;
+    for (uint32_t first = 0; first < numFrames; first += chunkFrames) {
+        if (progress) {
+            const int done = (int)((uint64_t)first * 1000 / numFrames);
+            if (done != lastDone) {
+                lastDone = done;
+                if (!progress(done)) {
+                    completed = false;
+                    break;
+                }
+            }
+        }
+        auto chunk = std::make_shared<FrameChunk>();
+        chunk->firstFrame = first;
+        chunk->frames = std::min(chunkFrames, numFrames - first);
+        chunk->data.resize(chunk->frames * frameSize);
+        for (uint32_t f = 0; f < chunk->frames; ++f) {
+            std::unique_ptr<FSEQFile::FrameData> data(src.getFrame(first + f));
+            if (data == nullptr || !data->readFrame(&chunk->data[f * frameSize], (uint32_t)frameSize)) {
+                spdlog::error("FSEQFileIO::FanOutFrames: unable to read frame {} of {}", first + f, src.getFilename());
+                readErrors = true;
+            }
+        }
+        for (auto& q : queues) {
+            q->push(chunk);
+        }
+    }
+    for (auto& q : queues) {
+        q->close(!completed);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    if (!completed) {
+        return FanOutResult::Stopped;
+    }
+    return readErrors ? FanOutResult::ReadErrors : FanOutResult::Done;
+}
+
 } // namespace FSEQFileIO
@@ -13,6 +13,7 @@
 #include "render/FSEQFile.h"
 
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -51,6 +52,9 @@ struct WriteOptions {
     std::string source = "xLights";     // 'sp' header
     std::vector<EmbeddedBlob> embedded; // 'XR'/'XN'/'XS' compressed blobs (in emit order)
     std::vector<FSEQFile::VariableHeader> extraHeaders; // caller-supplied extras
+    bool incremental = true;            // v2 zstd: copy the blocks of untouched frames from the existing file
+    bool zstdDictionary = false;        // v2 zstd: compress blocks with a trained dictionary (fseq 2.3)
+    bool temporalDelta = false;         // v2 zstd: store frames as differences from the previous frame (fseq 2.4)
 };
 
 // Compute the master-view sparse channel ranges (merged) from the sequence's
@@ -65,10 +69,41 @@ std::vector<std::pair<uint32_t, uint32_t>> ComputeSparseRanges(SequenceElements&
 // ranges are derived from them; pass null for a bare write (e.g. a data-layer
 // convert). Media/source/eS/embedded headers come from `options`. Returns false
 // on I/O error or when seqData has no channels/frames.
+//
+// The file is written next to `path` and renamed over it once complete, so a
+// reader never sees a half written fseq. When options.incremental is set and the
+// existing file is the one seqData was last written to or loaded from, the
+// compressed blocks of frames seqData has not marked dirty since are copied
+// across instead of being recompressed. On success seqData is marked as in sync
+// with the new file.
 bool Write(const std::string& path,
            SequenceData& seqData,
            SequenceElements* elements,
            RenderContext* ctx,
            const WriteOptions& options = {});
 
+// Receives the frames of FanOutFrames, in order, on a thread of its own. data
+// holds src.getMaxChannel() + 1 channels and is only valid during the call.
+using FrameSink = std::function<void(uint32_t frame, const uint8_t* data)>;
+
+// How a FanOutFrames walk ended. A frame that could not be read is logged and
+// handed to the sinks as zeros, so ReadErrors means every frame still reached
+// the sinks but the output is not a faithful copy of src.
+enum class FanOutResult {
+    Done,
+    ReadErrors,
+    Stopped
+};
+
+// Decode every frame of src once and hand it to all of sinks, e.g. to build the
+// sparse fseq of each FPP instance from one read of the master sequence. The
+// calling thread decodes (src should use ReadPattern::Bulk) while each sink
+// consumes on its own thread, so decoding overlaps with the sinks and a slow
+// sink only holds the others back once the decoder is a few chunks ahead of it.
+// progress, if set, is called on the calling thread with the permille decoded
+// and stops the walk by returning false, which is reported as Stopped.
+FanOutResult FanOutFrames(FSEQFile& src,
+                          const std::vector<FrameSink>& sinks,
+                          const std::function<bool(int permille)>& progress = {});
+
 } // namespace FSEQFileIO
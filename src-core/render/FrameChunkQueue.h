@@ -0,0 +1,73 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// A run of decoded fseq frames, frames x the frame size bytes. Once queued it is
+// only read, so one chunk can be handed to any number of consumers.
+struct FrameChunk {
+    uint32_t firstFrame = 0;
+    uint32_t frames = 0;
+    std::vector<uint8_t> data;
+};
+
+// The chunks waiting for one consumer thread. Bounded so a slow consumer holds
+// the decoder back rather than the whole sequence being buffered.
+class FrameChunkQueue {
+public:
+    explicit FrameChunkQueue(size_t maxChunks = 4) :
+        _maxChunks(maxChunks) {
+    }
+
+    void push(std::shared_ptr<const FrameChunk> chunk) {
+        std::unique_lock<std::mutex> lock(_lock);
+        _signal.wait(lock, [this] { return _closed || _chunks.size() < _maxChunks; });
+        if (!_closed) {
+            _chunks.push_back(std::move(chunk));
+            _signal.notify_all();
+        }
+    }
+    // drop = true discards whatever has not been consumed yet
+    void close(bool drop) {
+        std::unique_lock<std::mutex> lock(_lock);
+        _closed = true;
+        if (drop) {
+            _chunks.clear();
+        }
+        _signal.notify_all();
+    }
+    // nullptr once closed and drained
+    std::shared_ptr<const FrameChunk> pop() {
+        std::unique_lock<std::mutex> lock(_lock);
+        _signal.wait(lock, [this] { return _closed || !_chunks.empty(); });
+        if (_chunks.empty()) {
+            return nullptr;
+        }
+        auto chunk = std::move(_chunks.front());
+        _chunks.pop_front();
+        _signal.notify_all();
+        return chunk;
+    }
+
+private:
+    const size_t _maxChunks;
+    std::mutex _lock;
+    std::condition_variable _signal;
+    std::deque<std::shared_ptr<const FrameChunk>> _chunks;
+    bool _closed = false;
+};
@@ -11,6 +11,7 @@
 #include "HeadlessRenderContext.h"
 
 #include "render/RenderEngine.h"
+#include "render/RenderProfile.h"
 #include "render/RenderProgressInfo.h"
 #include "render/IRenderProgressSink.h"
 #include "render/FSEQFileIO.h"
@@ -166,6 +167,17 @@ void HeadlessRenderContext::EnsureRenderEngine() {
     if (!_renderEngine) {
         jobPool.Start(RenderEngine::RecommendedPoolSize());
         _renderEngine = std::make_unique<RenderEngine>(*this, jobPool, _renderCache);
+        if (_profileCallback) {
+            _renderEngine->SetOnRenderProfile(_profileCallback);
+        }
+    }
+}
+
+void HeadlessRenderContext::SetRenderProfileCallback(std::function<void(const RenderBatchProfile&)> fn) {
+    RenderEngine::EnableRenderProfile();
+    _profileCallback = std::move(fn);
+    if (_renderEngine) {
+        _renderEngine->SetOnRenderProfile(_profileCallback);
     }
 }
 
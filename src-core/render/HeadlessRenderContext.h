@@ -14,6 +14,7 @@
 #include "render/SequenceFile.h"
 #include "render/ViewpointMgr.h"
 
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
@@ -51,6 +52,11 @@ public:
     // channel scope). Returns false if nothing is loaded/rendered or on I/O error.
     bool WriteFseq(const std::string& fseqPath);
 
+    // Collect XL_RENDER_PROFILE counters for every render batch and hand the
+    // merged result to `fn` (on a render thread, before RenderAndWait returns).
+    // Turns profiling on for the whole process. Used by xlRenderBench.
+    void SetRenderProfileCallback(std::function<void(const RenderBatchProfile&)> fn);
+
     // ---- RenderContext pieces the base does not provide ----
     // (IsInShow*Folder, MakeRelativePath, MoveToShowFolder, IsSequenceLoaded,
     // GetCurrentMediaManager, AbortRender, CloseSequence live on the base.)
@@ -70,6 +76,8 @@ public:
 private:
     void EnsureRenderEngine();
 
+    std::function<void(const RenderBatchProfile&)> _profileCallback;
+
     int _previewWidth = 1280;
     int _previewHeight = 720;
 };
@@ -1067,6 +1067,7 @@ void PixelBufferClass::GetNodeChannelValues(size_t nodenum, unsigned char* buf)
     layers[0]->buffer.Nodes[nodenum]->GetForChannels(buf);
 }
 void PixelBufferClass::SetNodeChannelValues(size_t nodenum, const unsigned char* buf) {
+    layers[0]->buffer.nodeColorsCurrent = false;
     layers[0]->buffer.Nodes[nodenum]->SetFromChannels(buf);
 }
 xlColor PixelBufferClass::GetNodeColor(size_t nodenum) const {
@@ -1090,6 +1091,19 @@ uint32_t PixelBufferClass::GetChanCountPerNode() const {
     }
     return layers[0]->buffer.Nodes[0]->GetChanCount();
 }
+size_t PixelBufferClass::GetMemoryBytes() const {
+    size_t bytes = blendDataBuffer.capacity() * sizeof(uint32_t);
+    for (const auto* l : layers) {
+        bytes += l->buffer.GetMemoryBytes();
+        for (const auto& b : l->shallowModelBuffers) {
+            bytes += b->GetMemoryBytes();
+        }
+        for (const auto& b : l->deepModelBuffers) {
+            bytes += b->GetMemoryBytes();
+        }
+    }
+    return bytes;
+}
 
 bool MixTypeHandlesAlpha(MixTypes mt) {
     return mt == MixTypes::Mix_Normal;
@@ -2704,7 +2718,31 @@ static inline bool IsInRange(const std::vector<bool>& restrictRange, size_t star
 // whichever thread got there last.
 void PixelBufferClass::GetColors(unsigned char* fdata, const std::vector<bool>& restrictRange, unsigned int numChannels) {
     if (layers[0] != nullptr) { // I dont like this ... it should never be null
-        if (!anyDimmingCurve) {
+        RenderBuffer& rb = layers[0]->buffer;
+        if (!anyDimmingCurve && rb.nodeColorsCurrent && restrictRange.empty()) {
+            // The blend left a contiguous copy of the node colours so the
+            // precompiled scatter plan writes whole runs of nodes at a time.
+            ISPCComputeUtilities::INSTANCE.scatterNodeColors(rb, fdata, numChannels);
+        } else if (!anyDimmingCurve && rb.plainNodes) {
+            // Fastest path: every node is a plain RGB NodeBaseClass so the
+            // channel layout comes from the buffer's flat per node arrays and
+            // only the colour is read from the node.
+            const uint32_t* chans = rb.nodeActChans.data();
+            const uint8_t* offsets = rb.nodeChanOffsets.data();
+            const size_t nc = rb.Nodes.size();
+            xlColor color;
+            for (size_t i = 0; i < nc; ++i) {
+                // Mirror SetColors: never write past fdata (see below).
+                const size_t start = chans[i];
+                if (start >= numChannels || !IsInRange(restrictRange, start)) continue;
+                rb.Nodes[i]->GetColorBase(color);
+                unsigned char* out = &fdata[start];
+                const uint8_t* o = &offsets[i * 3];
+                if (o[0] != 255) out[o[0]] = color.red;
+                if (o[1] != 255) out[o[1]] = color.green;
+                if (o[2] != 255) out[o[2]] = color.blue;
+            }
+        } else if (!anyDimmingCurve) {
             // Fast path: no model on this buffer has a dimming curve, so
             // skip the per-node GetDimmingCurve()/apply() block entirely.
             // Nodes of exactly NodeBaseClass (the dominant type - plain RGB
@@ -2730,6 +2768,8 @@ void PixelBufferClass::GetColors(unsigned char* fdata, const std::vector<bool>&
                 }
             }
         } else {
+            // the dimming curves are applied to the node colours in place
+            rb.nodeColorsCurrent = false;
             for (auto& n : layers[0]->buffer.Nodes) {
                 if (n == nullptr) continue;
                 size_t start = n->ActChan;
@@ -2776,7 +2816,37 @@ void PixelBufferClass::SetColors(int layer, const unsigned char* fdata, unsigned
     const size_t pixCnt = rb.GetPixelCount();
     const bool dmx = rb.IsDmxBuffer();
     const std::type_info& baseTI = typeid(NodeBaseClass);
-    if (!anyDimmingCurve) {
+    if (!anyDimmingCurve && !dmx && rb.plainNodes) {
+        // Fastest path: plain RGB nodes so the channel layout comes from the
+        // buffer's flat per node arrays. Colours without a channel keep the
+        // node's current value, as SetFromChannelsBase does.
+        const uint32_t* chans = rb.nodeActChans.data();
+        const uint8_t* offsets = rb.nodeChanOffsets.data();
+        const size_t nc = rb.Nodes.size();
+        for (size_t i = 0; i < nc; ++i) {
+            const size_t start = chans[i];
+            if (start >= numChannels) continue;
+
+            auto& n = rb.Nodes[i];
+            n->GetColorBase(color);
+            const unsigned char* in = &fdata[start];
+            const uint8_t* o = &offsets[i * 3];
+            if (o[0] != 255) color.red = in[o[0]];
+            if (o[1] != 255) color.green = in[o[1]];
+            if (o[2] != 255) color.blue = in[o[2]];
+            n->SetColorBase(color);
+            if (i < rb.nodeColors.size()) {
+                rb.nodeColors[i] = color;
+            }
+
+            for (const auto& a : n->Coords) {
+                if (a.bufX >= 0 && a.bufX < wi && a.bufY >= 0 && a.bufY < ht && (size_t)(a.bufY * wi + a.bufX) < pixCnt) {
+                    px[a.bufY * wi + a.bufX] = color;
+                }
+            }
+        }
+    } else if (!anyDimmingCurve) {
+        rb.nodeColorsCurrent = false;
         // Fast path: no model on this buffer has a dimming curve, so
         // skip the per-node GetDimmingCurve()/reverse() block entirely.
         for (const auto& n : rb.Nodes) {
@@ -2806,6 +2876,7 @@ void PixelBufferClass::SetColors(int layer, const unsigned char* fdata, unsigned
             }
         }
     } else {
+        rb.nodeColorsCurrent = false;
         for (const auto& n : rb.Nodes) {
             if (n == nullptr) continue;
             size_t start = n->ActChan;
@@ -389,6 +389,8 @@ public:
     uint32_t NodeStartChannel(size_t nodenum) const;
     uint32_t GetNodeCount() const;
     uint32_t GetChanCountPerNode() const;
+    // bytes held by every layer's (and per-model) render buffer pixel storage
+    size_t GetMemoryBytes() const;
     MixTypes GetMixType(int layer) const;
     bool IsCanvasMix(int layer) const;
     int GetFrameTimeInMS() const {
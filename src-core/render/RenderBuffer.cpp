@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <typeinfo>
 #include <unordered_set>
 #ifdef _MSC_VER
 	// required so M_PI will be defined by MSC
@@ -260,10 +261,83 @@ void RenderBuffer::InitBuffer(int newBufferHt, int newBufferWi, const std::strin
         }
         ++idx;
     }
-    
+
+    plainNodes = true;
+    const std::type_info& baseTI = typeid(NodeBaseClass);
+    for (const auto& n : Nodes) {
+        if (n == nullptr || typeid(*n) != baseTI) {
+            plainNodes = false;
+            break;
+        }
+    }
+
+    scatterRuns.clear();
+    nodeColorsCurrent = false;
+    if (plainNodes) {
+        nodeActChans.resize(Nodes.size());
+        nodeChanOffsets.resize(Nodes.size() * 3);
+        for (size_t i = 0; i < Nodes.size(); ++i) {
+            const auto& node = *Nodes[i];
+            nodeActChans[i] = node.ActChan;
+            for (int c = 0; c < 3; ++c) {
+                // same guard as NodeBaseClass::GetForChannelsBase so an offset outside
+                // the node's channels can never be written
+                uint8_t o = node.GetChannelOffset(c);
+                nodeChanOffsets[i * 3 + c] = o < node.GetChanCount() ? o : 255;
+            }
+        }
+
+        nodeColors.resize(Nodes.size());
+        for (size_t i = 0; i < Nodes.size(); ++i) {
+            const uint8_t* o = &nodeChanOffsets[i * 3];
+            bool fullNode = o[0] != 255 && o[1] != 255 && o[2] != 255;
+            if (fullNode && !scatterRuns.empty()) {
+                ScatterRun& r = scatterRuns.back();
+                if (r.firstNode + r.count == i && r.destChannel + r.count * 3 == nodeActChans[i] &&
+                    r.offsets[0] == o[0] && r.offsets[1] == o[1] && r.offsets[2] == o[2] &&
+                    r.offsets[0] != 255 && r.offsets[1] != 255 && r.offsets[2] != 255) {
+                    ++r.count;
+                    continue;
+                }
+            }
+            scatterRuns.push_back({ (uint32_t)i, 1, nodeActChans[i], { o[0], o[1], o[2] } });
+        }
+    } else {
+        // the walks over other buffers go through the nodes so dont hold copies for them
+        nodeActChans = std::vector<uint32_t>();
+        nodeChanOffsets = std::vector<uint8_t>();
+        nodeColors.clear();
+    }
+
     isTransformed = (bufferTransform != "None");
 }
 
+void RenderBuffer::SetNodeColors(const xlColor* colors, int count)
+{
+    if (plainNodes) {
+        for (int x = 0; x < count; ++x) {
+            Nodes[x]->SetColorBase(colors[x]);
+        }
+        if (count == (int)nodeColors.size()) {
+            std::memcpy(nodeColors.data(), colors, count * sizeof(xlColor));
+            nodeColorsCurrent = true;
+        } else {
+            nodeColorsCurrent = false;
+        }
+    } else {
+        for (int x = 0; x < count; ++x) {
+            Nodes[x]->SetColor(colors[x]);
+        }
+    }
+}
+
+size_t RenderBuffer::GetMemoryBytes() const
+{
+    return (pixelVector.capacity() + tempbufVector.capacity() + transformScratch.capacity()) * sizeof(xlColor) +
+           (blendBuffer.capacity() + indexVector.capacity() + nodeActChans.capacity()) * sizeof(uint32_t) +
+           nodeChanOffsets.capacity() + nodeColors.capacity() * sizeof(xlColor) + scatterRuns.capacity() * sizeof(ScatterRun);
+}
+
 void RenderBuffer::Clear()
 {
     if (pixelVector.size() > 0) {
@@ -292,6 +366,7 @@ void RenderBuffer::computeRandomBaseSeed()
     s ^= (uint64_t(uint32_t(curEffStartPer)) + 0x85EBCA6B29B7C4A5ULL) * 0xC2B2AE3D27D4EB4FULL;
     rngBaseSeed = rngMix64(s);
     rngSeededForPeriod = -1; // force the serial stream to reseed on next draw
+    rngUsed.store(false, std::memory_order_relaxed);
 }
 
 // generates a random number between num1 and num2 inclusive
@@ -1264,6 +1339,7 @@ RenderBuffer::RenderBuffer(RenderBuffer& buffer) : pixelVector(buffer.pixels, &b
     rngState = buffer.rngState;
     rngLayerIndex = buffer.rngLayerIndex;
     rngSeededForPeriod = buffer.rngSeededForPeriod;
+    rngUsed.store(buffer.UsedRandom(), std::memory_order_relaxed);
 
     pixels = &pixelVector[0];
     _textDrawingContext = buffer._textDrawingContext;
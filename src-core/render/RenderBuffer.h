@@ -470,6 +470,7 @@ public:
     // stay stable across frames (e.g. a per-pixel seed that shouldn't jitter).
     // Same (model, layer, effect, index) -> same value on every frame.
     inline uint32_t hashRandomStable(uint32_t index) const {
+        noteRandomUsed();
         return uint32_t(rngMix64(rngBaseSeed ^ (uint64_t(index) * 0xD1B54A32D192ED03ULL)) >> 32);
     }
     // Like hashRandomStable but keyed ONLY on (model, index) - independent of the
@@ -478,6 +479,7 @@ public:
     // them (e.g. the sparkle phase, which the serial main buffer and the
     // frame-parallel clones lazily initialize on different frames/effects).
     inline uint32_t hashModelStable(uint32_t index) const {
+        noteRandomUsed();
         return uint32_t(rngMix64(rngModelHash ^ (uint64_t(index) * 0xD1B54A32D192ED03ULL)) >> 32);
     }
     // Raw 64-bit per-(effect,frame) seed behind hashRandom()/hashRand01(); lets
@@ -494,6 +496,11 @@ public:
     // randInt()/rand01() effect falsely look like it carried cross-frame state.
     void resetSerialRandomForVerify() { rngSeededForPeriod = -1; }
     void SetLayerIndex(int idx) { rngLayerIndex = idx; }
+    // Whether the current effect has drawn from the RNG since it started and
+    // the seed those draws come from. The render cache only shares frames
+    // between effects with different seeds when neither drew.
+    bool UsedRandom() const { return rngUsed.load(std::memory_order_relaxed); }
+    uint64_t GetRandomBaseSeed() const { return rngBaseSeed; }
     const PaletteClass& GetPalette() const { return palette; }
 
     HSVValue Get2ColorAdditive(HSVValue& hsv1, HSVValue& hsv2) const;
@@ -532,8 +539,34 @@ private:
     // group plus that group's members) — parallel per-node channel writes
     // would race for the shared channel, so callers must use serial paths
     bool dupActChans = false;
+    // Flat copies of the per node output layout, rebuilt with indexVector so the
+    // per frame node walks read contiguous arrays. nodeChanOffsets has three
+    // entries (r,g,b) per node, 255 where the colour has no channel. They are an
+    // index alongside Nodes rather than a replacement for it and are only kept
+    // for plain buffers (about 10 bytes a node with nodeColors).
+    std::vector<uint32_t> nodeActChans;
+    std::vector<uint8_t> nodeChanOffsets;
+    // every node is exactly a NodeBaseClass so the walks can skip the virtual calls
+    bool plainNodes = false;
+    // Output scatter plan for plain buffers: runs of nodes on consecutive 3 channel
+    // slots sharing a colour order, written from nodeColors in one kernel call per
+    // run. Nodes that do not fit a run get a run of their own.
+    struct ScatterRun {
+        uint32_t firstNode;
+        uint32_t count;
+        uint32_t destChannel;
+        uint8_t offsets[3];
+    };
+    std::vector<ScatterRun> scatterRuns;
+    // contiguous copy of the node colours, valid while nodeColorsCurrent is set
+    xlColorVector nodeColors;
+    bool nodeColorsCurrent = false;
 public:
+    // store the blended colour of each node, colors is indexed by node
+    void SetNodeColors(const xlColor* colors, int count);
     uint32_t GetPixelCount() { return pixelVector.size(); }
+    // bytes held by the pixel/scratch vectors, for render memory telemetry
+    size_t GetMemoryBytes() const;
     xlColor *GetPixels() { return pixels; }
     // Hand pixel storage back to the CPU-owned vector. A GPU backend may point
     // `pixels` into its own mapping; InitBuffer then deliberately keeps that
@@ -611,6 +644,7 @@ private:
     uint64_t rngState = 0;       // stateful stream, serial path only
     int rngLayerIndex = 0;
     int rngSeededForPeriod = -1; // lazy per-frame reseed guard (serial path)
+    mutable std::atomic<bool> rngUsed{ false }; // any draw since computeRandomBaseSeed, set from parallel_for bodies too
 
     void computeRandomBaseSeed(); // recompute rngBaseSeed when the effect changes
     static inline uint64_t rngMix64(uint64_t z) {
@@ -618,11 +652,18 @@ private:
         z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
         return z ^ (z >> 31);
     }
+    inline void noteRandomUsed() const {
+        if (!rngUsed.load(std::memory_order_relaxed)) {
+            rngUsed.store(true, std::memory_order_relaxed);
+        }
+    }
     inline uint64_t rngHashInput(uint32_t index) const {
+        noteRandomUsed();
         return rngBaseSeed ^ (uint64_t(uint32_t(curPeriod)) * 0x9E3779B97F4A7C15ULL)
                            ^ (uint64_t(index) * 0xD1B54A32D192ED03ULL);
     }
     inline void ensureRandomSeed() {
+        noteRandomUsed();
         if (rngSeededForPeriod != curPeriod) {
             rngState = rngBaseSeed ^ (uint64_t(uint32_t(curPeriod)) * 0x9E3779B97F4A7C15ULL);
             rngSeededForPeriod = curPeriod;
@@ -15,11 +15,13 @@
 
 #include <log.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <filesystem>
 #include <spdlog/fmt/fmt.h>
 #include <functional>
+#include <set>
 #include <thread>
 #include "xLightsVersion.h"
 #include "UtilFunctions.h"
@@ -33,10 +35,50 @@
 #define USE_MMAP_RENDERCACHE
 #endif
 
+#ifndef NO_ZSTD
+#include <zstd.h>
+#define RENDER_CACHE_ENCODING "delta-zstd"
+#else
+#define RENDER_CACHE_ENCODING "delta"
+#endif
+
+// frames are packed in blocks of about this many bytes, so a single frame can be read by unpacking at most this much
+static constexpr size_t RENDER_CACHE_BLOCK_BYTES = 1024 * 1024;
+static constexpr size_t RENDER_CACHE_MAX_BLOCK_FRAMES = 64;
+#ifndef NO_ZSTD
+static constexpr int RENDER_CACHE_ZSTD_LEVEL = 3;
+#endif
+
 #pragma region RenderCache
 
 namespace fs = std::filesystem;
 
+// properties every cache item carries that describe the render rather than come from the effect's settings/palette
+static bool IsDescriptiveProperty(const std::string& key)
+{
+    static const std::set<std::string> tags = { "Effect", "Element", "EffectLayer", "StartMS", "EndMS", "Frames", "Models",
+                                                "FrameMS", "BufferWi", "BufferHt", "TimeDependent", "Encoding",
+                                                "RandomSeed", "UsesRandom", "ModelDependent", "Model" };
+    return tags.find(key) != tags.end();
+}
+
+// the effect's settings and palette that affect what is rendered ... X_ settings such as locked or the description dont
+static std::map<std::string, std::string> GetRenderedContent(Effect* effect)
+{
+    std::map<std::string, std::string> content;
+    for (const auto& it : effect->GetSettings()) {
+        if (!StartsWith(it.first, "X_")) {
+            content[it.first] = it.second;
+        }
+    }
+    for (const auto& it : effect->GetPaletteMap()) {
+        if (!StartsWith(it.first, "X_")) {
+            content[it.first] = it.second;
+        }
+    }
+    return content;
+}
+
 static void RenderCacheLoadThreadEntry(RenderCache* cache)
 {
     std::unique_lock<std::mutex> lock(cache->GetLoadMutex());
@@ -178,10 +220,33 @@ void RenderCache::AddCacheItem(RenderCacheItem* rci)
 {
     if (rci != nullptr) {
         spdlog::get("render")->info("RenderCache item added " + rci->Description());
-        PerEffectCache *cache = GetPerEffectCache(rci->EffectName());
-        std::unique_lock<std::shared_mutex> lock(cache->lock);
-        cache->cache.push_back(rci);
+        std::unique_lock<std::shared_mutex> lock(_indexLock);
+        rci->_indexed = true;
+        _index.emplace(rci->GetKey(), rci);
+    }
+}
+
+uint64_t RenderCache::GetContentKey(const std::string& effectName, const std::map<std::string, std::string>& content,
+                                    int frames, int frameMS, int bufferWi, int bufferHt, int startMS, const std::string& model)
+{
+    // FNV-1a, the strings are hashed with their terminators so adjacent fields cant run together
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    auto add = [&hash](const void* data, size_t len) {
+        const uint8_t* p = (const uint8_t*)data;
+        for (size_t i = 0; i < len; ++i) {
+            hash ^= p[i];
+            hash *= 0x100000001b3ULL;
+        }
+    };
+    add(effectName.c_str(), effectName.size() + 1);
+    for (const auto& it : content) {
+        add(it.first.c_str(), it.first.size() + 1);
+        add(it.second.c_str(), it.second.size() + 1);
     }
+    const int32_t geometry[] = { frames, frameMS, bufferWi, bufferHt, startMS };
+    add(geometry, sizeof(geometry));
+    add(model.c_str(), model.size() + 1);
+    return hash;
 }
 
 void RenderCache::SetSequence(const std::string& path, const std::string& sequenceFile)
@@ -235,19 +300,62 @@ void RenderCache::SetSequence(const std::string& path, const std::string& sequen
 }
 
 void RenderCache::RemoveItem(RenderCacheItem *item) {
-    PerEffectCache *c = GetPerEffectCache(item->EffectName());
-    std::unique_lock<std::shared_mutex> lock(c->lock);
-    auto &l = c->cache;
-    for (auto it = l.begin(); it != l.end(); ++it) {
-        if (item == *it) {
-            spdlog::get("render")->info("RenderCache item removed " + (*it)->Description());
-            l.erase(it);
-            break;
+    {
+        std::unique_lock<std::shared_mutex> lock(_indexLock);
+        if (item->_indexed) {
+            auto range = _index.equal_range(item->GetKey());
+            for (auto it = range.first; it != range.second; ++it) {
+                if (it->second == item) {
+                    _index.erase(it);
+                    break;
+                }
+            }
+            item->_indexed = false;
         }
     }
+    spdlog::get("render")->info("RenderCache item removed " + item->Description());
     delete item;
 }
 
+void RenderCache::ReleaseItem(RenderCacheItem* item, bool deleteFile)
+{
+    {
+        std::unique_lock<std::shared_mutex> lock(_indexLock);
+        if (--item->_users > 0) {
+            // another effect is still using it
+            return;
+        }
+        if (item->_indexed && !deleteFile && !item->IsPurged()) {
+            // stays in the index for the next effect that renders the same thing
+            return;
+        }
+    }
+
+    if (deleteFile) {
+        item->Delete();
+    } else {
+        item->Save();
+        RemoveItem(item);
+    }
+}
+
+// Takes every item no effect is using out of the index and returns them to the caller to dispose of
+std::vector<RenderCacheItem*> RenderCache::GetIdleItems()
+{
+    std::vector<RenderCacheItem*> res;
+    std::unique_lock<std::shared_mutex> lock(_indexLock);
+    for (auto it = _index.begin(); it != _index.end();) {
+        if (it->second->_users == 0) {
+            it->second->_indexed = false;
+            res.push_back(it->second);
+            it = _index.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return res;
+}
+
 bool RenderCache::IsEffectOkForCaching(Effect* effect) const
 {
     
@@ -287,17 +395,7 @@ bool RenderCache::IsEffectOkForCaching(Effect* effect) const
     return true;
 }
 
-RenderCache::PerEffectCache* RenderCache::GetPerEffectCache(const std::string &s) {
-    std::unique_lock<std::recursive_mutex> lock(_cacheLock);
-    PerEffectCache *r = _cache[s];
-    if (r == nullptr) {
-        r = new PerEffectCache();
-        _cache[s] = r;
-    }
-    return r;
-}
-
-RenderCacheItem* RenderCache::GetItem(Effect* effect, RenderBuffer* buffer)
+RenderCacheItem* RenderCache::GetItem(Effect* effect, RenderBuffer* buffer, bool timeDependent, bool modelDependent)
 {
     if (!IsEnabled()) return nullptr;
     if (_cacheFolder == "") return nullptr;
@@ -309,39 +407,51 @@ RenderCacheItem* RenderCache::GetItem(Effect* effect, RenderBuffer* buffer)
         std::unique_lock<std::mutex> lock(_loadMutex);
     }
 
-    PerEffectCache *cache = GetPerEffectCache(effect->GetEffectName());
-    std::shared_lock<std::shared_mutex> lock(cache->lock);
-    auto &l = cache->cache;
-    for (auto it = l.begin(); it != l.end(); ++it) {
-        if ((*it)->IsMatch(effect, buffer)) {
-            RenderCacheItem *item = *it;
-            //release the readlock
-            lock.unlock();
-            
-            //grab the write lock
-            std::unique_lock<std::shared_mutex> ulock(cache->lock);
-            l.erase(it);
-            spdlog::get("render")->info("RenderCache GetItem found an existing render cache item for effect {} on model {} on layer {} at start time {}ms.",
-                effect->GetEffectName(),
-                buffer->GetModelName(),
-                effect->GetParentEffectLayer()->GetLayerNumber(),
-                effect->GetStartTimeMS());
-
-            if (item != nullptr)
-                item->Touch();
-
-            return item;
+    uint64_t key = GetContentKey(effect->GetEffectName(), GetRenderedContent(effect),
+                                 buffer->curEffEndPer - buffer->curEffStartPer + 1, buffer->frameTimeInMs,
+                                 buffer->BufferWi, buffer->BufferHt, timeDependent ? effect->GetStartTimeMS() : -1,
+                                 modelDependent ? buffer->GetModelName() : std::string());
+
+    RenderCacheItem* item = nullptr;
+    bool created = false;
+    {
+        std::unique_lock<std::shared_mutex> lock(_indexLock);
+        auto range = _index.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second->IsMatch(effect, buffer)) {
+                item = it->second;
+                break;
+            }
+        }
+        if (item == nullptr) {
+            // items with the same key but a different seed (or a key collision) each need their own file
+            std::string file;
+            for (int n = 0; file.empty() || std::any_of(range.first, range.second, [&file](const auto& it) { return it.second->_cacheFile == file; }); ++n) {
+                file = _cacheFolder + GetPathSeparator() + RenderCacheItem::GetCacheFileName(effect->GetEffectName(), key, buffer->GetRandomBaseSeed(), n);
+            }
+            item = new RenderCacheItem(this, effect, buffer, key, timeDependent, modelDependent, file);
+            item->_indexed = true;
+            _index.emplace(key, item);
+            created = true;
         }
+        ++item->_users;
     }
-    lock.unlock();
 
-    spdlog::get("render")->info("RenderCache GetItem created a new render cache item for effect {} on model {} on layer {} at start time {}ms.",
-        effect->GetEffectName(),
-        buffer->GetModelName(),
-        effect->GetParentEffectLayer()->GetLayerNumber(),
-        effect->GetStartTimeMS());
-
-    return new RenderCacheItem(this, effect, buffer);
+    if (created) {
+        spdlog::get("render")->info("RenderCache GetItem created a new render cache item for effect {} on model {} on layer {} at start time {}ms.",
+            effect->GetEffectName(),
+            buffer->GetModelName(),
+            effect->GetParentEffectLayer()->GetLayerNumber(),
+            effect->GetStartTimeMS());
+    } else {
+        spdlog::get("render")->info("RenderCache GetItem found an existing render cache item for effect {} on model {} on layer {} at start time {}ms.",
+            effect->GetEffectName(),
+            buffer->GetModelName(),
+            effect->GetParentEffectLayer()->GetLayerNumber(),
+            effect->GetStartTimeMS());
+        item->Touch();
+    }
+    return item;
 }
 
 void RenderCache::Close()
@@ -360,12 +470,12 @@ void RenderCache::Close()
     Purge(nullptr, false);
     _cacheFolder = "";
 
-    std::unique_lock<std::recursive_mutex> lock(_cacheLock);
-    for (auto &a : _cache) {
-        delete a.second;
-        a.second = nullptr;
+    // anything left is still held by an effect and is freed when that effect lets it go
+    std::unique_lock<std::shared_mutex> lock(_indexLock);
+    for (auto& it : _index) {
+        it.second->_indexed = false;
     }
-    _cache.clear();
+    _index.clear();
     spdlog::get("render")->debug("    Closed.");
 }
 
@@ -428,34 +538,30 @@ void RenderCache::CleanupCache(SequenceElements* sequenceElements)
     // clean up cache
     // Because effects are removed from the cache then if you go from cache enabled to cache disabled this wont actually
     // clean out all the cache items ... as we dont know about them.
-    int deleted = 0;
-    std::unique_lock<std::recursive_mutex> lock(_cacheLock);
-    for (auto &l : _cache) {
-        if (l.second != nullptr) {
-            std::unique_lock<std::shared_mutex> ulock(l.second->lock);
-            auto it = l.second->cache.begin();
-            while (it != l.second->cache.end()) {
-                bool found = false;
-
-                for (int i = 0; i < (int)sequenceElements->GetElementCount() && !found; i++) {
-                    Element* em = sequenceElements->GetElement(i);
-                    found = findMatch(em, *it);
-                }
+    std::vector<RenderCacheItem*> unused;
+    {
+        std::unique_lock<std::shared_mutex> lock(_indexLock);
+        for (auto it = _index.begin(); it != _index.end();) {
+            bool found = it->second->_users > 0;
 
-                if (!found) {
-                    auto todelete = it;
-                    ++it;
-                    ulock.unlock();
-                    (*todelete)->Delete();
-                    ulock.lock();
-                    deleted++;
-                } else {
-                    ++it;
-                }
+            for (int i = 0; i < (int)sequenceElements->GetElementCount() && !found; i++) {
+                Element* em = sequenceElements->GetElement(i);
+                found = findMatch(em, it->second);
+            }
+
+            if (!found) {
+                it->second->_indexed = false;
+                unused.push_back(it->second);
+                it = _index.erase(it);
+            } else {
+                ++it;
             }
         }
     }
-    spdlog::get("render")->debug("    Cleaned up {} items in the cache.", deleted);
+    for (auto& it : unused) {
+        it->Delete();
+    }
+    spdlog::get("render")->debug("    Cleaned up {} items in the cache.", (int)unused.size());
 
     for (int i = 0; i < (int)sequenceElements->GetElementCount(); ++i) {
         Element* em = sequenceElements->GetElement(i);
@@ -480,32 +586,22 @@ void RenderCache::Purge(SequenceElements* sequenceElements, bool dodelete)
         spdlog::get("render")->debug("Purging render cache folder {}.", (const char *)_cacheFolder.c_str());
     }
 
-    std::unique_lock<std::recursive_mutex> lock(_cacheLock);
-    for (auto &it : _cache) {
-        if (it.second != nullptr) {
-            auto& l = it.second;
-            std::unique_lock<std::shared_mutex> ulock(l->lock);
-            while (l->cache.size() > 0) {
-                auto frnt = l->cache.front();
-                if (dodelete) {
-                    ulock.unlock();
-                    frnt->Delete();
-                    ulock.lock();
-                } else {
-                    frnt->Save();
-                    delete frnt;
-                    l->cache.pop_front();
-                }
-            }
-        }
-    }
-
+    // let the effects go of their items first so they are idle below
     if (sequenceElements) {
         for (int i = 0; i < (int)sequenceElements->GetElementCount(); i++) {
             Element* em = sequenceElements->GetElement(i);
             purgeCache(em, dodelete);
         }
     }
+
+    for (auto& it : GetIdleItems()) {
+        if (dodelete) {
+            it->Delete();
+        } else {
+            it->Save();
+            delete it;
+        }
+    }
 }
 bool RenderCache::UseMMap() const {
 #ifdef USE_MMAP_RENDERCACHE
@@ -526,16 +622,18 @@ RenderCacheItem::~RenderCacheItem()
 
 void RenderCacheItem::PurgeFrames()
 {
+    std::unique_lock<std::recursive_mutex> lock(_frameLock);
     _purged = true;
     for (auto& it : _frames) {
-        for (int x = it.second.size() - 1; x >= 0; --x) {
-            if (it.second[x] != nullptr) {
-                if (!_mmap) {
-                    free(it.second[x]);
-                }
-                it.second[x] = nullptr;
+        for (auto& f : it.second.raw) {
+            if (f != nullptr) {
+                free(f);
+                f = nullptr;
             }
         }
+        it.second.blocks.clear();
+        it.second.unpacked = std::vector<uint8_t>();
+        it.second.unpackedBlock = -1;
     }
 #ifdef USE_MMAP_RENDERCACHE
     if (_mmap) {
@@ -562,122 +660,231 @@ std::string RenderCacheItem::GetModelName(RenderBuffer* buffer)
     }
 }
 
-RenderCacheItem::RenderCacheItem(RenderCache* renderCache, Effect* effect, RenderBuffer* buffer) : _renderCache(renderCache)
+std::string RenderCacheItem::GetCacheFileName(const std::string& effectName, uint64_t key, uint64_t randomSeed, int n)
+{
+    std::string file = fmt::format("{}_{:016x}_{:016x}", effectName, key, randomSeed);
+    if (n > 0) {
+        file += "_" + std::to_string(n);
+    }
+    return file + ".cache";
+}
+
+RenderCacheItem::RenderCacheItem(RenderCache* renderCache, Effect* effect, RenderBuffer* buffer, uint64_t key, bool timeDependent,
+                                 bool modelDependent, const std::string& cacheFile) :
+    _renderCache(renderCache), _key(key)
 {
     _mmap = nullptr;
     _mmapSize = 0;
     _purged = false;
     _dirty = true;
-    std::string mname = GetModelName(buffer);
-    assert(mname != "");
-    _frameSize[mname] = sizeof(xlColor) * buffer->GetPixelCount();
-    std::string elname = effect->GetParentEffectLayer()->GetParentElement()->GetFullName();
-    Replace(elname, "/", "_");
-    Replace(elname, "\\", "_");
-    Replace(elname, ":", "_");
-    Replace(elname, "?", "_");
-    Replace(elname, "*", "_");
-    Replace(elname, "$", "_");
-    std::string file = fmt::format("{}_{}_{}_{}.cache",
-            effect->GetEffectName(), elname,
-            effect->GetParentEffectLayer()->GetLayerNumber(),
-            effect->GetStartTimeMS());
+    assert(GetModelName(buffer) != "");
+    // named by the key and seed rather than the element/layer/time as the frames are shared by every effect that matches
     _effectName = effect->GetEffectName();
-    _cacheFile = renderCache->GetCacheFolder() + GetPathSeparator() + file;
+    _cacheFile = cacheFile;
     _properties["Effect"] = effect->GetEffectName();
     _properties["Element"] = effect->GetParentEffectLayer()->GetParentElement()->GetFullName();
     _properties["EffectLayer"] = std::to_string(effect->GetParentEffectLayer()->GetLayerNumber());
     _properties["StartMS"] = std::to_string(effect->GetStartTimeMS());
     _properties["EndMS"] = std::to_string(effect->GetEndTimeMS());
     _properties["Frames"] = std::to_string(buffer->curEffEndPer - buffer->curEffStartPer + 1);
-    _properties["Models"] = "-1";
-    for (const auto& it : effect->GetSettings())
-    {
-        _properties[it.first] = it.second;
-    }
-    for (const auto& it : effect->GetPaletteMap())
+    _properties["FrameMS"] = std::to_string(buffer->frameTimeInMs);
+    _properties["BufferWi"] = std::to_string(buffer->BufferWi);
+    _properties["BufferHt"] = std::to_string(buffer->BufferHt);
+    _properties["TimeDependent"] = timeDependent ? "1" : "0";
+    _properties["ModelDependent"] = modelDependent ? "1" : "0";
+    _properties["Model"] = buffer->GetModelName();
+    _randomSeed = buffer->GetRandomBaseSeed();
+    for (const auto& it : GetRenderedContent(effect))
     {
         _properties[it.first] = it.second;
     }
 }
 
+static int GetIntProperty(const std::map<std::string, std::string>& properties, const std::string& key, int def = 0)
+{
+    auto it = properties.find(key);
+    if (it == properties.end()) return def;
+    return std::atoi(it->second.c_str());
+}
+
+// the frames the effect spans, as RenderBuffer::SetEffectDuration works them out
+static int GetEffectFrames(Effect* effect, int frameMS)
+{
+    if (frameMS <= 0) return 0;
+    return (effect->GetEndTimeMS() - 1) / frameMS - effect->GetStartTimeMS() / frameMS + 1;
+}
+
 bool RenderCacheItem::IsMatch(Effect* effect, RenderBuffer* buffer)
 {
     if (_purged) return false;
 
-    if (std::atoi(_properties.at("StartMS").c_str()) != effect->GetStartTimeMS()) return false;
+    auto en = _properties.find("Effect");
+    if (en == _properties.end() || en->second != effect->GetEffectName()) return false;
 
-    EffectLayer* el = effect->GetParentEffectLayer();
-    if (std::atoi(_properties.at("EffectLayer").c_str()) != el->GetLayerNumber()) return false;
+    // effects of the same length can span a different number of frames depending on where they start
+    int frames = buffer != nullptr ? buffer->curEffEndPer - buffer->curEffStartPer + 1 : GetEffectFrames(effect, GetIntProperty(_properties, "FrameMS"));
+    if (GetIntProperty(_properties, "Frames") != frames) return false;
 
-    Element* e = el->GetParentElement();
-    if (_properties.at("Element") != e->GetFullName()) return false;
+    int start_ms = GetIntProperty(_properties, "StartMS");
 
-    int start_ms = std::atoi(_properties.at("StartMS").c_str());
-    int end_ms = std::atoi(_properties.at("EndMS").c_str());
-    int frame_count = std::atoi(_properties.at("Frames").c_str());
-    if (frame_count < 1) frame_count = 1;
-    long duration_ms = end_ms - start_ms;
-    long fps = (duration_ms * 1000) / (frame_count * 1000);
+    bool timeDependent = GetIntProperty(_properties, "TimeDependent") == 1;
+    if (timeDependent && start_ms != effect->GetStartTimeMS()) return false;
+
+    // the frames were drawn from the model's own faces/states/channels
+    if (GetIntProperty(_properties, "ModelDependent") == 1) {
+        const std::string name = buffer != nullptr ? buffer->GetModelName() : effect->GetParentEffectLayer()->GetParentElement()->GetFullName();
+        auto mn = _properties.find(buffer != nullptr ? "Model" : "Element");
+        if (mn == _properties.end() || mn->second != name) return false;
+    }
 
     if (buffer != nullptr)
     {
-        int seqFPS = buffer->frameTimeInMs;
-        if (seqFPS != fps) {
-            spdlog::get("render")->info("RenderCache no match because FPS {} doesn't match expected {}", fps, seqFPS);
+        int fps = GetIntProperty(_properties, "FrameMS");
+        if (buffer->frameTimeInMs != fps) {
+            spdlog::get("render")->info("RenderCache no match because FPS {} doesn't match expected {}", fps, buffer->frameTimeInMs);
             return false;
         }
-        std::string mname = GetModelName(buffer);
-        if ((size_t)_frameSize.at(mname) != sizeof(xlColor) * buffer->GetPixelCount()) return false;
+        if (GetIntProperty(_properties, "BufferWi") != buffer->BufferWi || GetIntProperty(_properties, "BufferHt") != buffer->BufferHt) return false;
+        // random draws are seeded from the model, layer and start (RenderBuffer::computeRandomBaseSeed) so
+        // until we know the effect draws none its frames only fit an effect with the same seed
+        if (_usesRandom != 0 && _randomSeed != buffer->GetRandomBaseSeed()) return false;
     }
 
-    if (std::atoi(_properties.at("EndMS").c_str()) != effect->GetEndTimeMS()) return false;
-    if (_properties.at("Effect") != effect->GetEffectName()) return false;
-
     // We only log failures from here on because they should be relatively rare
+    auto content = GetRenderedContent(effect);
 
-    // 8 is the number of predefined tags
-    if (_properties.size() - 7 != effect->GetSettings().size() + effect->GetPaletteMap().size())
+    size_t count = 0;
+    for (const auto& it : _properties)
     {
-        spdlog::get("render")->debug("RenderCache no match because number of properties is different.");
-        return false;
-    }
-
-    for (const auto& it : effect->GetSettings())
-    {
-        if (_properties.find(it.first) == _properties.end()) {
+        if (IsDescriptiveProperty(it.first)) continue;
+        ++count;
+        auto c = content.find(it.first);
+        if (c == content.end()) {
             spdlog::get("render")->debug("RenderCache no match because proprerty not present: " + it.first);
             return false;
         }
-        else
+        if (c->second != it.second)
         {
-            if (_properties.at(it.first) != it.second)
-            {
-                spdlog::get("render")->debug("RenderCache no match because proprerty different: " + it.first);
-                return false;
-            }
+            spdlog::get("render")->debug("RenderCache no match because proprerty different: " + it.first);
+            return false;
         }
     }
 
-    for (const auto& it : effect->GetPaletteMap())
+    if (count != content.size())
     {
-        if (_properties.find(it.first) == _properties.end()) {
-            spdlog::get("render")->debug("RenderCache no match because pallette map not present: " + it.first);
-            return false;
-        }
-        else
-        {
-            if (_properties.at(it.first) != it.second)
-            {
-                spdlog::get("render")->debug("RenderCache no match because pallette map different: " + it.first);
-                return false;
-            }
+        spdlog::get("render")->debug("RenderCache no match because number of properties is different.");
+        return false;
+    }
+
+    return true;
+}
+
+void RenderCacheItem::Release(bool deleteFile)
+{
+    _renderCache->ReleaseItem(this, deleteFile);
+}
+
+// The frames for the model rendering into buffer. A complete item holding a single model's frames
+// also serves any other model with the same frame size as the render is identical.
+const RenderCacheItem::ModelFrames* RenderCacheItem::FindFrames(RenderBuffer* buffer) const
+{
+    auto it = _frames.find(GetModelName(buffer));
+    if (it == _frames.end()) {
+        if (!_complete || _frames.size() != 1) return nullptr;
+        it = _frames.begin();
+    }
+    if ((size_t)it->second.frameSize != sizeof(xlColor) * buffer->GetPixelCount()) return nullptr;
+    return &it->second;
+}
+
+// Packs a block whose frames are all rendered, freeing the raw frames
+bool RenderCacheItem::PackBlock(ModelFrames& mf, size_t block)
+{
+    if (mf.blocks[block].IsPacked()) return true;
+
+    size_t first = block * mf.blockFrames;
+    size_t last = std::min(first + mf.blockFrames, mf.FrameCount());
+    for (size_t f = first; f < last; ++f) {
+        if (mf.raw[f] == nullptr) return false;
+    }
+
+    // frames in a block are mostly the same as the one before so the differences are mostly zero
+    size_t fs = mf.frameSize;
+    std::vector<uint8_t> delta((last - first) * fs);
+    memcpy(delta.data(), mf.raw[first], fs);
+    for (size_t f = first + 1; f < last; ++f) {
+        const uint8_t* prev = mf.raw[f - 1];
+        const uint8_t* cur = mf.raw[f];
+        uint8_t* out = &delta[(f - first) * fs];
+        for (size_t i = 0; i < fs; ++i) {
+            out[i] = cur[i] - prev[i];
         }
     }
 
+    PackedBlock& pb = mf.blocks[block];
+#ifndef NO_ZSTD
+    pb.owned.resize(ZSTD_compressBound(delta.size()));
+    size_t sz = ZSTD_compress(pb.owned.data(), pb.owned.size(), delta.data(), delta.size(), RENDER_CACHE_ZSTD_LEVEL);
+    if (ZSTD_isError(sz)) {
+        spdlog::get("render")->warn("RenderCacheItem::PackBlock failed to compress {}: {}", _cacheFile, ZSTD_getErrorName(sz));
+        pb.owned.clear();
+        return false;
+    }
+    pb.owned.resize(sz);
+    pb.owned.shrink_to_fit();
+#else
+    pb.owned = std::move(delta);
+#endif
+    pb.frames = (uint32_t)(last - first);
+    pb.size = pb.owned.size();
+    pb.mapped = nullptr;
+
+    for (size_t f = first; f < last; ++f) {
+        free(mf.raw[f]);
+        mf.raw[f] = nullptr;
+    }
     return true;
 }
 
+// Returns the frame, unpacking its block if need be. The pointer is valid until the next call for this model.
+const uint8_t* RenderCacheItem::UnpackFrame(const ModelFrames& mf, size_t frame)
+{
+    if (frame >= mf.FrameCount()) return nullptr;
+    if (mf.raw[frame] != nullptr) return mf.raw[frame];
+
+    size_t block = frame / mf.blockFrames;
+    const PackedBlock& pb = mf.blocks[block];
+    if (!pb.IsPacked() || frame - block * mf.blockFrames >= pb.frames) return nullptr;
+
+    size_t fs = mf.frameSize;
+    if (mf.unpackedBlock != (int)block) {
+        size_t len = (size_t)pb.frames * fs;
+        mf.unpacked.resize(len);
+#ifndef NO_ZSTD
+        size_t sz = ZSTD_decompress(mf.unpacked.data(), len, pb.Data(), pb.size);
+        if (ZSTD_isError(sz) || sz != len) {
+            mf.unpackedBlock = -1;
+            return nullptr;
+        }
+#else
+        if (pb.size != len) {
+            mf.unpackedBlock = -1;
+            return nullptr;
+        }
+        memcpy(mf.unpacked.data(), pb.Data(), len);
+#endif
+        for (size_t f = 1; f < pb.frames; ++f) {
+            const uint8_t* prev = &mf.unpacked[(f - 1) * fs];
+            uint8_t* cur = &mf.unpacked[f * fs];
+            for (size_t i = 0; i < fs; ++i) {
+                cur[i] += prev[i];
+            }
+        }
+        mf.unpackedBlock = (int)block;
+    }
+    return &mf.unpacked[(frame - block * mf.blockFrames) * fs];
+}
+
 void RenderCacheItem::Delete()
 {
     
@@ -706,11 +913,18 @@ void RenderCacheItem::AddFrame(RenderBuffer* buffer)
         return;
     }
 
+    std::unique_lock<std::recursive_mutex> lock(_frameLock);
     if (_purged) {
         return;
     }
+
+    std::string mname = GetModelName(buffer);
+    if (_complete && _frames.find(mname) == _frames.end() && _frames.size() == 1) {
+        // another model already rendered this effect and GetFrame serves it from that
+        return;
+    }
     if (_mmap) {
-        // need to undo the mmap so we can append frames
+        // need to undo the mmap as the file gets rewritten when the new frames are saved
         unmmap();
     }
     // allow up to 3 times physical memory
@@ -722,54 +936,59 @@ void RenderCacheItem::AddFrame(RenderBuffer* buffer)
     }
 
     int frame = buffer->curPeriod - buffer->curEffStartPer;
-
-    std::string mname = GetModelName(buffer);
-    if (_frameSize.find(mname) == _frameSize.end()) {
-        _frameSize[mname] = sizeof(xlColor) * buffer->GetPixelCount();
-    } else {
-        if ((size_t)_frameSize[mname] != sizeof(xlColor) * buffer->GetPixelCount()) {
-            // the buffer size has changed ... we dont support this.
-            spdlog::get("render")->warn("RenderCacheItem::AddFrame buffer size changed ... we dont support this.");
+    if (frame < 0) {
+        return;
+    }
+    size_t frameSize = sizeof(xlColor) * buffer->GetPixelCount();
+    size_t frameCount = std::max(frame + 1, buffer->curEffEndPer - buffer->curEffStartPer + 1);
+
+    auto mit = _frames.find(mname);
+    if (mit == _frames.end()) {
+        size_t totFramesSize = frameCount * frameSize;
+        constexpr size_t MAX = 4LL * 1024LL * 1024LL * 1024LL;
+        if (totFramesSize > MAX) {
+            // more that 4GB in size, we're not going to cache this effect
             PurgeFrames();
             return;
         }
-    }
-
-    size_t totFramesSize = buffer->curEffEndPer - buffer->curEffStartPer + 1;
-    totFramesSize *= _frameSize[mname];
-    constexpr size_t MAX = 4LL * 1024LL * 1024LL * 1024LL;
-    if (totFramesSize > MAX) {
-        // more that 4GB in size, we're not going to cache this effect
+        ModelFrames mf;
+        mf.frameSize = frameSize;
+        mf.blockFrames = (uint32_t)std::clamp(RENDER_CACHE_BLOCK_BYTES / frameSize, (size_t)1, RENDER_CACHE_MAX_BLOCK_FRAMES);
+        mit = _frames.emplace(mname, std::move(mf)).first;
+        _complete = false;
+    } else if ((size_t)mit->second.frameSize != frameSize) {
+        // the buffer size has changed ... we dont support this.
+        spdlog::get("render")->warn("RenderCacheItem::AddFrame buffer size changed ... we dont support this.");
         PurgeFrames();
         return;
     }
 
-    if (_frames.find(mname) == _frames.end()) {
-        std::vector<unsigned char *> n;
-        _frames[mname] = n;
+    ModelFrames& mf = mit->second;
+    if (frameCount > mf.FrameCount()) {
+        mf.raw.resize(frameCount, nullptr);
+        mf.blocks.resize((frameCount + mf.blockFrames - 1) / mf.blockFrames);
     }
-
-    if ((size_t)frame >= _frames.at(mname).size()) {
-        int maxframe = std::max(frame+1,buffer->curEffEndPer - buffer->curEffStartPer + 1);
-        _frames.at(mname).resize(maxframe);
+    if (mf.HasFrame(frame)) {
+        // we already have this frame and it renders the same every time
+        return;
     }
 
-    unsigned char* frameBuffer = (unsigned char *)malloc(_frameSize.at(mname));
+    unsigned char* frameBuffer = (unsigned char *)malloc(frameSize);
     if (frameBuffer == nullptr) {
         spdlog::get("render")->warn("RenderCacheItem::AddFrame failed to allocate frameBuffer.");
         PurgeFrames();
         assert(false);
         return;
     }
-    memcpy(frameBuffer, buffer->GetPixels(), _frameSize.at(mname));
-
-    if (_frames.at(mname)[frame] != nullptr) {
-        free(_frames.at(mname)[frame]);
-        _frames.at(mname)[frame] = nullptr;
+    memcpy(frameBuffer, buffer->GetPixels(), frameSize);
+    mf.raw[frame] = frameBuffer;
+    _dirty = true;
+    if (buffer->UsedRandom()) {
+        _usesRandom = 1;
     }
 
-    _frames.at(mname)[frame] = frameBuffer;
-    _dirty = true;
+    // pack the block as soon as it is complete so the raw frames dont hang around for the whole effect
+    PackBlock(mf, frame / mf.blockFrames);
 
     // Frames can arrive out of order (frame-parallel windows render a chunk
     // concurrently), so the end-of-effect frame is not necessarily the last
@@ -779,10 +998,9 @@ void RenderCacheItem::AddFrame(RenderBuffer* buffer)
         _sawEndFrame = true;
     }
     if (_sawEndFrame) {
-        // if multi models in this cache then only call save when none of them have null pointers at the end
+        // if multi models in this cache then only call save when none of them are missing frames at the end
         for (const auto& itm : _frames) {
-            if (itm.second.size() == 0 || itm.second.back() == nullptr) {
-                //spdlog::get("render")->warn("RenderCacheItem::AddFrame save abandoned due to null frame.");
+            if (itm.second.FrameCount() == 0 || !itm.second.HasFrame(itm.second.FrameCount() - 1)) {
                 return;
             }
         }
@@ -792,34 +1010,31 @@ void RenderCacheItem::AddFrame(RenderBuffer* buffer)
 
 bool RenderCacheItem::GetFrame(RenderBuffer* buffer)
 {
-    if (_purged || buffer == nullptr) return false;
+    if (buffer == nullptr) return false;
 
-    std::string mname = GetModelName(buffer);
-    if (_frameSize.find(mname) == _frameSize.end()) {
-        spdlog::get("render")->info("RenderCache::GetFrame on model " + mname + " failed due to number of frames difference.");
+    std::unique_lock<std::recursive_mutex> lock(_frameLock);
+    if (_purged) return false;
+
+    auto modelFrames = FindFrames(buffer);
+    if (modelFrames == nullptr) {
         return false;
     }
 
-    auto framesIt = _frames.find(mname);
-    if (framesIt == _frames.end()) {
+    int frame = buffer->curPeriod - buffer->curEffStartPer;
+    if (frame < 0 || buffer->GetPixels() == nullptr) {
         return false;
     }
-    auto const& modelFrames = framesIt->second;
-    if ((size_t)_frameSize.at(mname) != (sizeof(xlColor) * buffer->GetPixelCount())) {
-        spdlog::get("render")->info("RenderCache::GetFrame on model " + mname + " failed due to frame size difference.");
+    const uint8_t* pc = UnpackFrame(*modelFrames, frame);
+    if (pc == nullptr) {
         return false;
     }
-
-    int frame = buffer->curPeriod - buffer->curEffStartPer;
-    if (frame >= 0 && (size_t)frame < modelFrames.size() && modelFrames[frame]) {
-        // its in memory ... read it from there
-        unsigned char* pc = modelFrames[frame];
-        if (buffer->GetPixels() != nullptr) {
-            memcpy(static_cast<void*>(buffer->GetPixels()), pc, _frameSize.at(mname));
-            return true;
-        }
+    memcpy(static_cast<void*>(buffer->GetPixels()), pc, modelFrames->frameSize);
+    if ((size_t)frame + 1 == modelFrames->FrameCount()) {
+        // done with this effect for now, dont hold onto the unpacked block
+        modelFrames->unpacked = std::vector<uint8_t>();
+        modelFrames->unpackedBlock = -1;
     }
-    return false;
+    return true;
 }
 
 void RenderCacheItem::Touch() const
@@ -830,6 +1045,7 @@ void RenderCacheItem::Touch() const
 
 void RenderCacheItem::Save()
 {
+    std::unique_lock<std::recursive_mutex> lock(_frameLock);
     if (_purged) return;
     if (!_dirty) return;
     
@@ -842,25 +1058,43 @@ void RenderCacheItem::Save()
 
     char zero = 0x00;
 
-    // check all the data is there
-    for (const auto& itm : _frames) {
-        for (const auto& it : itm.second) {
+    // check all the data is there and packed
+    for (auto& itm : _frames) {
+        for (size_t b = 0; b < itm.second.blocks.size(); ++b) {
             // we are missing data
-            //assert(false);
-            if (it == nullptr) return;
+            if (!PackBlock(itm.second, b)) return;
         }
     }
 
+    // every frame is here so if none drew a random number none ever will
+    if (_usesRandom != 1) {
+        _usesRandom = 0;
+    }
+
     FILE* fp = std::fopen(_cacheFile.c_str(), "wb");
 
     if (fp != nullptr) {
-        _properties["Models"] = std::to_string((int)_frames.size());
-        // write the header fields
-        for (const auto& it : _properties) {
-            std::fwrite(it.first.c_str(), 1, it.first.size(), fp);
+        // write the header fields. _properties is read by IsMatch under the index lock rather than _frameLock
+        // so it is never changed once the item is created, what changes as frames are added is written separately
+        auto writeField = [fp, &zero](const std::string& key, const std::string& value) {
+            std::fwrite(key.c_str(), 1, key.size(), fp);
             std::fwrite(&zero, 1, 1, fp);
-            std::fwrite(it.second.c_str(), 1, it.second.size(), fp);
+            std::fwrite(value.c_str(), 1, value.size(), fp);
             std::fwrite(&zero, 1, 1, fp);
+        };
+        const std::map<std::string, std::string> saved = {
+            { "Models", std::to_string((int)_frames.size()) },
+            { "Encoding", RENDER_CACHE_ENCODING },
+            { "RandomSeed", std::to_string(_randomSeed) },
+            { "UsesRandom", std::to_string(_usesRandom.load()) }
+        };
+        for (const auto& it : _properties) {
+            if (saved.find(it.first) == saved.end()) {
+                writeField(it.first, it.second);
+            }
+        }
+        for (const auto& it : saved) {
+            writeField(it.first, it.second);
         }
 
         std::fwrite("RC_HEADEREND", 1, 12, fp);
@@ -869,26 +1103,35 @@ void RenderCacheItem::Save()
         for (const auto& it : _frames) {
             std::fwrite(it.first.c_str(), 1, it.first.size(), fp);
             std::fwrite(&zero, 1, 1, fp);
-            std::string numFrames = std::to_string((int)it.second.size());
+            std::string numFrames = std::to_string((int)it.second.FrameCount());
             std::fwrite(numFrames.c_str(), 1, numFrames.size(), fp);
             std::fwrite(&zero, 1, 1, fp);
-            std::string fsize = std::to_string(_frameSize.at(it.first));
+            std::string fsize = std::to_string(it.second.frameSize);
             std::fwrite(fsize.c_str(), 1, fsize.size(), fp);
             std::fwrite(&zero, 1, 1, fp);
         }
+
+        // the block index, frames per block and then the packed size of each block
+        for (const auto& it : _frames) {
+            uint32_t blockFrames = it.second.blockFrames;
+            std::fwrite(&blockFrames, sizeof(blockFrames), 1, fp);
+            for (const auto& b : it.second.blocks) {
+                uint64_t size = b.size;
+                std::fwrite(&size, sizeof(size), 1, fp);
+            }
+        }
         _firstFrameOffset = std::ftell(fp);
 
-        // write the frames
+        // write the blocks
         for (const auto& itm : _frames) {
-            for (const auto& it : itm.second) {
-                assert(it != nullptr);
-                if (it != nullptr) {
-                    std::fwrite(it, 1, _frameSize.at(itm.first), fp);
-                }
+            for (const auto& b : itm.second.blocks) {
+                std::fwrite(b.Data(), 1, b.size, fp);
             }
         }
 
         std::fclose(fp);
+        _dirty = false;
+        _complete = true;
 
         remmap();
     } else {
@@ -898,14 +1141,13 @@ void RenderCacheItem::Save()
 
 bool RenderCacheItem::IsDone(RenderBuffer* buffer) const
 {
-    if (_purged || buffer == nullptr) return false;
+    if (buffer == nullptr) return false;
+    std::unique_lock<std::recursive_mutex> lock(_frameLock);
+    if (_purged) return false;
     int frame = buffer->curPeriod - buffer->curEffStartPer;
-    std::string mname = GetModelName(buffer);
-    auto it = _frames.find(mname);
-    if (it == _frames.end()) return false;
-    auto const& modelFrames = it->second;
-    if (frame < 0 || (size_t)frame >= modelFrames.size()) return false;
-    return modelFrames[frame] != nullptr;
+    auto modelFrames = FindFrames(buffer);
+    if (modelFrames == nullptr || frame < 0) return false;
+    return modelFrames->HasFrame(frame);
 }
 
 RenderCacheItem::RenderCacheItem(RenderCache* renderCache, const std::string& filename) : _renderCache(renderCache)
@@ -949,8 +1191,58 @@ RenderCacheItem::RenderCacheItem(RenderCache* renderCache, const std::string& fi
         }
         ps += strlen(ps) + 1;
 
+        auto enc = _properties.find("Encoding");
+        if (_properties.find("FrameMS") == _properties.end() || _properties.find("BufferWi") == _properties.end() ||
+            enc == _properties.end() || enc->second != RENDER_CACHE_ENCODING) {
+            // written before the cache was content addressed and packed (or by a build without zstd), it would never be found again
+            spdlog::get("render")->debug("Cache file {} is an old format, removing it.", (const char*)filename.c_str());
+            std::fclose(fp);
+            std::error_code ec;
+            fs::remove(_cacheFile, ec);
+            _purged = true;
+            return;
+        }
+
+        std::map<std::string, std::string> content;
+        for (const auto& it : _properties) {
+            if (!IsDescriptiveProperty(it.first) && !StartsWith(it.first, "X_")) {
+                content[it.first] = it.second;
+            }
+        }
+        int start_ms = GetIntProperty(_properties, "StartMS");
+        _key = RenderCache::GetContentKey(_properties["Effect"], content,
+                                          GetIntProperty(_properties, "Frames"),
+                                          GetIntProperty(_properties, "FrameMS"),
+                                          GetIntProperty(_properties, "BufferWi"),
+                                          GetIntProperty(_properties, "BufferHt"),
+                                          GetIntProperty(_properties, "TimeDependent") == 1 ? start_ms : -1,
+                                          GetIntProperty(_properties, "ModelDependent") == 1 ? _properties["Model"] : std::string());
+        _complete = true;
+        // written before the cache knew about random draws: treat it as drawing them
+        _randomSeed = std::strtoull(_properties["RandomSeed"].c_str(), nullptr, 10);
+        _usesRandom = _properties.find("UsesRandom") == _properties.end() ? 1 : GetIntProperty(_properties, "UsesRandom");
+
+        // the name must be the one GetItem gives an item with this key and seed, anything else is left over from
+        // an older naming scheme or was written for another item
+        std::string stem = fnPath.stem().string();
+        std::string expected = fs::path(GetCacheFileName(_properties["Effect"], _key, _randomSeed, 0)).stem().string();
+        bool belongs = stem == expected;
+        if (!belongs && StartsWith(stem, expected + "_")) {
+            std::string n = stem.substr(expected.size() + 1);
+            belongs = !n.empty() && std::all_of(n.begin(), n.end(), [](char c) { return c >= '0' && c <= '9'; });
+        }
+        if (!belongs) {
+            spdlog::get("render")->debug("Cache file {} does not belong to the item it holds, removing it.", (const char*)filename.c_str());
+            std::fclose(fp);
+            std::error_code ec;
+            fs::remove(_cacheFile, ec);
+            _purged = true;
+            return;
+        }
+
         int models = std::atoi(_properties["Models"].c_str());
 
+        std::vector<ModelFrames*> order;
         for (int i = 0; i < models; i++) {
             std::string model(ps);
             ps += strlen(ps) + 1;
@@ -961,64 +1253,63 @@ RenderCacheItem::RenderCacheItem(RenderCache* renderCache, const std::string& fi
             ps += strlen(ps) + 1;
             long fsz = std::strtol(frameSize.c_str(), nullptr, 10);
 
-            std::vector<unsigned char *> n;
-            _frames[model] = n;
-            _frames.at(model).resize(frameCount);
-            _frameSize[model] = fsz;
+            ModelFrames& mf = _frames[model];
+            mf.frameSize = fsz;
+            mf.raw.resize(frameCount, nullptr);
+            order.push_back(&mf);
         }
 
-        _firstFrameOffset = ps - headerBuffer;
-#ifdef USE_MMAP_RENDERCACHE
-        if (renderCache->UseMMap()) {
-            struct stat st;
-            fstat(fileno(fp), &st);
-            _mmapSize = st.st_size;
-            _mmap = (uint8_t*)mmap(nullptr, _mmapSize, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
-
-            if (_mmap == MAP_FAILED) {
-                _mmap = nullptr;
-                _mmapSize = 0;
-            } else {
-                // validate that the file is large enough for all frame data
-                size_t expectedSize = _firstFrameOffset;
-                for (auto& itm : _frames) {
-                    expectedSize += itm.second.size() * _frameSize.at(itm.first);
-                }
-                if (_mmapSize < expectedSize) {
-                    spdlog::get("render")->warn("Cache file {} is truncated (expected {} bytes, got {}). Skipping mmap.",
-                        filename, expectedSize, _mmapSize);
-                    munmap(_mmap, _mmapSize);
-                    _mmap = nullptr;
-                    _mmapSize = 0;
-                    // fall through to fread path
-                } else {
-                    size_t cur = _firstFrameOffset;
-                    for (auto& itm : _frames) {
-                        for (int i = 0; i < (int)itm.second.size(); i++) {
-                            itm.second[i] = &_mmap[cur];
-                            cur += _frameSize.at(itm.first);
-                        }
-                    }
+        // read the block index
+        std::fseek(fp, ps - headerBuffer, SEEK_SET);
+        for (auto mf : order) {
+            uint32_t blockFrames = 0;
+            if (std::fread(&blockFrames, sizeof(blockFrames), 1, fp) != 1 || blockFrames == 0 || mf->frameSize <= 0) {
+                spdlog::get("render")->debug("Cache file {} appears corrupt.", (const char*)filename.c_str());
+                _purged = true;
+                std::fclose(fp);
+                return;
+            }
+            mf->blockFrames = blockFrames;
+            mf->blocks.resize((mf->FrameCount() + blockFrames - 1) / blockFrames);
+            for (size_t b = 0; b < mf->blocks.size(); ++b) {
+                uint64_t size = 0;
+                if (std::fread(&size, sizeof(size), 1, fp) != 1) {
+                    spdlog::get("render")->debug("Cache file {} appears corrupt.", (const char*)filename.c_str());
+                    _purged = true;
                     std::fclose(fp);
                     return;
                 }
+                mf->blocks[b].size = size;
+                mf->blocks[b].frames = (uint32_t)std::min((size_t)blockFrames, mf->FrameCount() - b * blockFrames);
             }
         }
-#endif
-        std::fseek(fp, _firstFrameOffset, SEEK_SET);
-        for (auto& itm : _frames) {
-            for (int i = 0; i < (int)itm.second.size(); i++) {
-                uint8_t* frameBuffer = (uint8_t *)malloc(_frameSize.at(itm.first));
+        _firstFrameOffset = std::ftell(fp);
 
-                if (frameBuffer == nullptr) {
+#ifdef USE_MMAP_RENDERCACHE
+        if (renderCache->UseMMap()) {
+            std::fclose(fp);
+            remmap();
+            if (_mmap != nullptr) {
+                return;
+            }
+            spdlog::get("render")->warn("Cache file {} could not be mapped, reading it instead.", filename);
+            fp = std::fopen(_cacheFile.c_str(), "rb");
+            if (fp == nullptr) {
+                _purged = true;
+                return;
+            }
+            std::fseek(fp, _firstFrameOffset, SEEK_SET);
+        }
+#endif
+        for (auto mf : order) {
+            for (auto& b : mf->blocks) {
+                b.owned.resize(b.size);
+                if (std::fread(b.owned.data(), 1, b.size, fp) != b.size) {
                     std::fclose(fp);
                     PurgeFrames();
-                    spdlog::get("render")->debug("Render Cache Item file {} fails due to memory allocation issue.", filename);
+                    spdlog::get("render")->debug("Render Cache Item file {} is truncated.", filename);
                     return;
                 }
-
-                std::fread(frameBuffer, 1, _frameSize.at(itm.first), fp);
-                itm.second[i] = frameBuffer;
             }
         }
         std::fclose(fp);
@@ -1029,11 +1320,10 @@ void RenderCacheItem::unmmap() {
 #ifdef USE_MMAP_RENDERCACHE
     if (_mmap) {
         for (auto& it : _frames) {
-            for (int x = it.second.size() - 1; x >= 0; --x) {
-                if (it.second[x]) {
-                    uint8_t* frameBuffer = (uint8_t *)malloc(_frameSize.at(it.first));
-                    memcpy(frameBuffer, it.second[x], _frameSize.at(it.first));
-                    it.second[x] = frameBuffer;
+            for (auto& b : it.second.blocks) {
+                if (b.mapped != nullptr) {
+                    b.owned.assign(b.mapped, b.mapped + b.size);
+                    b.mapped = nullptr;
                 }
             }
         }
@@ -1060,10 +1350,12 @@ void RenderCacheItem::remmap() {
             _mmapSize = 0;
             return;
         }
-        // validate file is large enough for all frame data
+        // validate file is large enough for all the blocks
         size_t expectedSize = _firstFrameOffset;
         for (auto& itm : _frames) {
-            expectedSize += itm.second.size() * _frameSize.at(itm.first);
+            for (auto& b : itm.second.blocks) {
+                expectedSize += b.size;
+            }
         }
         if (_mmapSize < expectedSize) {
             munmap(_mmap, _mmapSize);
@@ -1073,13 +1365,10 @@ void RenderCacheItem::remmap() {
         }
         size_t cur = _firstFrameOffset;
         for (auto& itm : _frames) {
-            for (int i = 0; i < (int)itm.second.size(); i++) {
-                if (itm.second[i]) {
-                    free(itm.second[i]);
-                    itm.second[i] = nullptr;
-                }
-                itm.second[i] = &_mmap[cur];
-                cur += _frameSize.at(itm.first);
+            for (auto& b : itm.second.blocks) {
+                b.mapped = &_mmap[cur];
+                b.owned = std::vector<uint8_t>();
+                cur += b.size;
             }
         }
     }
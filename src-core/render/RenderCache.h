@@ -10,9 +10,12 @@
  * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
  **************************************************************/
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <list>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <mutex>
 #include <shared_mutex>
@@ -24,30 +27,88 @@ class RenderCache;
 class SequenceElements;
 class RenderBuffer;
 
+// Cached frames for one distinct effect render.
+//
+// Items are content addressed: an item is identified by what was rendered
+// (effect, settings, palette, duration, frame time and buffer size) rather than
+// where, so an effect moved in time or an identical effect on another model of
+// the same buffer size reuses the same frames. Effects whose output depends on
+// when they run (audio, timing tracks) also key on their start time. An effect
+// that draws from the buffer's RNG renders differently on every model, layer and
+// start time, so an item is only shared beyond its own RNG seed once it is
+// complete and no frame drew a random number. An item may be in use by several
+// effects at once.
 class RenderCacheItem
 {
+    // A run of consecutive frames packed together. Each frame after the first is stored as the
+    // bytewise difference from the one before it and the run is then zstd compressed, so a
+    // frame is recovered by unpacking just its block.
+    struct PackedBlock {
+        uint32_t frames = 0;
+        size_t size = 0;
+        const uint8_t* mapped = nullptr; // into the item's mmap of the cache file
+        std::vector<uint8_t> owned;
+        bool IsPacked() const { return size != 0; }
+        const uint8_t* Data() const { return mapped != nullptr ? mapped : owned.data(); }
+    };
+
+    struct ModelFrames {
+        long frameSize = 0;
+        uint32_t blockFrames = 1;
+        std::vector<uint8_t*> raw;         // one per frame, null once packed or if not rendered yet
+        std::vector<PackedBlock> blocks;   // one per blockFrames frames
+        mutable int unpackedBlock = -1;    // the block currently held in unpacked
+        mutable std::vector<uint8_t> unpacked;
+
+        size_t FrameCount() const { return raw.size(); }
+        bool HasFrame(size_t frame) const
+        {
+            if (frame >= raw.size()) return false;
+            if (raw[frame] != nullptr) return true;
+            const PackedBlock& pb = blocks[frame / blockFrames];
+            return pb.IsPacked() && frame % blockFrames < pb.frames;
+        }
+    };
+
     RenderCache* _renderCache = nullptr;
     std::string _cacheFile;
     std::string _effectName;
     std::map<std::string, std::string> _properties;
-    std::map<std::string, std::vector<uint8_t *>> _frames;
-    std::map<std::string, long> _frameSize;
-    bool _purged = false;
+    std::map<std::string, ModelFrames> _frames;
+    std::atomic<bool> _purged{ false }; // read by IsMatch under the index lock
     bool _dirty = false;
     bool _sawEndFrame = false;
+    bool _complete = false; // every frame of every model is present
+    uint64_t _randomSeed = 0; // RenderBuffer::GetRandomBaseSeed of the effect that created the item
+    std::atomic<int> _usesRandom{ -1 }; // -1 not known until saved, 0 no frame drew a random number, 1 some did
     static std::string GetModelName(RenderBuffer* buffer);
 
-    
+    // guarded by RenderCache's index lock
+    uint64_t _key = 0;
+    int _users = 0;
+    bool _indexed = false;
+
+    // effects sharing this item can render into it concurrently
+    mutable std::recursive_mutex _frameLock;
+
     uint8_t *_mmap = nullptr;
     size_t _mmapSize = 0;
-    size_t _firstFrameOffset = 0;
+    size_t _firstFrameOffset = 0; // where the packed block data starts in the cache file
 
     void unmmap();
     void remmap();
+    const ModelFrames* FindFrames(RenderBuffer* buffer) const;
+    bool PackBlock(ModelFrames& mf, size_t block);
+    static const uint8_t* UnpackFrame(const ModelFrames& mf, size_t frame);
+
+    friend class RenderCache;
 
 public:
     RenderCacheItem(RenderCache* renderCache, const std::string& file);
-    RenderCacheItem(RenderCache* renderCache, Effect* effect, RenderBuffer* buffer);
+    RenderCacheItem(RenderCache* renderCache, Effect* effect, RenderBuffer* buffer, uint64_t key, bool timeDependent,
+                    bool modelDependent, const std::string& cacheFile);
+    // the file name of the nth item with this key and seed
+    static std::string GetCacheFileName(const std::string& effectName, uint64_t key, uint64_t randomSeed, int n);
     virtual ~RenderCacheItem();
     bool GetFrame(RenderBuffer* buffer);
     void AddFrame(RenderBuffer* buffer);
@@ -55,26 +116,22 @@ public:
     bool IsPurged() const { return _purged; }
     bool IsMatch(Effect* effect, RenderBuffer* buffer);
     void Delete();
+    // called by an effect that no longer uses this item
+    void Release(bool deleteFile);
     void Save();
     void Touch() const;
     bool IsDone(RenderBuffer* buffer) const;
+    uint64_t GetKey() const { return _key; }
     const std::string& Description() const { return _cacheFile; }
     const std::string& EffectName() const { return _effectName; }
 };
 
 class RenderCache
 {
-    class PerEffectCache {
-    public:
-        PerEffectCache() {}
-        ~PerEffectCache() {}
-        std::list<RenderCacheItem*> cache;
-        std::shared_mutex lock;
-    };
-    
-    std::recursive_mutex  _cacheLock;
 	std::string _cacheFolder;
-	std::map<std::string, PerEffectCache*> _cache;
+    // content key -> items, more than one only on a hash collision
+    std::shared_mutex _indexLock;
+    std::unordered_multimap<uint64_t, RenderCacheItem*> _index;
     std::string _enabled; // Disabled | Locked Only | Enabled
     std::mutex _loadMutex;
     std::thread _loadThread;
@@ -84,8 +141,10 @@ class RenderCache
     void Close();
     void LoadCache();
     
-    PerEffectCache* GetPerEffectCache(const std::string &s);
     void EnforceMaximumSize();
+    std::vector<RenderCacheItem*> GetIdleItems();
+    void ReleaseItem(RenderCacheItem* item, bool deleteFile);
+    friend class RenderCacheItem;
 
     public:
 		RenderCache();
@@ -93,7 +152,8 @@ class RenderCache
         inline bool IsEnabled() const { return _enabled != "Disabled"; }
         void SetRenderCacheFolder(const std::string& path);
         void SetSequence(const std::string& path, const std::string& sequenceFile);
-		RenderCacheItem* GetItem(Effect* effect, RenderBuffer* buffer);
+        // timeDependent: the render depends on where in the sequence the effect sits so must only be shared at the same start time
+		RenderCacheItem* GetItem(Effect* effect, RenderBuffer* buffer, bool timeDependent, bool modelDependent);
         void RemoveItem(RenderCacheItem *item);
         std::string GetCacheFolder() const { return _cacheFolder; }
         void CleanupCache(SequenceElements* sequenceElements);
@@ -106,4 +166,8 @@ class RenderCache
         bool IsEffectOkForCaching(Effect* effect) const;
         bool UseMMap() const;
         void SetMaximumSizeMB(size_t mb);
+
+        // hash of everything that determines an effect's rendered frames
+        static uint64_t GetContentKey(const std::string& effectName, const std::map<std::string, std::string>& content,
+                                      int frames, int frameMS, int bufferWi, int bufferHt, int startMS, const std::string& model);
 };
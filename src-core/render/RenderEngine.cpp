@@ -16,6 +16,7 @@
 #include <filesystem>
 #include <spdlog/fmt/fmt.h>
 #include <array>
+#include <atomic>
 #include <functional>
 #include <mutex>
 #include <thread>
@@ -64,7 +65,11 @@ static const bool xldbgEffSum = (getenv("XL_EFFSUM") != nullptr);
 // XL_RENDER_PROFILE=1 diagnostic: accumulate per-row / per-effect render timing
 // and dump aggregate tables to stderr when the batch completes.  Checked before
 // any clock call so it costs nothing when unset (see RenderProfile.h).
-static const bool profRender = (getenv("XL_RENDER_PROFILE") != nullptr);
+// profRender can also be switched on programmatically (EnableRenderProfile) by
+// a tool that consumes the numbers itself; only the env var prints the tables.
+// Atomic as it can be switched on while render threads are reading it.
+static const bool profRenderDump = (getenv("XL_RENDER_PROFILE") != nullptr);
+static std::atomic<bool> profRender{ profRenderDump };
 
 // XL_VERIFY_STATELESS=1 diagnostic: for every effect that declares itself Pure
 // (GetEffectiveFrameParallelism == Pure), re-render each frame a second time
@@ -499,6 +504,8 @@ public:
             currentFrame(0), abort(false)
     {
         name = "";
+        mainBuffer = nullptr;
+        numLayers = 0;
         if (row != nullptr) {
             // Hold ~ModelElement's guard open for this job's whole lifetime -
             // queued, parked, suspended, or running (paired in CompleteJob /
@@ -506,151 +513,219 @@ public:
             row->AttachRenderJob();
             attachedToRow = true;
             name = row->GetModelName();
-            mainBuffer = new PixelBufferClass(_ctx);
             numLayers = rowToRender->GetEffectLayerCount();
 
-            Model* mdl = _ctx->GetModel(name);
-            if (mdl != nullptr) {
-                mainBuffer->InitBuffer(*mdl, numLayers, seqData->FrameTime());
-                const Model *model = mainBuffer->GetModel();
-                if (DisplayAsType::ModelGroup == model->GetDisplayAs()) {
-                    const ModelGroup* grp = dynamic_cast<const ModelGroup*>(model);
-                    //for (int l = 0; l < numLayers; ++l) {
-                    for (int l = numLayers - 1; l >= 0; --l) {
-                        EffectLayer *layer = row->GetEffectLayer(l);
-                        bool perModelEffects = false;
-                        bool perModelEffectsDeep = false;
-                        for (int e = 0; e < layer->GetEffectCount() && !perModelEffects; ++e) {
-                            static const std::string CHOICE_BufferStyle("B_CHOICE_BufferStyle");
-                            static const std::string DEFAULT("Default");
-                            static const std::string PER_MODEL("Per Model");
-                            static const std::string DEEP("Deep");
-                            const std::string& bt = layer->GetEffect(e)->GetSettings().Get(CHOICE_BufferStyle, DEFAULT);
-                            if (bt.compare(0, 9, PER_MODEL) == 0) {
-                                if (bt.compare(bt.length() - 4, 4, DEEP) == 0) {
-                                    perModelEffectsDeep = true;
-                                } else {
-                                    perModelEffects = true;
-                                }
-                            } else if (bt == DEFAULT) {
-                                if (grp != nullptr && grp->GetDefaultBufferStyle().compare(0, 9, PER_MODEL) == 0) {
-                                    perModelEffects = true;
-                                }
-                            }
-                        }
-                        // A Per-Model buffer style merges dependent per-model
-                        // pixels during produce, so such a row is excluded from
-                        // the ARC phase A produce/output split (see RenderFrame).
-                        if (perModelEffects || perModelEffectsDeep) {
-                            ctorHasPerModelBuffers = true;
-                        }
-                        if (perModelEffectsDeep) {
-                            mainBuffer->InitPerModelBuffersDeep(*grp, l, data.FrameTime());
+            // Only the channel footprint is needed to wire the render graph;
+            // the pixel buffers themselves are allocated at the job's first
+            // slice (AllocateBuffers) and freed when it completes.  A group's
+            // own nodes cover all its members, so this can be a few more
+            // channels than its buffer renders, which only adds edges.
+            renderModel = _ctx->GetModel(name);
+            if (renderModel != nullptr) {
+                uint32_t nodeCount = renderModel->GetNodeCount();
+                nodeStartChannels.reserve(nodeCount);
+                for (uint32_t n = 0; n < nodeCount; ++n) {
+                    nodeStartChannels.push_back(renderModel->NodeStartChannel(n));
+                }
+                chanCountPerNode = renderModel->GetChanCountPerNode();
+            }
+        }
+        startFrame = 0;
+    }
+
+    // Builds the main, submodel/strand and node buffers for the row.  Called
+    // once, from the first slice that owns the row, under its render lock.
+    void AllocateBuffers() {
+        ModelElement* row = rowToRender;
+        mainBuffer = new PixelBufferClass(_ctx);
+        mainBuffer->InitBuffer(*renderModel, numLayers, seqData->FrameTime());
+        const Model *model = mainBuffer->GetModel();
+        if (DisplayAsType::ModelGroup == model->GetDisplayAs()) {
+            const ModelGroup* grp = dynamic_cast<const ModelGroup*>(model);
+            // layers can be removed between the job being created and its first
+            // slice, so clamp as ProcessFrame does
+            const int layers = std::min((int)row->GetEffectLayerCount(), numLayers);
+            for (int l = layers - 1; l >= 0; --l) {
+                EffectLayer *layer = row->GetEffectLayer(l);
+                if (layer == nullptr) {
+                    continue;
+                }
+                bool perModelEffects = false;
+                bool perModelEffectsDeep = false;
+                for (int e = 0; e < layer->GetEffectCount() && !perModelEffects; ++e) {
+                    static const std::string CHOICE_BufferStyle("B_CHOICE_BufferStyle");
+                    static const std::string DEFAULT("Default");
+                    static const std::string PER_MODEL("Per Model");
+                    static const std::string DEEP("Deep");
+                    const std::string& bt = layer->GetEffect(e)->GetSettings().Get(CHOICE_BufferStyle, DEFAULT);
+                    if (bt.compare(0, 9, PER_MODEL) == 0) {
+                        if (bt.compare(bt.length() - 4, 4, DEEP) == 0) {
+                            perModelEffectsDeep = true;
+                        } else {
+                            perModelEffects = true;
                         }
-                        if (perModelEffects) {
-                            mainBuffer->InitPerModelBuffers(*grp, l, data.FrameTime());
+                    } else if (bt == DEFAULT) {
+                        if (grp != nullptr && grp->GetDefaultBufferStyle().compare(0, 9, PER_MODEL) == 0) {
+                            perModelEffects = true;
                         }
                     }
                 }
-                std::string duplicateIncludeSourceModel;
-                for (int lyr = 0; lyr < (int)rowToRender->GetEffectLayerCount() && duplicateIncludeSourceModel.empty(); ++lyr) {
-                    EffectLayer* elyr = rowToRender->GetEffectLayer(lyr);
-                    std::unique_lock<std::recursive_mutex> elyrLock(elyr->GetLock());
-                    for (int e = 0; e < elyr->GetEffectCount(); ++e) {
-                        Effect* eff = elyr->GetEffect(e);
-                        if (eff->GetEffectIndex() == EffectManager::eff_DUPLICATE &&
-                            eff->GetSetting("E_CHECKBOX_Duplicate_Include_Submodels") == "1") {
-                            duplicateIncludeSourceModel = eff->GetSetting("E_CHOICE_Duplicate_Model");
-                            break;
-                        }
-                    }
+                // A Per-Model buffer style merges dependent per-model
+                // pixels during produce, so such a row is excluded from
+                // the ARC phase A produce/output split (see RenderFrame).
+                if (perModelEffects || perModelEffectsDeep) {
+                    hasPerModelBuffers = true;
+                }
+                if (perModelEffectsDeep) {
+                    mainBuffer->InitPerModelBuffersDeep(*grp, l, seqData->FrameTime());
                 }
+                if (perModelEffects) {
+                    mainBuffer->InitPerModelBuffers(*grp, l, seqData->FrameTime());
+                }
+            }
+        }
+        std::string duplicateIncludeSourceModel;
+        for (int lyr = 0; lyr < (int)rowToRender->GetEffectLayerCount() && duplicateIncludeSourceModel.empty(); ++lyr) {
+            EffectLayer* elyr = rowToRender->GetEffectLayer(lyr);
+            if (elyr == nullptr) {
+                continue;
+            }
+            std::unique_lock<std::recursive_mutex> elyrLock(elyr->GetLock());
+            for (int e = 0; e < elyr->GetEffectCount(); ++e) {
+                Effect* eff = elyr->GetEffect(e);
+                if (eff->GetEffectIndex() == EffectManager::eff_DUPLICATE &&
+                    eff->GetSetting("E_CHECKBOX_Duplicate_Include_Submodels") == "1") {
+                    duplicateIncludeSourceModel = eff->GetSetting("E_CHOICE_Duplicate_Model");
+                    break;
+                }
+            }
+        }
 
-                std::unordered_map<std::string, Element*> srcSubmodelsWithEffects;
-                if (!duplicateIncludeSourceModel.empty()) {
-                    ModelElement* srcModelEl = dynamic_cast<ModelElement*>(
-                        rowToRender->GetSequenceElements()->GetElement(duplicateIncludeSourceModel));
-                    if (srcModelEl != nullptr) {
-                        for (int x = 0; x < srcModelEl->GetSubModelAndStrandCount(); ++x) {
-                            SubModelElement* srcSe = srcModelEl->GetSubModel(x);
-                            if (srcSe != nullptr &&
-                                srcSe->GetType() != ElementType::ELEMENT_TYPE_STRAND &&
-                                srcSe->HasEffects()) {
-                                srcSubmodelsWithEffects[srcSe->GetName()] = srcSe;
-                            }
-                        }
+        std::unordered_map<std::string, Element*> srcSubmodelsWithEffects;
+        if (!duplicateIncludeSourceModel.empty()) {
+            ModelElement* srcModelEl = dynamic_cast<ModelElement*>(
+                rowToRender->GetSequenceElements()->GetElement(duplicateIncludeSourceModel));
+            if (srcModelEl != nullptr) {
+                for (int x = 0; x < srcModelEl->GetSubModelAndStrandCount(); ++x) {
+                    SubModelElement* srcSe = srcModelEl->GetSubModel(x);
+                    if (srcSe != nullptr &&
+                        srcSe->GetType() != ElementType::ELEMENT_TYPE_STRAND &&
+                        srcSe->HasEffects()) {
+                        srcSubmodelsWithEffects[srcSe->GetName()] = srcSe;
                     }
                 }
+            }
+        }
 
-                for (int x = 0; x < row->GetSubModelAndStrandCount(); ++x) {
-                    SubModelElement *se = row->GetSubModel(x);
-                    const bool addForInheritedDuplicate = !srcSubmodelsWithEffects.empty() &&
-                                                          se->GetType() != ElementType::ELEMENT_TYPE_STRAND;
-                    if (se->HasEffects()) {
-                        if (se->GetType() == ElementType::ELEMENT_TYPE_STRAND) {
-                            StrandElement *ste = (StrandElement*)se;
-                            if (ste->GetStrand() < model->GetNumStrands()) {
-                                subModelInfos.push_back(new EffectLayerInfo(se->GetEffectLayerCount() + 1));
-                                subModelInfos.back()->element = se;
-                                subModelInfos.back()->buffer.reset(new PixelBufferClass(_ctx));
-                                subModelInfos.back()->strand = ste->GetStrand();
-                                subModelInfos.back()->submodel = subModelInfos.size() -1;
-                                subModelInfos.back()->buffer->InitStrandBuffer(*model, ste->GetStrand(), data.FrameTime(), se->GetEffectLayerCount());
-                            }
-                        } else {
-                            Model *subModel = model->GetSubModel(se->GetName());
-                            if (subModel != nullptr) {
-                                int layerCount = (int)se->GetEffectLayerCount();
-                                if (addForInheritedDuplicate) {
-                                    auto srcIt = srcSubmodelsWithEffects.find(se->GetName());
-                                    if (srcIt != srcSubmodelsWithEffects.end())
-                                        layerCount = std::max(layerCount, (int)srcIt->second->GetEffectLayerCount());
-                                }
-                                subModelInfos.push_back(new EffectLayerInfo(layerCount + 1));
-                                subModelInfos.back()->element = se;
-                                subModelInfos.back()->submodel = subModelInfos.size() -1;
-                                subModelInfos.back()->buffer.reset(new PixelBufferClass(_ctx));
-                                subModelInfos.back()->buffer->InitBuffer(*subModel, layerCount + 1, data.FrameTime());
-                            }
-                        }
-                    } else if (addForInheritedDuplicate) {
-                        auto srcIt = srcSubmodelsWithEffects.find(se->GetName());
-                        if (srcIt != srcSubmodelsWithEffects.end()) {
-                            Model *subModel = model->GetSubModel(se->GetName());
-                            if (subModel != nullptr) {
-                                int layerCount = std::max(1, std::max((int)se->GetEffectLayerCount(),
-                                                                      (int)srcIt->second->GetEffectLayerCount()));
-                                subModelInfos.push_back(new EffectLayerInfo(layerCount + 1));
-                                subModelInfos.back()->element = se;
-                                subModelInfos.back()->submodel = subModelInfos.size() - 1;
-                                subModelInfos.back()->buffer.reset(new PixelBufferClass(_ctx));
-                                subModelInfos.back()->buffer->InitBuffer(*subModel, layerCount + 1, data.FrameTime());
-                            }
+        for (int x = 0; x < row->GetSubModelAndStrandCount(); ++x) {
+            SubModelElement *se = row->GetSubModel(x);
+            const bool addForInheritedDuplicate = !srcSubmodelsWithEffects.empty() &&
+                                                  se->GetType() != ElementType::ELEMENT_TYPE_STRAND;
+            if (se->HasEffects()) {
+                if (se->GetType() == ElementType::ELEMENT_TYPE_STRAND) {
+                    StrandElement *ste = (StrandElement*)se;
+                    if (ste->GetStrand() < model->GetNumStrands()) {
+                        subModelInfos.push_back(new EffectLayerInfo(se->GetEffectLayerCount() + 1));
+                        subModelInfos.back()->element = se;
+                        subModelInfos.back()->buffer.reset(new PixelBufferClass(_ctx));
+                        subModelInfos.back()->strand = ste->GetStrand();
+                        subModelInfos.back()->submodel = subModelInfos.size() -1;
+                        subModelInfos.back()->buffer->InitStrandBuffer(*model, ste->GetStrand(), seqData->FrameTime(), se->GetEffectLayerCount());
+                    }
+                } else {
+                    Model *subModel = model->GetSubModel(se->GetName());
+                    if (subModel != nullptr) {
+                        int layerCount = (int)se->GetEffectLayerCount();
+                        if (addForInheritedDuplicate) {
+                            auto srcIt = srcSubmodelsWithEffects.find(se->GetName());
+                            if (srcIt != srcSubmodelsWithEffects.end())
+                                layerCount = std::max(layerCount, (int)srcIt->second->GetEffectLayerCount());
                         }
+                        subModelInfos.push_back(new EffectLayerInfo(layerCount + 1));
+                        subModelInfos.back()->element = se;
+                        subModelInfos.back()->submodel = subModelInfos.size() -1;
+                        subModelInfos.back()->buffer.reset(new PixelBufferClass(_ctx));
+                        subModelInfos.back()->buffer->InitBuffer(*subModel, layerCount + 1, seqData->FrameTime());
                     }
-                    if (se->GetType() == ElementType::ELEMENT_TYPE_STRAND) {
-                        StrandElement *ste = (StrandElement*)se;
-                        if (ste->GetStrand() < model->GetNumStrands()) {
-                            for (int n = 0; n < ste->GetNodeLayerCount(); ++n) {
-                                if (n < model->GetStrandLength(ste->GetStrand())) {
-                                    EffectLayer *nl = ste->GetNodeLayer(n);
-                                    if (nl -> GetEffectCount() > 0) {
-                                        nodeBuffers[SNPair(ste->GetStrand(), n)].reset(new PixelBufferClass(_ctx));
-                                        nodeBuffers[SNPair(ste->GetStrand(), n)]->InitNodeBuffer(*model, ste->GetStrand(), n, data.FrameTime());
-                                    }
-                                }
+                }
+            } else if (addForInheritedDuplicate) {
+                auto srcIt = srcSubmodelsWithEffects.find(se->GetName());
+                if (srcIt != srcSubmodelsWithEffects.end()) {
+                    Model *subModel = model->GetSubModel(se->GetName());
+                    if (subModel != nullptr) {
+                        int layerCount = std::max(1, std::max((int)se->GetEffectLayerCount(),
+                                                              (int)srcIt->second->GetEffectLayerCount()));
+                        subModelInfos.push_back(new EffectLayerInfo(layerCount + 1));
+                        subModelInfos.back()->element = se;
+                        subModelInfos.back()->submodel = subModelInfos.size() - 1;
+                        subModelInfos.back()->buffer.reset(new PixelBufferClass(_ctx));
+                        subModelInfos.back()->buffer->InitBuffer(*subModel, layerCount + 1, seqData->FrameTime());
+                    }
+                }
+            }
+            if (se->GetType() == ElementType::ELEMENT_TYPE_STRAND) {
+                StrandElement *ste = (StrandElement*)se;
+                if (ste->GetStrand() < model->GetNumStrands()) {
+                    for (int n = 0; n < ste->GetNodeLayerCount(); ++n) {
+                        if (n < model->GetStrandLength(ste->GetStrand())) {
+                            EffectLayer *nl = ste->GetNodeLayer(n);
+                            if (nl -> GetEffectCount() > 0) {
+                                nodeBuffers[SNPair(ste->GetStrand(), n)].reset(new PixelBufferClass(_ctx));
+                                nodeBuffers[SNPair(ste->GetStrand(), n)]->InitNodeBuffer(*model, ste->GetStrand(), n, seqData->FrameTime());
                             }
                         }
                     }
                 }
-            } else {
-                delete mainBuffer;
-                mainBuffer = nullptr;
             }
-        } else {
-            mainBuffer = nullptr;
         }
-        startFrame = 0;
+        bufferBytes = mainBuffer->GetMemoryBytes();
+        for (const auto& a : subModelInfos) {
+            bufferBytes += a->buffer->GetMemoryBytes();
+        }
+        for (const auto& it : nodeBuffers) {
+            bufferBytes += it.second->GetMemoryBytes();
+        }
+        if (_rpi) {
+            _rpi->AddBufferBytes((long long)bufferBytes);
+        }
+    }
+
+    // Frees the pixel buffers (and the frame-parallel clone pool) once the job
+    // reaches Done.  The submodel infos themselves stay for the status strings,
+    // which still read their element.  Safe to call more than once.
+    void ReleaseBuffers() {
+        if (mainBuffer == nullptr) {
+            return;
+        }
+        // Buffers grow as effects pick larger buffer styles; charge the growth
+        // before releasing so the batch peak reflects the working size.
+        size_t bytes = mainBuffer->GetMemoryBytes();
+        for (const auto& a : subModelInfos) {
+            if (a->buffer) {
+                bytes += a->buffer->GetMemoryBytes();
+                a->buffer.reset();
+            }
+        }
+        for (const auto& it : nodeBuffers) {
+            bytes += it.second->GetMemoryBytes();
+        }
+        for (size_t i = 0; i < parBuffers.size(); ++i) {
+            bytes += parBuffers[i]->GetMemoryBytes();
+            for (const auto& si : parSubInfos[i]) {
+                bytes += si->buffer->GetMemoryBytes();
+            }
+        }
+        if (_rpi) {
+            _rpi->AddBufferBytes((long long)bytes - (long long)bufferBytes);
+            _rpi->AddBufferBytes(-(long long)bytes);
+        }
+        bufferBytes = 0;
+        delete mainBuffer;
+        mainBuffer = nullptr;
+        nodeBuffers.clear();
+        parBuffers.clear();
+        parInfos.clear();
+        parSubInfos.clear();
     }
 
     virtual ~RenderJob() {
@@ -839,14 +914,24 @@ public:
 
     SequenceData *createExportBuffer() {
         SequenceData *sb = new SequenceData();
-        sb->init(_ctx->GetModel(mainBuffer->GetModelName())->GetActChanCount(), seqData->NumFrames(), seqData->FrameTime(), false);
+        sb->init(renderModel->GetActChanCount(), seqData->NumFrames(), seqData->FrameTime(), false);
         seqData = sb;
         return sb;
     }
 
-    PixelBufferClass *getBuffer() const
-    {
-        return mainBuffer;
+    // Channel footprint of the row's model, captured at construction so the
+    // render graph can be wired before any buffer exists.
+    bool HasModel() const {
+        return renderModel != nullptr;
+    }
+    size_t GetNodeCount() const {
+        return nodeStartChannels.size();
+    }
+    uint32_t GetChanCountPerNode() const {
+        return chanCountPerNode;
+    }
+    uint32_t NodeStartChannel(size_t node) const {
+        return nodeStartChannels[node];
     }
 
     void setRenderRange(int start, int end) {
@@ -1746,8 +1831,8 @@ public:
     // Grow the clone pool to n entries.  Each entry is a full per-frame render
     // context: a main-buffer clone plus - for submodel rows (item 03 step 3) -
     // one EffectLayerInfo+buffer per subModelInfos entry, mirroring the shapes
-    // the ctor built (submodel InitBuffer / strand InitStrandBuffer, same layer
-    // counts).  Returns false if a submodel lookup fails (the caller falls back
+    // AllocateBuffers built (submodel InitBuffer / strand InitStrandBuffer, same
+    // layer counts).  Returns false if a submodel lookup fails (the caller falls back
     // to serial rendering for the window).
     bool EnsureParPool(int n) {
         const Model* mdl = mainBuffer->GetModel();
@@ -1984,7 +2069,7 @@ public:
     // bumps the row change count, and the per-frame bail re-renders under a
     // fresh job that re-detects - so a job's flag is valid for its whole life.
     bool RowMustGateBeforeProduce() const {
-        if (ctorHasPerModelBuffers) {
+        if (hasPerModelBuffers) {
             return true;
         }
         auto layerNotRowLocal = [](EffectLayer* elayer) -> bool {
@@ -2097,7 +2182,7 @@ public:
             && !rowMustGateBeforeProduce
             && (subModelInfos.empty() || parSubmodelRows)
             && nodeBuffers.empty()
-            && !ctorHasPerModelBuffers;
+            && !hasPerModelBuffers;
         parEligible = xldbgParallelFrames && structurallyEligible;
         parChunkFrames = isGroup                 ? PAR_FRAME_GROUP_CHUNK
                          : !subModelInfos.empty() ? PAR_FRAME_SUBMODEL_CHUNK
@@ -2106,7 +2191,7 @@ public:
         if (xldbgParBlockers) {
             // Rows held back ONLY by their submodel/strand effects - the
             // item-03 step-3 population (either kind of row).
-            bool submodelOnly = !rowMustGateBeforeProduce && !ctorHasPerModelBuffers
+            bool submodelOnly = !rowMustGateBeforeProduce && !hasPerModelBuffers
                 && (!subModelInfos.empty() || !nodeBuffers.empty());
             if (!isGroup) {
                 {
@@ -2117,7 +2202,7 @@ public:
                 // Item-03 population: model rows that would qualify except for
                 // the groups-only rule.  Tally their coverage separately.
                 if (!rowMustGateBeforeProduce && subModelInfos.empty()
-                    && nodeBuffers.empty() && !ctorHasPerModelBuffers) {
+                    && nodeBuffers.empty() && !hasPerModelBuffers) {
                     AnalyzeFrameBlockers(BlockerTally::Model);
                 } else if (submodelOnly) {
                     AnalyzeFrameBlockers(BlockerTally::SubmodelRow);
@@ -2131,7 +2216,7 @@ public:
                 std::string reason = rowMustGateBeforeProduce ? "canvas-mix / per-model gate"
                     : !subModelInfos.empty()                  ? "has submodels"
                     : !nodeBuffers.empty()                    ? "has per-node buffers"
-                    : ctorHasPerModelBuffers                  ? "has per-model buffers"
+                    : hasPerModelBuffers                      ? "has per-model buffers"
                                                               : "other";
                 ParBlockerStats& g = parBlockers();
                 std::lock_guard<std::mutex> lg(g.mtx);
@@ -2443,6 +2528,7 @@ public:
             rowToRender->DetachRenderJob();
             attachedToRow = false;
         }
+        ReleaseBuffers();
         schedPhase = SchedPhase::Done;
         engine->NotifyJobFinished(rpi);
     }
@@ -2560,6 +2646,7 @@ public:
 
             {
                 std::unique_lock<std::recursive_timed_mutex> lock(rowToRender->GetRenderLock());
+                AllocateBuffers();
                 ComputeRenderRange();
             }
             resumeFrame = startFrame;
@@ -2756,8 +2843,12 @@ private:
 
     ModelElement *rowToRender;
     std::string name;
-    PixelBufferClass *mainBuffer;
+    PixelBufferClass *mainBuffer; // null until the first slice and again once Done
     int numLayers;
+    const Model* renderModel = nullptr;
+    std::vector<uint32_t> nodeStartChannels;
+    uint32_t chanCountPerNode = 0;
+    size_t bufferBytes = 0; // charged to _rpi's live buffer total
     std::atomic_int startFrame;
     std::atomic_int endFrame;
     RenderContext *_ctx;
@@ -2828,13 +2919,13 @@ private:
     // ARC phase A produce/output split.  rowMustGateBeforeProduce (computed once
     // at InitializeRenderStates) forces the synchronous gate-before-produce path
     // for rows whose produce() might read dependent data mid-loop (canvas mix,
-    // canvas-"Blend", or Per-Model buffers).  ctorHasPerModelBuffers is set in
-    // the ctor when any group layer initialised Per-Model buffers (needs the
-    // group default buffer style, only known there).  producedFrame is the frame
+    // canvas-"Blend", or Per-Model buffers).  hasPerModelBuffers is set in
+    // AllocateBuffers when any group layer initialised Per-Model buffers (needs
+    // the group default buffer style, only known there).  producedFrame is the frame
     // whose produce() has run but whose output() may still be pending across a
     // suspend on the split path.
     bool rowMustGateBeforeProduce = false;
-    bool ctorHasPerModelBuffers = false;
+    bool hasPerModelBuffers = false;
     int producedFrame = -1;
     // Per-main-layer cursor into the (time-ordered) effect list for the
     // frame-entry gate; advances with the frame loop (see NeedsUpstreamFrame).
@@ -3064,6 +3155,8 @@ void RenderEngine::Render(SequenceElements& seqElements,
     if (endFrame >= (int)seqData.NumFrames()) {
         endFrame = seqData.NumFrames() - 1;
     }
+    // remembered so the next fseq save only recompresses the blocks this batch touches
+    seqData.MarkFramesDirty(startFrame, endFrame);
     std::list<NodeRange> ranges;
     if (restrictToModels.empty()) {
         ranges.push_back(NodeRange(0, seqData.NumChannels()));
@@ -3116,8 +3209,7 @@ void RenderEngine::Render(SequenceElements& seqElements,
                     if (seqElements.SupportsModelBlending()) {
                         job->SetModelBlending();
                     }
-                    PixelBufferClass *buffer = job->getBuffer();
-                    if (buffer == nullptr || buffer->GetNodeCount() == 0) {
+                    if (!job->HasModel() || job->GetNodeCount() == 0) {
                         delete job;
                         continue;
                     }
@@ -3127,9 +3219,9 @@ void RenderEngine::Render(SequenceElements& seqElements,
                     if (xldbgEffSum) {
                         fprintf(stderr, "ROW %zu %s\n", row, (*it)->GetName().c_str());
                     }
-                    size_t cn = buffer->GetChanCountPerNode();
-                    for (size_t node = 0; node < buffer->GetNodeCount(); ++node) {
-                        uint32_t start = buffer->NodeStartChannel(node);
+                    size_t cn = job->GetChanCountPerNode();
+                    for (size_t node = 0; node < job->GetNodeCount(); ++node) {
+                        uint32_t start = job->NodeStartChannel(node);
                         for (size_t c = 0; c < cn; ++c) {
                             size_t cnum = start + c;
                             if (cnum < seqData.NumChannels()) {
@@ -3642,7 +3734,7 @@ bool RenderEngine::RenderEffectFromMap(bool suppress, Effect* effectObj, int lay
                                     }
                                 }
                                 else if (effectObj != nullptr && reff->SupportsRenderCache(SettingsMap) && _renderCache.IsEnabled()) {
-                                    if (!effectObj->GetFrame(*rb, _renderCache)) {
+                                    if (!effectObj->GetFrame(*rb, _renderCache, reff->RenderCacheDependsOnTime(SettingsMap), reff->RenderCacheDependsOnModel(SettingsMap))) {
                                         // Serial advance+draw: a migrated Snapshottable
                                         // effect advances here, then Render draws the
                                         // returned snapshot - identical to the draw pass.
@@ -3894,6 +3986,10 @@ static void DumpRenderProfile(RenderProgressInfo* rpi, long long elapsedMS) {
             ms(total.effectNs), ms(total.gpuBusyNs), ms(total.blurZoomNs), ms(total.transitionNs), ms(total.blendNs), ms(total.getColorsNs), ms(total.setColorsNs),
             ms(total.gpuWaitNs), ms(total.suspendedNs), ms(total.wallNs()),
             pct(total.gpuWaitNs, total.wallNs()), pct(total.suspendedNs, total.wallNs()), "");
+    if (total.audioWaits > 0) {
+        fprintf(stderr, "audioWait: %llu waits for filtered audio still being built, %.1fms (%.1f%% of wall)\n",
+                (unsigned long long)total.audioWaits, ms(total.audioWaitNs), pct(total.audioWaitNs, total.wallNs()));
+    }
 
     // Per-effect table, ranked by cpu+gpu.  Keys are the union of the CPU and GPU
     // maps: GPU-only rows appear for stage work no effect owns ("(gpu blend)" etc).
@@ -3923,6 +4019,10 @@ static void DumpRenderProfile(RenderProgressInfo* rpi, long long elapsedMS) {
     fprintf(stderr, "\n");
 }
 
+void RenderEngine::EnableRenderProfile() {
+    profRender.store(true);
+}
+
 void RenderEngine::NotifyJobFinished(RenderProgressInfo* rpi) {
     if (!rpi) return;
     // The thread that decrements the counter to zero is the last one out and
@@ -3942,15 +4042,32 @@ void RenderEngine::NotifyJobFinished(RenderProgressInfo* rpi) {
     auto elapsedMS = std::chrono::duration_cast<std::chrono::milliseconds>(
                          std::chrono::steady_clock::now() - rpi->startTime).count();
     spdlog::log(rpi->progressSink ? spdlog::level::info : spdlog::level::debug,
-                "Render batch complete: {} jobs over frames {}-{}, {} suspensions ({}ms), {} row parks, {}ms, {}",
+                "Render batch complete: {} jobs over frames {}-{}, {} suspensions ({}ms), {} row parks, {}MB peak buffers, {}ms, {}",
                 rpi->totalJobs, rpi->startFrame, rpi->endFrame,
                 rpi->suspendCount.load(), (long long)(rpi->suspendedNs.load() / 1000000),
-                rpi->parkCount.load(), (long long)elapsedMS,
+                rpi->parkCount.load(), (long long)(rpi->peakBufferBytes.load() / (1024 * 1024)), (long long)elapsedMS,
                 rpi->progressSink ? "background" : "interactive");
 
-    if (profRender) {
+    if (profRenderDump) {
         DumpRenderProfile(rpi, (long long)elapsedMS);
     }
+    if (profRender && _onRenderProfile) {
+        RenderBatchProfile batch;
+        batch.startFrame = rpi->startFrame;
+        batch.endFrame = rpi->endFrame;
+        batch.jobs = rpi->totalJobs;
+        batch.suspends = rpi->suspendCount.load();
+        batch.suspendedNs = (uint64_t)rpi->suspendedNs.load();
+        batch.peakBufferBytes = (uint64_t)rpi->peakBufferBytes.load();
+        batch.wallMS = (long long)elapsedMS;
+        for (int i = 0; i < rpi->numRows; ++i) {
+            const RenderJobProfile* p = rpi->jobs[i] != nullptr ? rpi->jobs[i]->GetRenderProfile() : nullptr;
+            if (p != nullptr && p->slices != 0) {
+                batch.total.merge(*p);
+            }
+        }
+        _onRenderProfile(batch);
+    }
 
     bool expected = false;
     rpi->completed.compare_exchange_strong(expected, true);
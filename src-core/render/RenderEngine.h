@@ -25,6 +25,7 @@ class JobPool;
 class Model;
 class RenderCache;
 class RenderContext;
+struct RenderBatchProfile;
 class RenderProgressInfo;
 class RenderTreeData;
 class SequenceData;
@@ -121,6 +122,13 @@ public:
     void SetOnRenderStatusTimerStart(std::function<void()> fn) { _onRenderStatusTimerStart = std::move(fn); }
     void SetOnRenderJobComplete(std::function<void(const std::string&)> fn) { _onRenderJobComplete = std::move(fn); }
     void SetOnAllRenderJobsComplete(std::function<void()> fn) { _onAllRenderJobsComplete = std::move(fn); }
+    // Receives the merged XL_RENDER_PROFILE counters of each finished batch, on
+    // the render thread that finished it.  Only fires while profiling is on.
+    void SetOnRenderProfile(std::function<void(const RenderBatchProfile&)> fn) { _onRenderProfile = std::move(fn); }
+
+    // Turn on profile collection without XL_RENDER_PROFILE in the environment
+    // (and without the stderr tables).  Call before the first Render.
+    static void EnableRenderProfile();
 
 private:
     RenderContext& _ctx;
@@ -139,4 +147,5 @@ private:
     std::function<void()> _onRenderStatusTimerStart;
     std::function<void(const std::string&)> _onRenderJobComplete;
     std::function<void()> _onAllRenderJobsComplete;
+    std::function<void(const RenderBatchProfile&)> _onRenderProfile;
 };
@@ -12,8 +12,9 @@
 
 // XL_RENDER_PROFILE=1 diagnostic: per-row / per-effect render timing.  The
 // counters here are written only by the single thread running a RenderJob's
-// current slice (no atomics), except gpuWaitNs which is attributed through the
-// thread-local pointer below from GPURenderUtils::waitForRenderCompletion.
+// current slice (no atomics), except gpuWaitNs and audioWaitNs which are
+// attributed through the thread-local pointer below from
+// GPURenderUtils::waitForRenderCompletion and the AudioManager filter lookups.
 
 #include <chrono>
 #include <cstdint>
@@ -41,12 +42,14 @@ struct RenderJobProfile {
     uint64_t getColorsNs = 0;
     uint64_t setColorsNs = 0;
     uint64_t gpuWaitNs = 0;     // parked in GPURenderUtils::waitForRenderCompletion
+    uint64_t audioWaitNs = 0;   // parked waiting for another thread's filtered audio
     uint64_t suspendedNs = 0;   // suspended awaiting an upstream frame
     uint64_t sliceNs = 0;       // active wall time across all slices
 
     uint64_t frames = 0;        // frames actually rendered
     uint64_t slices = 0;        // ProcessSlice entries
     uint64_t suspends = 0;      // suspension count
+    uint64_t audioWaits = 0;    // waits counted in audioWaitNs
 
     // GPU execution, attributed back to the effect that encoded the work (see
     // GpuCommandBufferTag).  gpuBusyNs is Σ of per-command-buffer GPU windows,
@@ -91,11 +94,13 @@ struct RenderJobProfile {
         getColorsNs += o.getColorsNs;
         setColorsNs += o.setColorsNs;
         gpuWaitNs += o.gpuWaitNs;
+        audioWaitNs += o.audioWaitNs;
         suspendedNs += o.suspendedNs;
         sliceNs += o.sliceNs;
         frames += o.frames;
         slices += o.slices;
         suspends += o.suspends;
+        audioWaits += o.audioWaits;
         gpuBusyNs += o.gpuBusyNs;
         gpuSharedNs += o.gpuSharedNs;
         gpuCbs += o.gpuCbs;
@@ -126,6 +131,20 @@ struct RenderJobProfile {
     }
 };
 
+// One finished render batch: every row's profile merged, plus the batch-level
+// scheduler telemetry from RenderProgressInfo.  Handed to the callback set with
+// RenderEngine::SetOnRenderProfile (the render benchmark consumes it).
+struct RenderBatchProfile {
+    RenderJobProfile total;
+    int startFrame = 0;
+    int endFrame = 0;
+    int jobs = 0;
+    int suspends = 0;
+    uint64_t suspendedNs = 0;
+    uint64_t peakBufferBytes = 0; // high-water mark of job pixel buffers alive at once
+    long long wallMS = 0;
+};
+
 // Points at the profile of the RenderJob whose slice this thread is currently
 // running (set for the slice's duration, otherwise null).  Nested parallel_for
 // workers never see it set - the calling slice thread's inclusive stage timer
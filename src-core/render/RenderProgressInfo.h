@@ -66,5 +66,15 @@ public:
     std::atomic<int> suspendCount{0};
     std::atomic<int> parkCount{0};
     std::atomic<long long> suspendedNs{0}; // Σ time jobs sat suspended on upstream
+    // Pixel buffer bytes held by jobs between their first slice and Done.
+    std::atomic<long long> liveBufferBytes{0};
+    std::atomic<long long> peakBufferBytes{0};
+
+    void AddBufferBytes(long long delta) {
+        long long live = liveBufferBytes.fetch_add(delta) + delta;
+        long long peak = peakBufferBytes.load();
+        while (live > peak && !peakBufferBytes.compare_exchange_weak(peak, live)) {
+        }
+    }
     std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
 };
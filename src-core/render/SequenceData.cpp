@@ -8,6 +8,7 @@
  * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
  **************************************************************/
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 
@@ -377,6 +378,79 @@ void SequenceData::init(unsigned int numChannels, unsigned int numFrames, unsign
     }
     _invalidFrame._data = (unsigned char*)calloc(1, _bytesPerFrame);
     _invalidFrame._numChannels = _numChannels;
+    MarkAllFramesDirty();
+}
+
+void SequenceData::MarkFramesDirty(unsigned int startFrame, unsigned int endFrame)
+{
+    if (_numFrames == 0 || startFrame > endFrame || startFrame >= _numFrames) {
+        return;
+    }
+    endFrame = std::min(endFrame, _numFrames - 1);
+
+    // keep the list sorted and merged, renders usually hit the same ranges again
+    std::unique_lock<std::mutex> lock(_dirtyLock);
+    std::vector<std::pair<uint32_t, uint32_t>> merged;
+    merged.reserve(_dirtyFrames.size() + 1);
+    std::pair<uint32_t, uint32_t> add(startFrame, endFrame);
+    bool added = false;
+    for (auto& r : _dirtyFrames) {
+        if (r.second + 1 < add.first) {
+            merged.push_back(r);
+        } else if (add.second + 1 < r.first) {
+            if (!added) {
+                merged.push_back(add);
+                added = true;
+            }
+            merged.push_back(r);
+        } else {
+            add.first = std::min(add.first, r.first);
+            add.second = std::max(add.second, r.second);
+        }
+    }
+    if (!added) {
+        merged.push_back(add);
+    }
+    _dirtyFrames = std::move(merged);
+    ++_dirtyGeneration;
+}
+
+void SequenceData::MarkAllFramesDirty()
+{
+    std::unique_lock<std::mutex> lock(_dirtyLock);
+    _dirtyFrames.clear();
+    if (_numFrames > 0) {
+        _dirtyFrames.emplace_back(0, _numFrames - 1);
+    }
+    ++_dirtyGeneration;
+    _syncedFseqId = 0;
+}
+
+std::vector<std::pair<uint32_t, uint32_t>> SequenceData::GetDirtyFrames() const
+{
+    std::unique_lock<std::mutex> lock(_dirtyLock);
+    return _dirtyFrames;
+}
+
+uint64_t SequenceData::GetDirtyGeneration() const
+{
+    std::unique_lock<std::mutex> lock(_dirtyLock);
+    return _dirtyGeneration;
+}
+
+void SequenceData::SetSyncedFseq(uint64_t uniqueId, uint64_t dirtyGeneration)
+{
+    std::unique_lock<std::mutex> lock(_dirtyLock);
+    if (_dirtyGeneration == dirtyGeneration) {
+        _dirtyFrames.clear();
+    }
+    _syncedFseqId = uniqueId;
+}
+
+uint64_t SequenceData::GetSyncedFseqId() const
+{
+    std::unique_lock<std::mutex> lock(_dirtyLock);
+    return _syncedFseqId;
 }
 
 
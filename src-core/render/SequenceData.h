@@ -11,11 +11,13 @@
  **************************************************************/
 
 #include <cassert>
+#include <cstdint>
 #include <cstring>
 #include <list>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #ifdef __APPLE__
@@ -98,6 +100,12 @@ public:
     unsigned int _numFrames;
     unsigned int _frameTime;
 
+    // frames changed since the data last matched the fseq with id _syncedFseqId
+    mutable std::mutex _dirtyLock;
+    std::vector<std::pair<uint32_t, uint32_t>> _dirtyFrames;
+    uint64_t _dirtyGeneration = 0; // bumped whenever frames are marked dirty
+    uint64_t _syncedFseqId = 0;
+
     SequenceData(const SequenceData&) = delete;  //make sure we cannot "copy" these
     SequenceData &operator=(const SequenceData& rgb) = delete;
 
@@ -145,6 +153,20 @@ public:
         return !_dataBlocks.empty();
     }
 
+    // Dirty frame tracking so an fseq save can reuse the compressed blocks of
+    // frames that have not changed since the data was last written to (or read
+    // from) that fseq.  Ranges are inclusive first/last frames.
+    void MarkFramesDirty(unsigned int startFrame, unsigned int endFrame);
+    void MarkAllFramesDirty();
+    [[nodiscard]] std::vector<std::pair<uint32_t, uint32_t>> GetDirtyFrames() const;
+    // Taken before the frames are read to write (or are loaded from) an fseq.
+    [[nodiscard]] uint64_t GetDirtyGeneration() const;
+    // The data now matches the fseq with the given unique id. The dirty frames
+    // are only cleared if none were marked since dirtyGeneration was taken,
+    // otherwise they are kept as the fseq may hold older data for them.
+    void SetSyncedFseq(uint64_t uniqueId, uint64_t dirtyGeneration);
+    [[nodiscard]] uint64_t GetSyncedFseqId() const;
+
     // encodes contents of SeqData in channel order
     [[nodiscard]] std::string base64_encode();
 };
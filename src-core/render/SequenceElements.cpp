@@ -11,6 +11,11 @@
 #include <cassert>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
 #include <spdlog/fmt/fmt.h>
 
 #include "SequenceElements.h"
@@ -28,6 +33,7 @@
 #include "render/SequenceViewManager.h"
 #include "JukeboxButtonData.h"
 #include "../utils/TraceLog.h"
+#include "../utils/Parallel.h"
 
 #include <log.h>
 
@@ -38,6 +44,9 @@ static const std::string STR_NODE("Node");
 static const std::string STR_STRAND("Strand");
 static const std::string STR_TIMING("timing");
 
+// FixEffectFileParameter updates the shared file fix cache, which is not thread safe
+static std::mutex fixFileParameterLock;
+
 SequenceElements::SequenceElements(RenderContext *ctx)
     : renderContext(ctx), mFrequency(20), mSequenceEndMS(0), undo_mgr(this)
 {
@@ -673,10 +682,12 @@ int SequenceElements::LoadEffects(EffectLayer* effectLayer,
     const pugi::xml_node& effectLayerNode,
     const std::vector<std::string>& effectStrings,
     const std::vector<std::string>& colorPalettes,
-    bool importing)
+    bool importing,
+    SymbolLinks* symbolLinks)
 {
 
     int loaded = 0;
+    bool added = false;
     for (auto effect : effectLayerNode.children()) {
         std::string effectNodeName = effect.name();
         if (effectNodeName == STR_EFFECT) {
@@ -716,6 +727,7 @@ int SequenceElements::LoadEffects(EffectLayer* effectLayer,
                     }
 
                     if (settings.find("E_FILEPICKER_Glediator_Filename") != std::string::npos) {
+                        std::unique_lock<std::mutex> locker(fixFileParameterLock);
                         settings = FileUtils::FixEffectFileParameter("E_FILEPICKER_Glediator_Filename", settings, "");
                     }
 
@@ -737,12 +749,18 @@ int SequenceElements::LoadEffects(EffectLayer* effectLayer,
                     }
                 }
                 if (effectName != "Random") {
+                    // sorted once when the whole layer is loaded rather than on every add
                     Effect* newEffect = effectLayer->AddEffect(id, effectName, settings, pal,
-                                           startTime, endTime, EFFECT_NOT_SELECTED, bProtected, false, importing);
+                                           startTime, endTime, EFFECT_NOT_SELECTED, bProtected, true, importing);
+                    added = added || newEffect != nullptr;
                     if (newEffect != nullptr && !effect.attribute("linkedSymbol").empty()) {
                         std::string symbolId = effect.attribute("linkedSymbol").as_string("");
                         if (!symbolId.empty() && _effectSymbolManager.SymbolExists(symbolId)) {
-                            newEffect->LinkToSymbol(symbolId);
+                            if (symbolLinks != nullptr) {
+                                symbolLinks->emplace_back(newEffect, symbolId);
+                            } else {
+                                newEffect->LinkToSymbol(symbolId);
+                            }
                         }
                     }
                 } else {
@@ -756,10 +774,99 @@ int SequenceElements::LoadEffects(EffectLayer* effectLayer,
             if (!nodeName.empty()) {
                 ((NodeLayer*)neffectLayer)->SetNodeName(nodeName);
             }
-            LoadEffects(neffectLayer, type, effect, effectStrings, colorPalettes);
+            LoadEffects(neffectLayer, type, effect, effectStrings, colorPalettes, false, symbolLinks);
         }
         loaded++;
     }
+    if (added) {
+        effectLayer->SortEffects();
+    }
+    return loaded;
+}
+
+int SequenceElements::LoadElementEffects(Element* element,
+    const pugi::xml_node& elementNode,
+    int sequenceDurationMS,
+    const std::vector<std::string>& effectStrings,
+    const std::vector<std::string>& colorPalettes,
+    bool importing,
+    SymbolLinks& symbolLinks,
+    const std::function<void(int)>& layerLoaded)
+{
+    int loaded = 0;
+    int interval = 0;
+    std::string elemType = elementNode.attribute("type").as_string("");
+    if (elemType == STR_TIMING) {
+        interval = elementNode.attribute("fixed").as_int(0);
+    }
+    if (interval > 0) {
+        if (interval != RoundToMultipleOfPeriod(interval, mFrequency)) {
+            int newinterval = RoundToMultipleOfPeriod(interval, mFrequency);
+            if (newinterval == 0)
+                newinterval = 1000 / mFrequency;
+            spdlog::warn("Timing interval of {}ms not a multiple of frame time so changed to {}ms.", interval, newinterval);
+            interval = newinterval;
+        }
+        dynamic_cast<TimingElement*>(element)->SetFixedTiming(interval);
+        EffectLayer* effectLayer = element->AddEffectLayer();
+        int time = 0;
+        int end_time = RoundToMultipleOfPeriod(sequenceDurationMS, mFrequency);
+        while (time < end_time) {
+            int startTime = time;
+            int endTime = time + interval;
+            effectLayer->AddEffect(0, "", "", "", startTime, endTime, EFFECT_NOT_SELECTED, false, true);
+            time += interval;
+        }
+        effectLayer->NumberEffects();
+        return loaded;
+    }
+
+    for (auto effectLayerNode : elementNode.children()) {
+        EffectLayer* effectLayer = nullptr;
+        std::string layerNodeName = effectLayerNode.name();
+        if (layerNodeName == STR_EFFECTLAYER) {
+            effectLayer = element->AddEffectLayer();
+        } else if (layerNodeName == STR_SUBMODEL_EFFECTLAYER) {
+            std::string smName = effectLayerNode.attribute("name").as_string("");
+            while (!smName.empty() && (smName.front() == ' ' || smName.front() == '\t')) smName.erase(smName.begin());
+            while (!smName.empty() && (smName.back() == ' ' || smName.back() == '\t')) smName.pop_back();
+            int layer = effectLayerNode.attribute("layer").as_int(0);
+            SubModelElement* se = dynamic_cast<ModelElement*>(element)->GetSubModel(smName, true);
+            assert(se != nullptr);
+            while (layer >= 0 && static_cast<size_t>(layer) >= se->GetEffectLayerCount()) {
+                se->AddEffectLayer();
+            }
+            effectLayer = se->GetEffectLayer(layer);
+        } else {
+            if (dynamic_cast<ModelElement*>(element) != nullptr) {
+                StrandElement* se = dynamic_cast<ModelElement*>(element)->GetStrand(effectLayerNode.attribute("index").as_int(0), true);
+                int layer = effectLayerNode.attribute("layer").as_int(0);
+                while (layer >= 0 && static_cast<size_t>(layer) >= se->GetEffectLayerCount()) {
+                    se->AddEffectLayer();
+                }
+                effectLayer = se->GetEffectLayer(layer);
+                std::string strandName = effectLayerNode.attribute("name").as_string("");
+                if (!strandName.empty()) {
+                    while (!strandName.empty() && (strandName.front() == ' ' || strandName.front() == '\t')) strandName.erase(strandName.begin());
+                    while (!strandName.empty() && (strandName.back() == ' ' || strandName.back() == '\t')) strandName.pop_back();
+                    se->SetName(strandName);
+                }
+            } else {
+                spdlog::error("Element {} was not a model element. This typically happens when a timing track is created with the same name as a model.", element->GetName());
+            }
+        }
+        if (effectLayer != nullptr) {
+            std::string layerName = effectLayerNode.attribute("layerName").as_string("");
+            if (!layerName.empty()) {
+                effectLayer->SetLayerName(layerName);
+            }
+            int count = LoadEffects(effectLayer, elemType, effectLayerNode, effectStrings, colorPalettes, importing, &symbolLinks);
+            loaded += count;
+            layerLoaded(count);
+        } else {
+            assert(false);
+        }
+    }
     return loaded;
 }
 
@@ -848,15 +955,14 @@ bool SequenceElements::LoadSequencerFile(SequenceFile& xml_file, pugi::xml_docum
         } else if (ename == "EffectSymbols") {
             _effectSymbolManager.LoadFromXml(e);
         } else if (ename == "ElementEffects") {
-            // Count effects for progress
-            int count = 0;
-            for (auto elementNode : e.children("Element")) {
-                for (auto layerNode : elementNode.children()) {
-                    count += std::ranges::distance(layerNode.children());
-                }
-            }
+            const auto effectsStart = std::chrono::steady_clock::now();
 
-            int loaded = 0;
+            // Resolve the rows up front. Any duplicate <Element> entries for the same
+            // row are kept together so a row is only ever loaded by one thread.
+            std::vector<Element*> rowElements;
+            std::vector<std::vector<pugi::xml_node>> rowNodes;
+            std::map<Element*, size_t> rowIndex;
+            int count = 0;
             for (auto elementNode : e.children("Element")) {
                 std::string nm = elementNode.attribute("name").as_string("");
                 // trim whitespace
@@ -864,86 +970,53 @@ bool SequenceElements::LoadSequencerFile(SequenceFile& xml_file, pugi::xml_docum
                 while (!nm.empty() && (nm.back() == ' ' || nm.back() == '\t')) nm.pop_back();
 
                 Element* element = GetElement(nm);
-                if (element != nullptr) {
-                    int interval = 0;
-                    std::string elemType = elementNode.attribute("type").as_string("");
-                    if (elemType == STR_TIMING) {
-                        interval = elementNode.attribute("fixed").as_int(0);
-                    }
-                    if (interval > 0) {
-                        if (interval != RoundToMultipleOfPeriod(interval, mFrequency)) {
-                            int newinterval = RoundToMultipleOfPeriod(interval, mFrequency);
-                            if (newinterval == 0)
-                                newinterval = 1000 / mFrequency;
-                            spdlog::warn("Timing interval of {}ms not a multiple of frame time so changed to {}ms.", interval, newinterval);
-                            interval = newinterval;
-                        }
-                        dynamic_cast<TimingElement*>(element)->SetFixedTiming(interval);
-                        EffectLayer* effectLayer = element->AddEffectLayer();
-                        int time = 0;
-                        int end_time = RoundToMultipleOfPeriod(xml_file.GetSequenceDurationMS(), mFrequency);
-                        while (time < end_time) {
-                            int startTime = time;
-                            int endTime = time + interval;
-                            effectLayer->AddEffect(0, "", "", "", startTime, endTime, EFFECT_NOT_SELECTED, false, true);
-                            time += interval;
-                        }
-                        effectLayer->NumberEffects();
-                    } else {
-                        for (auto effectLayerNode : elementNode.children()) {
-                            EffectLayer* effectLayer = nullptr;
-                            std::string layerNodeName = effectLayerNode.name();
-                            if (layerNodeName == STR_EFFECTLAYER) {
-                                effectLayer = element->AddEffectLayer();
-                            } else if (layerNodeName == STR_SUBMODEL_EFFECTLAYER) {
-                                std::string smName = effectLayerNode.attribute("name").as_string("");
-                                while (!smName.empty() && (smName.front() == ' ' || smName.front() == '\t')) smName.erase(smName.begin());
-                                while (!smName.empty() && (smName.back() == ' ' || smName.back() == '\t')) smName.pop_back();
-                                int layer = effectLayerNode.attribute("layer").as_int(0);
-                                SubModelElement* se = dynamic_cast<ModelElement*>(element)->GetSubModel(smName, true);
-                                assert(se != nullptr);
-                                while (layer >= 0 && static_cast<size_t>(layer) >= se->GetEffectLayerCount()) {
-                                    se->AddEffectLayer();
-                                }
-                                effectLayer = se->GetEffectLayer(layer);
-                            } else {
-                                if (dynamic_cast<ModelElement*>(element) != nullptr) {
-                                    StrandElement* se = dynamic_cast<ModelElement*>(element)->GetStrand(effectLayerNode.attribute("index").as_int(0), true);
-                                    int layer = effectLayerNode.attribute("layer").as_int(0);
-                                    while (layer >= 0 && static_cast<size_t>(layer) >= se->GetEffectLayerCount()) {
-                                        se->AddEffectLayer();
-                                    }
-                                    effectLayer = se->GetEffectLayer(layer);
-                                    std::string strandName = effectLayerNode.attribute("name").as_string("");
-                                    if (!strandName.empty()) {
-                                        while (!strandName.empty() && (strandName.front() == ' ' || strandName.front() == '\t')) strandName.erase(strandName.begin());
-                                        while (!strandName.empty() && (strandName.back() == ' ' || strandName.back() == '\t')) strandName.pop_back();
-                                        se->SetName(strandName);
-                                    }
-                                } else {
-                                    spdlog::error("Element {} was not a model element. This typically happens when a timing track is created with the same name as a model.", element->GetName());
-                                }
-                            }
-                            if (effectLayer != nullptr) {
-                                std::string layerName = effectLayerNode.attribute("layerName").as_string("");
-                                if (!layerName.empty()) {
-                                    effectLayer->SetLayerName(layerName);
-                                }
-                                loaded += LoadEffects(effectLayer, elemType, effectLayerNode, effectStrings, colorPalettes, importing);
-                                if (count) {
-                                    if (renderContext) {
-                                        renderContext->SetLoadingStatusText(fmt::format("Effects Loaded: {}%.", loaded * 100 / count));
-                                    }
-                                }
-                            } else {
-                                assert(false);
-                            }
-                        }
-                    }
-                } else {
+                if (element == nullptr) {
                     assert(false);
+                    continue;
+                }
+                auto it = rowIndex.find(element);
+                if (it == rowIndex.end()) {
+                    it = rowIndex.emplace(element, rowElements.size()).first;
+                    rowElements.push_back(element);
+                    rowNodes.emplace_back();
+                }
+                rowNodes[it->second].push_back(elementNode);
+                // Count effects for progress
+                for (auto layerNode : elementNode.children()) {
+                    count += std::ranges::distance(layerNode.children());
+                }
+            }
+
+            // Constructing the effects (settings parsing, value curve upgrades, buffer
+            // fixups) is the bulk of the load and each row only touches its own layers
+            std::atomic_int loaded = 0;
+            const auto callerThread = std::this_thread::get_id();
+            auto layerLoaded = [this, &loaded, count, callerThread](int n) {
+                int l = (loaded += n);
+                // the status text goes to the UI so only report from the calling thread
+                if (count && renderContext && std::this_thread::get_id() == callerThread) {
+                    renderContext->SetLoadingStatusText(fmt::format("Effects Loaded: {}%.", l * 100 / count));
+                }
+            };
+            std::vector<SymbolLinks> rowSymbolLinks(rowElements.size());
+            const int sequenceDurationMS = xml_file.GetSequenceDurationMS();
+            parallel_for(0, (int)rowElements.size(), [&](int r) {
+                for (const auto& elementNode : rowNodes[r]) {
+                    LoadElementEffects(rowElements[r], elementNode, sequenceDurationMS, effectStrings, colorPalettes, importing, rowSymbolLinks[r], layerLoaded);
+                }
+            }, 1, &ParallelJobPool::POOL, "LoadElementEffects");
+
+            size_t links = 0;
+            for (const auto& symbolLinks : rowSymbolLinks) {
+                for (const auto& [effect, symbolId] : symbolLinks) {
+                    effect->LinkToSymbol(symbolId);
                 }
+                links += symbolLinks.size();
             }
+            spdlog::info("LoadSequencerFile: Loaded {} effects on {} rows in {}ms ({} symbol links).",
+                         (int)loaded, rowElements.size(),
+                         std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - effectsStart).count(),
+                         links);
         }
         TraceLog::PopTraceContext();
     }
@@ -18,6 +18,9 @@
 #include "SongStructureManager.h"
 namespace pugi { class xml_node; class xml_document; }
 #include <array>
+#include <atomic>
+#include <functional>
+#include <utility>
 #include <vector>
 #include <set>
 #include <string>
@@ -234,12 +237,27 @@ public:
     const SongStructureManager& GetSongStructureManager() const { return mSongStructure; }
 protected:
 private:
+    // effects and the symbol they link to, collected while rows load in parallel
+    // and linked afterwards as linking updates the shared symbol manager
+    typedef std::vector<std::pair<Effect*, std::string>> SymbolLinks;
+
     int LoadEffects(EffectLayer *layer,
         const std::string &type,
         const pugi::xml_node &effectLayerNode,
         const std::vector<std::string> & effectStrings,
         const std::vector<std::string> & colorPalettes,
-        bool importing = false);
+        bool importing = false,
+        SymbolLinks *symbolLinks = nullptr);
+    // loads every layer of one <Element> in <ElementEffects>. Only touches the
+    // element's own layers so different elements can be loaded concurrently
+    int LoadElementEffects(Element *element,
+        const pugi::xml_node &elementNode,
+        int sequenceDurationMS,
+        const std::vector<std::string> & effectStrings,
+        const std::vector<std::string> & colorPalettes,
+        bool importing,
+        SymbolLinks &symbolLinks,
+        const std::function<void(int)> &layerLoaded);
     static bool SortElementsByIndex(const Element *element1, const Element *element2)
     {
         return (element1->GetIndex() < element2->GetIndex());
@@ -275,7 +293,7 @@ private:
 
     // mFirstVisibleModelRow=0 is first model row not the row in Row_Information struct.
     int mFirstVisibleModelRow;
-    unsigned int mChangeCount;
+    std::atomic<unsigned int> mChangeCount;
     unsigned int mMasterViewChangeCount;
     UndoManager undo_mgr;
 
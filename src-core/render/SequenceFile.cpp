@@ -14,6 +14,7 @@
 #include "../utils/XsqFileScanner.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <filesystem>
@@ -36,6 +37,7 @@
 #include "../utils/AppCallbacks.h"
 #include "../utils/string_utils.h"
 #include "../utils/FileUtils.h"
+#include "../utils/Parallel.h"
 #include "RenderUtils.h"
 #include "utils/ExternalHooks.h"
 
@@ -382,6 +384,8 @@ std::optional<pugi::xml_document> SequenceFile::LoadSequence(const std::string&
         spdlog::info("LoadSequence: Loading sequence {}", mFilePath);
     }
 
+    const auto parseStart = std::chrono::steady_clock::now();
+
     // Load with pugixml
     pugi::xml_document loadDoc;
     auto result = loadDoc.load_file(realFilePath.c_str());
@@ -397,26 +401,38 @@ std::optional<pugi::xml_document> SequenceFile::LoadSequence(const std::string&
         root = loadDoc.first_child();
     }
 
-    // Handle CompressedData sections
-    for (auto e = root.child("CompressedData"); e; ) {
+    // Handle CompressedData sections. Each section is independent so they are
+    // decoded and parsed in parallel, then spliced into the root in file order.
+    std::vector<pugi::xml_node> compressed;
+    for (auto e = root.child("CompressedData"); e; e = e.next_sibling("CompressedData")) {
+        compressed.push_back(e);
+    }
+    std::vector<pugi::xml_document> decompressed(compressed.size());
+    parallel_for(0, (int)compressed.size(), [&compressed, &decompressed](int i) {
+        const auto& e = compressed[i];
         int size = e.attribute("size").as_int(0);
         std::string b64Content = e.text().as_string("");
         std::vector<uint8_t> decoded = Base64::Decode(b64Content);
         std::vector<uint8_t> bytes(size + 50);
-        int sz = ZSTD_decompress(bytes.data(), bytes.size(), decoded.data(), decoded.size());
-
-        pugi::xml_document tempDoc;
-        tempDoc.load_buffer(bytes.data(), sz);
+        size_t sz = ZSTD_decompress(bytes.data(), bytes.size(), decoded.data(), decoded.size());
+        if (ZSTD_isError(sz)) {
+            spdlog::error("LoadSequence: Unable to decompress sequence data: {}", ZSTD_getErrorName(sz));
+            return;
+        }
+        decompressed[i].load_buffer(bytes.data(), sz);
+    });
+    for (size_t i = 0; i < compressed.size(); ++i) {
         // Copy top-level elements from decompressed doc into our root
-        for (auto child = tempDoc.first_child(); child; ) {
+        for (auto child = decompressed[i].first_child(); child; ) {
             auto next = child.next_sibling();
             root.append_copy(child);
             child = next;
         }
-        auto next = e.next_sibling("CompressedData");
-        root.remove_child(e);
-        e = next;
+        root.remove_child(compressed[i]);
     }
+    spdlog::info("LoadSequence: XML parsed in {}ms ({} compressed sections).",
+                 std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - parseStart).count(),
+                 compressed.size());
 
     supports_model_blending = std::string(root.attribute("ModelBlending").as_string("false")) == "true";
 
@@ -84,13 +84,23 @@ bool xLightsShowContext::LoadSequenceElements(SequenceFile& file, pugi::xml_docu
     // Views manager must be set before LoadSequencerFile so rows resolve views.
     _sequenceElements.SetViewsManager(&_sequenceViewManager);
 
+    auto phaseStart = std::chrono::steady_clock::now();
+    auto phaseMS = [&phaseStart]() {
+        auto now = std::chrono::steady_clock::now();
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - phaseStart).count();
+        phaseStart = now;
+        return ms;
+    };
+
     if (!_sequenceElements.LoadSequencerFile(file, doc, showDirectory)) {
         return false;
     }
+    auto elementsMS = phaseMS();
 
     // Migrate legacy effect settings to the current format; without this older
     // sequences render with un-migrated settings.
     file.AdjustEffectSettingsForVersion(_sequenceElements, this);
+    auto migrateMS = phaseMS();
 
     // Resolve any models the sequence references that aren't in the layout. This
     // can add/rename elements (desktop remap), so it must run before PrepareViews.
@@ -100,6 +110,10 @@ bool xLightsShowContext::LoadSequenceElements(SequenceFile& file, pugi::xml_docu
     // views crashes in PopulateRowInformation.
     _sequenceElements.PrepareViews(file);
     _sequenceElements.PopulateRowInformation();
+    auto viewsMS = phaseMS();
+
+    spdlog::info("LoadSequenceElements: elements {}ms, settings migration {}ms, models and views {}ms.",
+                 elementsMS, migrateMS, viewsMS);
 
     OnSequenceElementsLoaded(file);
 
@@ -185,6 +199,8 @@ void xLightsShowContext::EnsureSequenceDataSized() {
         spdlog::error("xLightsShowContext: could not abort in-flight render; skipping the seqData resize");
         return;
     }
+    // likewise the output thread reads frames straight out of it
+    _outputScheduler.Stop();
     _seqData.init(numChannels, numFrames, frameTime);
 }
 
@@ -198,6 +214,7 @@ void xLightsShowContext::CloseSequence() {
         spdlog::error("xLightsShowContext: could not abort in-flight render; leaving the sequence data allocated rather than freeing it under a live render job");
         return;
     }
+    _outputScheduler.Stop();
     _sequenceElements.Clear();
     _seqData.Cleanup();
     _sequenceDoc.reset();
@@ -12,6 +12,7 @@
 
 #include "render/RenderContext.h"
 #include "outputs/OutputManager.h"
+#include "outputs/OutputScheduler.h"
 #include "models/OutputModelManager.h"
 #include "models/ModelManager.h"
 #include "models/ViewObjectManager.h"
@@ -102,6 +103,11 @@ public:
     // The render engine's output buffer (frames × channels).
     SequenceData _seqData;
 
+    // Paces played back frames of _seqData out to the lights on its own
+    // thread. Declared after _outputManager/_seqData so it is destroyed, and
+    // its thread joined, before either of them.
+    OutputScheduler _outputScheduler{ &_outputManager };
+
     // 3D viewpoints/cameras (loaded from the show's <Viewpoints>), used by
     // "Per Preview" 3D effect rendering via GetNamedCamera3D.
     ViewpointMgr viewpoint_mgr;
@@ -38,6 +38,10 @@
 #include <sys/sysinfo.h>
 #endif
 
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
 #include <log.h>
 
 #if defined(_MSC_VER) // Visual studio
@@ -647,6 +651,26 @@ uint64_t GetPhysicalMemorySizeMB() {
     return ret;
 }
 
+uint64_t GetPeakProcessMemoryKB() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS mc;
+    if (::GetProcessMemoryInfo(::GetCurrentProcess(), &mc, sizeof(mc)) != 0) {
+        return mc.PeakWorkingSetSize / 1024;
+    }
+    return 0;
+#else
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return (uint64_t)ru.ru_maxrss / 1024; // bytes on macOS
+#else
+    return (uint64_t)ru.ru_maxrss; // already in KB
+#endif
+#endif
+}
+
 void CheckMemoryUsage(const std::string& reason, bool onchangeOnly) {
 #if defined(TURN_THIS_OFF) && defined(_WIN32)
 
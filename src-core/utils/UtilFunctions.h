@@ -168,6 +168,8 @@ bool IsExcessiveMemoryUsage(double physicalMultiplier = 0.95);
 
 void CheckMemoryUsage(const std::string& reason, bool onchangeOnly = false);
 uint64_t GetPhysicalMemorySizeMB();
+// High-water resident set size of this process, in KB (0 if unavailable).
+uint64_t GetPeakProcessMemoryKB();
 
 bool IsxLights();
 void SetIsxLights(bool val);
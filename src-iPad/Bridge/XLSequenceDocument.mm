@@ -11573,7 +11573,7 @@ static const char* kFadeOutKey = "T_TEXTCTRL_Fadeout";
 
     om.StartFrame(frameMS);
     auto& fd = sd[frame];
-    om.SetManyChannels(0, (unsigned char*)&fd[0], sd.NumChannels());
+    om.SetFrame((unsigned char*)&fd[0], sd.NumChannels());
     om.EndFrame();
 }
 
@@ -22,6 +22,7 @@
 #include "render/SeqMediaMigration.h"
 #include "render/SequenceMedia.h"
 #include "media/MediaCompatibility.h"
+#include "media/AudioAnalysisCache.h"
 #include "xLightsVersion.h"
 #include <map>
 #include "effects/ShaderEffect.h"
@@ -151,6 +152,7 @@ bool iPadRenderContext::LoadShowFolder(const std::string& showDir,
 
     showDirectory = showDir;
     fseqDirectory = showDir; // iPad writes the fseq into the show folder
+    AudioAnalysisCache::SetFolder(showDir);
     mediaDirectories.clear();
 
     if (!ObtainAccessToURL(showDir, false)) {
@@ -2518,6 +2520,7 @@ bool iPadRenderContext::TryLoadFseq(const std::string& fseqPath,
     file->prepareRead(expectedRanges, 0);
 
     const uint32_t maxChan = static_cast<uint32_t>(_seqData.NumChannels());
+    const uint64_t dirtyGeneration = _seqData.GetDirtyGeneration();
     for (uint32_t fr = 0; fr < fileFrames; ++fr) {
         std::unique_ptr<FSEQFile::FrameData> fd(file->getFrame(fr));
         if (!fd) {
@@ -2530,6 +2533,9 @@ bool iPadRenderContext::TryLoadFseq(const std::string& fseqPath,
         }
     }
 
+    // the data now matches the file, so the next WriteFseq can reuse its blocks
+    _seqData.SetSyncedFseq(file->getUniqueId(), dirtyGeneration);
+
     spdlog::info("TryLoadFseq: loaded {} frames over {} sparse range(s) from {}",
                  fileFrames, expectedRanges.size(), fseqPath);
     return true;
@@ -32,6 +32,7 @@
 #include "render/EffectLayer.h"
 #include "render/Element.h"
 #include "media/AudioManager.h"
+#include "media/AudioAnalysisCache.h"
 #include "effects/RenderableEffect.h"
 #include "models/ModelGroup.h"
 #include "models/SubModel.h"
@@ -610,6 +611,7 @@ void xLightsFrame::LoadEffectsFile()
         UnsavedRgbEffectsChanges = true;
     }
     _renderCache.SetRenderCacheFolder(renderCacheDirectory);
+    AudioAnalysisCache::SetFolder(renderCacheDirectory);
 
     mStoredLayoutGroup = GetXmlSetting("storedLayoutGroup", "Default");
 
@@ -14,6 +14,7 @@
 #include "nlohmann/json.hpp"
 
 #include "render/FSEQFile.h"
+#include "render/FSEQFileIO.h"
 #include "outputs/Controller.h"
 #include "outputs/ControllerEthernet.h"
 #include "layout/LayoutPanel.h"
@@ -448,31 +449,12 @@ bool xLightsFrame::ProcessAutomation(std::vector<std::string> &paths,
             // every frame is read in order below to build the upload
             seq->setReadPattern(FSEQFile::ReadPattern::Bulk);
             fpp->PrepareUploadSequence(seq, fseq, m2, fseqType);
-            static const int FRAMES_TO_BUFFER = 50;
-            std::vector<std::vector<uint8_t>> frames(FRAMES_TO_BUFFER);
-            for (size_t x = 0; x < frames.size(); x++) {
-                frames[x].resize(seq->getMaxChannel() + 1);
-            }
-
-            for (size_t frame = 0; frame < seq->getNumFrames(); frame++) {
-                int lastBuffered = 0;
-                size_t startFrame = frame;
-                //Read a bunch of frames so each parallel thread has more info to work with before returning out here
-                while (lastBuffered < FRAMES_TO_BUFFER && frame < seq->getNumFrames()) {
-                    FSEQFile::FrameData* f = seq->getFrame(frame);
-                    if (f != nullptr) {
-                        if (!f->readFrame(&frames[lastBuffered][0], frames[lastBuffered].size())) {
-                            //spdlog::error("FPPConnect FSEQ file corrupt.");
-                            res = false;
-                        }
-                        delete f;
-                    }
-                    lastBuffered++;
-                    frame++;
-                }
-                frame--;
-                for (int x = 0; x < lastBuffered; x++) {
-                    fpp->AddFrameToUpload(startFrame + x, &frames[x][0]);
+            if (fpp->NeedCustomSequence()) {
+                if (FSEQFileIO::FanOutFrames(*seq, { [fpp](uint32_t frame, const uint8_t* data) {
+                        fpp->AddFrameToUpload(frame, data);
+                    } }) != FSEQFileIO::FanOutResult::Done) {
+                    // FSEQ file corrupt, still upload what we could read but report the failure
+                    res = false;
                 }
             }
             fpp->FinalizeUploadSequence();
@@ -34,7 +34,7 @@
 
 #include "utils/XsqFileScanner.h"
 #include "render/FSEQFile.h"
-#include "Parallel.h"
+#include "render/FSEQFileIO.h"
 #include "discovery/Discovery.h"
 #include "setup/DiscoveryAuthDialog.h"
 #include "controllers/Falcon.h"
@@ -1420,46 +1420,28 @@ void FPPConnectDialog::doUpload(FPPUploadProgressDialog *prgs, std::vector<bool>
                             inst->updateProgress(0, false);
                         }
                         wxYield();
-                        int lastDone = 0;
-                        static const int FRAMES_TO_BUFFER = 50;
-                        std::vector<std::vector<uint8_t>> frames(FRAMES_TO_BUFFER);
-                        for (size_t x = 0; x < frames.size(); x++) {
-                            frames[x].resize(seq->getMaxChannel() + 1);
-                        }
-
-                        for (size_t frame = 0; frame < seq->getNumFrames() && !cancelled; frame++) {
-                            int donePct = frame * 1000 / seq->getNumFrames();
-                            if (donePct != lastDone) {
-                                lastDone = donePct;
-                                for (const auto& inst : instances) {
-                                    inst->updateProgress(donePct, false);
-                                }
-                                wxYield();
+                        // one decode of the master sequence feeds every instance's own sparse file
+                        std::vector<FSEQFileIO::FrameSink> sinks;
+                        row = 0;
+                        for (const auto& inst : instances) {
+                            if (doUpload[row] && inst->NeedCustomSequence()) {
+                                sinks.push_back([inst](uint32_t frame, const uint8_t* data) {
+                                    inst->AddFrameToUpload(frame, data);
+                                });
                             }
-
-                            int lastBuffered = 0;
-                            size_t startFrame = frame;
-                            //Read a bunch of frames so each parallel thread has more info to work with before returning out here
-                            while (lastBuffered < FRAMES_TO_BUFFER && frame < seq->getNumFrames()) {
-                                FSEQFile::FrameData *f = seq->getFrame(frame);
-                                if (f != nullptr) {
-                                    if (!f->readFrame(&frames[lastBuffered][0], frames[lastBuffered].size())) {
-                                        spdlog::error("FPPConnect FSEQ file corrupt.");
-                                    }
-                                    delete f;
-                                }
-                                lastBuffered++;
-                                frame++;
+                            row++;
+                        }
+                        auto result = FSEQFileIO::FanOutFrames(*seq, sinks, [&instances, prgs](int donePct) {
+                            for (const auto& inst : instances) {
+                                inst->updateProgress(donePct, false);
                             }
-                            frame--;
-                            std::function<void(FPP * &, int)> func = [startFrame, lastBuffered, &frames, &doUpload](FPP* &inst, int row) {
-                                if (doUpload[row]) {
-                                    for (int x = 0; x < lastBuffered; x++) {
-                                        inst->AddFrameToUpload(startFrame + x, &frames[x][0]);
-                                    }
-                                }
-                            };
-                            parallel_for(instances, func);
+                            wxYield();
+                            return !prgs->isCancelled();
+                        });
+                        if (result == FSEQFileIO::FanOutResult::Stopped) {
+                            cancelled = true;
+                        } else if (result == FSEQFileIO::FanOutResult::ReadErrors) {
+                            spdlog::error("FPPConnect FSEQ file corrupt.");
                         }
                     }
                     row = 0;
@@ -1384,6 +1384,8 @@ void FileConverter::ReadFalconFile(ConvertParameters& params)
 
     uint8_t *tmpBuf = new uint8_t[numChannels];
     int periodsRead = 0;
+    bool readFailed = false;
+    const uint64_t dirtyGeneration = params.seq_data.GetDirtyGeneration();
     while (periodsRead < falconPeriods) {
         FSEQFile::FrameData *data = file->getFrame(periodsRead);
         if (data == nullptr) break;
@@ -1393,6 +1395,7 @@ void FileConverter::ReadFalconFile(ConvertParameters& params)
             {
                 // fseq file corrupt
                 spdlog::error("FSEQ file seems to be corrupt.");
+                readFailed = true;
             }
         } else {
             if (data->readFrame(tmpBuf, numChannels))
@@ -1414,12 +1417,17 @@ void FileConverter::ReadFalconFile(ConvertParameters& params)
             {
                 // fseq file corrupt
                 spdlog::error("FSEQ file seems to be corrupt.");
+                readFailed = true;
             }
         }
         delete data;
         periodsRead++;
     }
     delete[]tmpBuf;
+    if (params.read_mode == ConvertParameters::READ_MODE_LOAD_MAIN && channel_offset == 0 && periodsRead == falconPeriods && !readFailed) {
+        // the data is exactly what is in the file so the next save can reuse its blocks
+        params.seq_data.SetSyncedFseq(file->getUniqueId(), dirtyGeneration);
+    }
 #ifndef NDEBUG
     params.AppendConvertStatus(string_format(wxString("Read ISEQ File SeqData.NumFrames()=%d SeqData.NumChannels()=%d"), params.seq_data.NumFrames(), params.seq_data.NumChannels()));
 #endif
@@ -196,6 +196,8 @@ void xLightsFrame::NewSequence(const std::string& media, uint32_t durationMS, ui
         DisplayWarning(wxString::Format("The setup requires a large amount of memory (%lu MB) which could result in performance issues.", (unsigned long)memRequired), this);
     }
 
+    // the output thread must not be reading the frames while they are reallocated
+    _outputScheduler.Stop();
     if ((max > _seqData.NumChannels()) ||
         (CurrentSeqXmlFile->GetSequenceDurationMS() / ms) > (long)_seqData.NumFrames()) {
         _seqData.init(max, mMediaLengthMS / ms, ms);
@@ -600,6 +602,7 @@ void xLightsFrame::OpenSequence(const wxString& passed_filename, ConvertLogDialo
         spdlog::debug("Sequence Num Channels: {} or {}", numChan, _seqData.NumChannels());
         spdlog::debug("Sequence Num Frames: {}", (int)(CurrentSeqXmlFile->GetSequenceDurationMS() / ms));
 
+        _outputScheduler.Stop();
         if ((roundTo4(numChan) != _seqData.NumChannels()) ||
             (CurrentSeqXmlFile->GetSequenceDurationMS() / ms) > (long)_seqData.NumFrames()) {
             if (_seqData.NumChannels() > 0) {
@@ -1139,6 +1142,7 @@ bool xLightsFrame::CloseSequence()
     }
     if (displayElementsPanel != nullptr)
         displayElementsPanel->SetEffectSequenceMode(false);
+    _outputScheduler.Stop();
     _seqData.init(0, 0, 50);
     EnableSequenceControls(true); // let it re-evaluate menu state
     SetStatusText("");
@@ -1214,6 +1214,7 @@ void xLightsFrame::UnselectEffect(){
         playStartTime = -1;
         playEndTime = -1;
         playStartMS = -1;
+        _outputScheduler.Stop(); // so it can't send another frame after the blackout
         _outputManager.AllOff(); // Force clear all outputs just in case we are sending data
     }
     sEffectAssist->SetPanel(nullptr);
@@ -2091,6 +2092,7 @@ void xLightsFrame::DoStopSequence()
         mainSequencer->UpdateTimeDisplay(playStartTime, _fps);
     }
     SetPlayStatus(PLAY_TYPE_STOPPED);
+    _outputScheduler.Stop();
     if( CheckBoxLightOutput->IsChecked()) {
         _outputManager.AllOff();
     }
@@ -2756,17 +2758,20 @@ bool xLightsFrame::TimerRgbSeq(long msec)
 
     // return if play is stopped
     if (playType == PLAY_TYPE_STOPPED || CurrentSeqXmlFile == nullptr) {
+        _outputScheduler.Stop();
         return false;
     }
 
     // return if paused
     if (playType == PLAY_TYPE_EFFECT_PAUSED || playType == PLAY_TYPE_MODEL_PAUSED) {
+        _outputScheduler.Stop();
         playStartMS = msec - playOffsetTime;  // maintain offset so we can restart where we paused
         return false;
     }
 
     // return if we have reset play times
     if (playEndTime == 0) {
+        _outputScheduler.Stop();
         return false;
     }
 
@@ -2839,14 +2844,14 @@ bool xLightsFrame::TimerRgbSeq(long msec)
     }
     playCurFrame = frame;
     
-    if (_outputManager.IsOutputting()) {
-        _outputManager.StartFrame(msec);
+    // the lights are fed from the output scheduler's thread so UI work here cannot delay packets
+    if (_outputManager.IsOutputting() && CheckBoxLightOutput->IsChecked()) {
+        _outputScheduler.Play(&_seqData, curt);
+    } else {
+        _outputScheduler.Stop();
     }
     std::vector<bool> didRender(8);
     if (frame < (int)_seqData.NumFrames()) {
-        //spdlog::debug("Outputting Frame {}", frame);
-        // have the frame, copy from SeqData
-        TimerOutput(frame);
         if (playModel != nullptr && NeedToRenderFrame(_modelPreviewPanel, OutputTimer, didRender)) {
             int nn = playModel->GetNodeCount();
             for (int node = 0; node < nn; node++) {
@@ -2917,9 +2922,6 @@ bool xLightsFrame::TimerRgbSeq(long msec)
         }
     }
 #endif
-    if (_outputManager.IsOutputting()) {
-        _outputManager.EndFrame();
-    }
     return true;
 }
 
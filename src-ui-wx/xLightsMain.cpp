@@ -115,6 +115,7 @@
 #include "import_export/VendorModelDialog.h"
 #include "import_export/VendorMusicDialog.h"
 #include "media/VideoExporter.h"
+#include "media/AudioAnalysisCache.h"
 #include "layout/ViewsModelsPanel.h"
 #include "xLightsApp.h"
 #include "xLightsMain.h"
@@ -2233,6 +2234,7 @@ xLightsFrame::~xLightsFrame()
     }
 
     selectedEffect = nullptr;
+    _outputScheduler.Stop();
     _outputManager.AllOff();
     _outputManager.StopOutput();
     SetConfigBool("OutputActive", false);
@@ -2736,6 +2738,8 @@ void xLightsFrame::OnOutputTimerTrigger(wxTimerEvent& event)
         default:
             if (_outputManager.IsOutputting()) {
                 needTimer = true;
+                // left running by playback on the sequencer tab until its watchdog fires
+                _outputScheduler.Stop();
                 _outputManager.StartFrame(curtime);
                 _outputManager.EndFrame();
             }
@@ -2958,6 +2962,7 @@ void xLightsFrame::OnNotebook1PageChanged1(wxAuiNotebookEvent& event)
 void xLightsFrame::CycleOutputsIfOn()
 {
     if (_outputManager.IsOutputting()) {
+        _outputScheduler.Stop();
         _outputManager.StopOutput();
         SetConfigBool("OutputActive", false);
         EnableSleepModes();
@@ -3018,6 +3023,7 @@ bool xLightsFrame::EnableOutputs(bool ignoreCheck)
 bool xLightsFrame::DisableOutputs()
 {
     if (_outputManager.IsOutputting()) {
+        _outputScheduler.Stop();
         _outputManager.AllOff();
         _outputManager.StopOutput();
         SetConfigBool("OutputActive", false);
@@ -4915,6 +4921,7 @@ void xLightsFrame::SetRenderCacheFolder(bool useShow, const std::string& folder)
     }
 
     SetXmlSetting("renderCacheDir", renderCacheDirectory);
+    AudioAnalysisCache::SetFolder(renderCacheDirectory);
     UnsavedRgbEffectsChanges = true;
     UpdateLayoutSave();
 
@@ -6524,7 +6531,9 @@ void xLightsFrame::OnMenuItem_CleanupFileLocationsSelected(wxCommandEvent& event
 void xLightsFrame::TimerOutput(int period)
 {
     if (CheckBoxLightOutput->IsChecked()) {
-        _outputManager.SetManyChannels(0, &_seqData[period][0], _seqData.NumChannels());
+        // the output thread must not be writing to the outputs at the same time
+        _outputScheduler.Stop();
+        _outputManager.SetFrame(&_seqData[period][0], _seqData.NumChannels());
     }
 }
 
@@ -7882,6 +7891,7 @@ void xLightsFrame::OnMenuItemUserDictSelected(wxCommandEvent& event)
 void xLightsFrame::OnMenuItem_PurgeRenderCacheSelected(wxCommandEvent& event)
 {
     _renderCache.Purge(&_sequenceElements, true);
+    AudioAnalysisCache::Purge();
 }
 
 void xLightsFrame::SetEnableRenderCache(const wxString& t)
@@ -0,0 +1,104 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "pch.h"
+
+#include <sstream>
+
+#include "../../src-core/controllers/FPPSequencePatch.h"
+
+// a 64 byte "sequence" of four 16 byte blocks, AAAA... BBBB... CCCC... DDDD...
+static const std::string SEQUENCE = std::string(16, 'A') + std::string(16, 'B') + std::string(16, 'C') + std::string(16, 'D');
+static const std::vector<uint64_t> BLOCKS = { 16, 32, 48 };
+
+// FPP's copy has A at the start and B C together further in, but no D
+static const std::string REMOTE_BLOCKS = R"({"Blocks": [
+    {"Offset": 0, "Length": 16, "Hash": "d8a73157ce10cd94a91c2079fc9a92c8"},
+    {"Offset": 100, "Length": 16, "Hash": "232555f36a0bb24f621267ffeed5c06e"},
+    {"Offset": 116, "Length": 16, "Hash": "80fda7545b1fc3f70af956e7cbdf33bf"},
+    {"Offset": 132, "Length": 8, "Hash": "629f0b541d8ebec86267b948c0381de5"}
+]})";
+
+TEST(FPP_Patch_Tests, Segments_Follow_Blocks) {
+    auto segments = FPPSequencePatch::GetSegments(BLOCKS, 64);
+    std::vector<std::pair<uint64_t, uint64_t>> expected = { { 0, 16 }, { 16, 16 }, { 32, 16 }, { 48, 16 } };
+    EXPECT_EQ(segments, expected);
+}
+
+TEST(FPP_Patch_Tests, Segments_Split_Large_Blocks) {
+    auto segments = FPPSequencePatch::GetSegments({ 100 }, 250, 64);
+    std::vector<std::pair<uint64_t, uint64_t>> expected = { { 0, 64 }, { 64, 36 }, { 100, 64 }, { 164, 64 }, { 228, 22 } };
+    EXPECT_EQ(segments, expected);
+}
+
+TEST(FPP_Patch_Tests, Segments_Ignore_Bad_Offsets) {
+    // repeated, backwards and past the end offsets are dropped
+    auto segments = FPPSequencePatch::GetSegments({ 16, 16, 8, 32, 500 }, 48);
+    std::vector<std::pair<uint64_t, uint64_t>> expected = { { 0, 16 }, { 16, 16 }, { 32, 16 } };
+    EXPECT_EQ(segments, expected);
+    EXPECT_TRUE(FPPSequencePatch::GetSegments({}, 48).empty());
+}
+
+TEST(FPP_Patch_Tests, Build_Copies_Matches_And_Sends_The_Rest) {
+    std::istringstream in(SEQUENCE);
+    std::ostringstream patch;
+    FPPSequencePatch::Patch plan;
+    ASSERT_TRUE(FPPSequencePatch::Build(in, FPPSequencePatch::GetSegments(BLOCKS, 64), REMOTE_BLOCKS, patch, plan));
+
+    // B and C are next to each other on FPP so they are one op, D matches a hash
+    // but not a length so it is sent
+    ASSERT_EQ(plan.ops.size(), 3u);
+    EXPECT_TRUE(plan.ops[0].copy);
+    EXPECT_EQ(plan.ops[0].offset, 0u);
+    EXPECT_EQ(plan.ops[0].length, 16u);
+    EXPECT_TRUE(plan.ops[1].copy);
+    EXPECT_EQ(plan.ops[1].offset, 100u);
+    EXPECT_EQ(plan.ops[1].length, 32u);
+    EXPECT_FALSE(plan.ops[2].copy);
+    EXPECT_EQ(plan.ops[2].offset, 0u);
+    EXPECT_EQ(plan.ops[2].length, 16u);
+
+    EXPECT_EQ(patch.str(), std::string(16, 'D'));
+    EXPECT_EQ(plan.copied, 48u);
+    EXPECT_EQ(plan.patchLength, 16u);
+    EXPECT_EQ(plan.total, 64u);
+    EXPECT_EQ(plan.hash, "0cce78ef046f090da7eacd9a9db30b5a");
+}
+
+TEST(FPP_Patch_Tests, Build_Merges_Consecutive_Data) {
+    std::istringstream in(SEQUENCE);
+    std::ostringstream patch;
+    FPPSequencePatch::Patch plan;
+    const std::string remote = R"({"Blocks": [{"Offset": 0, "Length": 16, "Hash": "d8a73157ce10cd94a91c2079fc9a92c8"}]})";
+    ASSERT_TRUE(FPPSequencePatch::Build(in, FPPSequencePatch::GetSegments(BLOCKS, 64), remote, patch, plan));
+    ASSERT_EQ(plan.ops.size(), 2u);
+    EXPECT_TRUE(plan.ops[0].copy);
+    EXPECT_FALSE(plan.ops[1].copy);
+    EXPECT_EQ(plan.ops[1].length, 48u);
+    EXPECT_EQ(patch.str(), SEQUENCE.substr(16));
+}
+
+TEST(FPP_Patch_Tests, Build_Rejects_Unusable_Blocks) {
+    auto segments = FPPSequencePatch::GetSegments(BLOCKS, 64);
+    for (const std::string remote : { "", "not json", "{}", R"({"Blocks": {}})", R"({"Blocks": []})",
+                                      R"({"Blocks": [{"Offset": "0", "Length": 16, "Hash": "x"}]})" }) {
+        std::istringstream in(SEQUENCE);
+        std::ostringstream patch;
+        FPPSequencePatch::Patch plan;
+        EXPECT_FALSE(FPPSequencePatch::Build(in, segments, remote, patch, plan)) << remote;
+    }
+}
+
+TEST(FPP_Patch_Tests, Build_Fails_On_Short_File) {
+    std::istringstream in(SEQUENCE.substr(0, 40));
+    std::ostringstream patch;
+    FPPSequencePatch::Patch plan;
+    EXPECT_FALSE(FPPSequencePatch::Build(in, FPPSequencePatch::GetSegments(BLOCKS, 64), REMOTE_BLOCKS, patch, plan));
+}
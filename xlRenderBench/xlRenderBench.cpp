@@ -0,0 +1,561 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/xLightsSequencer/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/xLightsSequencer/xLights/blob/master/License.txt
+ **************************************************************/
+
+// xlRenderBench - headless render benchmark.
+//
+// Renders a set of sequences through HeadlessRenderContext / RenderEngine::Render
+// with profiling on and writes one JSON document describing every case: frames,
+// wall time, frames/sec, suspensions, process peak RSS and the per-effect CPU/GPU
+// time from RenderJobProfile.  With --baseline it compares against an earlier
+// JSON and exits 1 if any case regressed by more than --threshold percent.
+//
+// Cases come from two places:
+//   --synthetic               a generated show (N matrices) plus one sequence per
+//                             effect in --effects, so each effect is measured alone
+//   -s <showdir> seq.xsq ...  reference sequences from a real show folder
+//
+//   xlRenderBench --synthetic --json out.json
+//   xlRenderBench -s ~/show a.xsq b.xsq --baseline base.json --threshold 10
+//
+// --timing-marks N adds a microbenchmark of the EffectLayer time lookups: a
+// timing track of N back-to-back marks is added to the first case's sequence
+// and queried through the layer's time index and through a plain scan.
+//
+// Text/Shape and shader effects need the desktop's wx text backend and a GL
+// context, neither of which exists here - they render their fallbacks, so keep
+// them out of baselines.
+
+#include "render/Effect.h"
+#include "render/EffectLayer.h"
+#include "render/Element.h"
+#include "render/HeadlessRenderContext.h"
+#include "render/RenderProfile.h"
+#include "render/SequenceData.h"
+#include "utils/UtilFunctions.h"
+#include "xLightsVersion.h"
+
+#include <nlohmann/json.hpp>
+#include <pugixml.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct BenchCase {
+    std::string name;
+    std::string showDir;
+    std::string xsqPath;
+};
+
+struct BenchOptions {
+    bool synthetic = false;
+    int syntheticModels = 32;
+    int syntheticWidth = 50;
+    int syntheticHeight = 32;
+    int syntheticDurationMS = 20000;
+    std::vector<std::string> syntheticEffects = { "Bars", "Butterfly", "Color Wash", "Fire", "Galaxy", "Meteors",
+                                                  "Pinwheel", "Plasma", "Shimmer", "Spirals", "Twinkle", "Wave" };
+    std::string showDir;
+    std::vector<std::string> sequences;
+    std::string jsonOut;
+    std::string baseline;
+    double thresholdPct = 10.0;
+    double minEffectMS = 5.0; // effects cheaper than this in the baseline are noise
+    int repeat = 3;
+    int timingMarks = 0;
+};
+
+std::vector<std::string> SplitList(const std::string& s) {
+    std::vector<std::string> out;
+    size_t start = 0;
+    while (start <= s.size()) {
+        size_t e = s.find(',', start);
+        if (e == std::string::npos) e = s.size();
+        if (e > start) out.push_back(s.substr(start, e - start));
+        start = e + 1;
+    }
+    return out;
+}
+
+void Usage() {
+    std::fprintf(stderr,
+                 "usage: xlRenderBench [--synthetic] [--models N] [--size WxH] [--duration ms]\n"
+                 "                     [--effects A,B,...] [-s showdir seq.xsq ...]\n"
+                 "                     [--repeat N] [--json out.json] [--timing-marks N]\n"
+                 "                     [--baseline base.json] [--threshold pct] [--min-effect-ms ms]\n");
+}
+
+bool ParseArgs(int argc, char** argv, BenchOptions& o) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        auto next = [&](const char* what) -> const char* {
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "%s requires a value\n", what);
+                return nullptr;
+            }
+            return argv[++i];
+        };
+        if (a == "--synthetic") {
+            o.synthetic = true;
+        } else if (a == "--models") {
+            const char* v = next("--models");
+            if (!v) return false;
+            o.syntheticModels = std::max(1, std::atoi(v));
+        } else if (a == "--size") {
+            const char* v = next("--size");
+            if (!v || std::sscanf(v, "%dx%d", &o.syntheticWidth, &o.syntheticHeight) != 2) return false;
+        } else if (a == "--duration") {
+            const char* v = next("--duration");
+            if (!v) return false;
+            o.syntheticDurationMS = std::max(1000, std::atoi(v));
+        } else if (a == "--effects") {
+            const char* v = next("--effects");
+            if (!v) return false;
+            o.syntheticEffects = SplitList(v);
+        } else if (a == "-s" || a == "--show") {
+            const char* v = next("-s");
+            if (!v) return false;
+            o.showDir = v;
+        } else if (a == "--repeat") {
+            const char* v = next("--repeat");
+            if (!v) return false;
+            o.repeat = std::max(1, std::atoi(v));
+        } else if (a == "--timing-marks") {
+            const char* v = next("--timing-marks");
+            if (!v) return false;
+            o.timingMarks = std::max(0, std::atoi(v));
+        } else if (a == "--json") {
+            const char* v = next("--json");
+            if (!v) return false;
+            o.jsonOut = v;
+        } else if (a == "--baseline") {
+            const char* v = next("--baseline");
+            if (!v) return false;
+            o.baseline = v;
+        } else if (a == "--threshold") {
+            const char* v = next("--threshold");
+            if (!v) return false;
+            o.thresholdPct = std::atof(v);
+        } else if (a == "--min-effect-ms") {
+            const char* v = next("--min-effect-ms");
+            if (!v) return false;
+            o.minEffectMS = std::atof(v);
+        } else if (a == "-h" || a == "--help") {
+            return false;
+        } else if (!a.empty() && a[0] != '-') {
+            o.sequences.push_back(a);
+        } else {
+            std::fprintf(stderr, "unknown option %s\n", a.c_str());
+            return false;
+        }
+    }
+    if (!o.synthetic && o.sequences.empty()) {
+        return false;
+    }
+    if (!o.sequences.empty() && o.showDir.empty()) {
+        std::fprintf(stderr, "reference sequences need a show folder (-s <dir>)\n");
+        return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Synthetic show: N horizontal matrices on consecutive absolute channels and
+// one sequence per effect, each model carrying back-to-back 2s instances of
+// that effect so the row renders for the whole duration.
+
+bool WriteSyntheticShow(const std::string& dir, const BenchOptions& o) {
+    pugi::xml_document doc;
+    auto root = doc.append_child("xrgb");
+    auto models = root.append_child("models");
+    long start = 1;
+    for (int m = 0; m < o.syntheticModels; ++m) {
+        auto n = models.append_child("model");
+        n.append_attribute("name") = ("Bench Matrix " + std::to_string(m + 1)).c_str();
+        n.append_attribute("DisplayAs") = "Horiz Matrix";
+        n.append_attribute("StringType") = "RGB Nodes";
+        n.append_attribute("NumStrings") = o.syntheticHeight;
+        n.append_attribute("NodesPerString") = o.syntheticWidth;
+        n.append_attribute("StrandsPerString") = 1;
+        n.append_attribute("StartChannel") = std::to_string(start).c_str();
+        n.append_attribute("LayoutGroup") = "Default";
+        n.append_attribute("WorldPosX") = (double)(m % 8) * 120.0;
+        n.append_attribute("WorldPosY") = (double)(m / 8) * 120.0;
+        start += (long)o.syntheticWidth * o.syntheticHeight * 3;
+    }
+    root.append_child("modelGroups");
+    return doc.save_file((dir + "/xlights_rgbeffects.xml").c_str());
+}
+
+bool WriteSyntheticSequence(const std::string& path, const std::string& effect, const BenchOptions& o) {
+    constexpr int EFFECT_MS = 2000;
+    pugi::xml_document doc;
+    auto root = doc.append_child("xsequence");
+    root.append_attribute("BaseChannel") = "0";
+    root.append_attribute("ChanCtrlBasic") = "0";
+    root.append_attribute("ChanCtrlColor") = "0";
+    root.append_attribute("FixedPointTiming") = "1";
+    root.append_attribute("ModelBlending") = "true";
+
+    auto head = root.append_child("head");
+    head.append_child("version").text().set(xlights_version_string.c_str());
+    head.append_child("sequenceTiming").text().set("25 ms");
+    head.append_child("sequenceType").text().set("Animation");
+    head.append_child("mediaFile");
+    head.append_child("sequenceDuration").text().set(fmt::format("{:.3f}", o.syntheticDurationMS / 1000.0).c_str());
+
+    root.append_child("ColorPalettes").append_child("ColorPalette").text().set(
+        "C_BUTTON_Palette1=#FF0000,C_BUTTON_Palette2=#00FF00,C_BUTTON_Palette3=#0000FF,"
+        "C_CHECKBOX_Palette1=1,C_CHECKBOX_Palette2=1,C_CHECKBOX_Palette3=1");
+    root.append_child("EffectDB").append_child("Effect").text().set("B_CHOICE_BufferStyle=Default");
+
+    auto display = root.append_child("DisplayElements");
+    auto effects = root.append_child("ElementEffects");
+    for (int m = 0; m < o.syntheticModels; ++m) {
+        const std::string name = "Bench Matrix " + std::to_string(m + 1);
+        auto de = display.append_child("Element");
+        de.append_attribute("collapsed") = 0;
+        de.append_attribute("type") = "model";
+        de.append_attribute("name") = name.c_str();
+        de.append_attribute("visible") = 1;
+
+        auto ee = effects.append_child("Element");
+        ee.append_attribute("type") = "model";
+        ee.append_attribute("name") = name.c_str();
+        auto layer = ee.append_child("EffectLayer");
+        for (int t = 0; t + EFFECT_MS <= o.syntheticDurationMS; t += EFFECT_MS) {
+            auto e = layer.append_child("Effect");
+            e.append_attribute("ref") = 0;
+            e.append_attribute("name") = effect.c_str();
+            e.append_attribute("startTime") = t;
+            e.append_attribute("endTime") = t + EFFECT_MS;
+            e.append_attribute("palette") = 0;
+        }
+    }
+    return doc.save_file(path.c_str());
+}
+
+std::string CaseSlug(const std::string& s) {
+    std::string r;
+    for (char c : s) {
+        r += (std::isalnum((unsigned char)c) ? c : '_');
+    }
+    return r;
+}
+
+// ---------------------------------------------------------------------------
+
+struct RunResult {
+    bool ok = false;
+    unsigned int frames = 0;
+    long long wallMS = 0;
+    nlohmann::json effects = nlohmann::json::object();
+    int suspends = 0;
+    double suspendedMS = 0;
+    uint64_t peakBufferBytes = 0;
+    double effectMS = 0;
+    double blendMS = 0;
+    double outputMS = 0;
+};
+
+RunResult RunCase(const BenchCase& c) {
+    RunResult r;
+    HeadlessRenderContext ctx;
+    if (!ctx.LoadShowFolder(c.showDir)) {
+        spdlog::error("xlRenderBench: failed to load show folder {}", c.showDir);
+        return r;
+    }
+
+    // The callback runs on the render thread that finished the batch; the
+    // engine may split a render into several batches, so fold them together.
+    std::mutex lock;
+    RenderJobProfile total;
+    int suspends = 0;
+    uint64_t suspendedNs = 0;
+    uint64_t peakBufferBytes = 0;
+    ctx.SetRenderProfileCallback([&](const RenderBatchProfile& b) {
+        std::lock_guard<std::mutex> lk(lock);
+        total.merge(b.total);
+        suspends += b.suspends;
+        suspendedNs += b.suspendedNs;
+        peakBufferBytes = std::max(peakBufferBytes, b.peakBufferBytes);
+    });
+
+    if (!ctx.OpenSequence(c.xsqPath)) {
+        spdlog::error("xlRenderBench: failed to open {}", c.xsqPath);
+        return r;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    r.ok = ctx.RenderAndWait();
+    r.wallMS = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    r.frames = ctx.GetSeqData().NumFrames();
+    ctx.CloseSequence();
+
+    std::lock_guard<std::mutex> lk(lock);
+    auto ms = [](uint64_t ns) { return (double)ns / 1.0e6; };
+    r.suspends = suspends;
+    r.suspendedMS = ms(suspendedNs);
+    r.peakBufferBytes = peakBufferBytes;
+    r.effectMS = ms(total.effectNs);
+    r.blendMS = ms(total.blendNs);
+    r.outputMS = ms(total.outputNs());
+    for (const auto& e : total.perEffectNs) {
+        auto cnt = total.perEffectCount.find(e.first);
+        auto gpu = total.perEffectGpuNs.find(e.first);
+        const uint64_t renders = cnt != total.perEffectCount.end() ? cnt->second : 0;
+        const uint64_t gpuNs = gpu != total.perEffectGpuNs.end() ? gpu->second : 0;
+        r.effects[e.first] = {
+            { "ns", e.second },
+            { "gpuNs", gpuNs },
+            { "renders", renders },
+            { "nsPerRender", renders ? (double)(e.second + gpuNs) / (double)renders : 0.0 }
+        };
+    }
+    return r;
+}
+
+nlohmann::json BenchCaseJSON(const BenchCase& c, int repeat) {
+    // Keep the fastest repetition: the minimum is the least noisy estimate of
+    // what the code costs, the rest is the machine being busy.
+    RunResult best;
+    for (int i = 0; i < repeat; ++i) {
+        RunResult r = RunCase(c);
+        if (!r.ok) {
+            return { { "name", c.name }, { "ok", false } };
+        }
+        if (!best.ok || r.wallMS < best.wallMS) {
+            best = std::move(r);
+        }
+    }
+    const double fps = best.wallMS > 0 ? (double)best.frames * 1000.0 / (double)best.wallMS : 0.0;
+    spdlog::info("xlRenderBench: {}: {} frames in {} ms ({:.1f} fps)", c.name, best.frames, best.wallMS, fps);
+    return {
+        { "name", c.name },
+        { "ok", true },
+        { "frames", best.frames },
+        { "wallMs", best.wallMS },
+        { "fps", fps },
+        { "suspends", best.suspends },
+        { "suspendedMs", best.suspendedMS },
+        { "peakBufferBytes", best.peakBufferBytes },
+        { "effectMs", best.effectMS },
+        { "blendMs", best.blendMS },
+        { "outputMs", best.outputMS },
+        // High-water mark of the whole process, so it never drops between cases.
+        { "peakRssKB", GetPeakProcessMemoryKB() },
+        { "effects", best.effects }
+    };
+}
+
+// Every lookup the effect grid and value curve timing make per mark, against a
+// track of `marks` 50ms marks, queried every 10ms of its length.
+nlohmann::json TimingLookupJSON(const BenchCase& c, int marks) {
+    constexpr int MARK_MS = 50;
+    constexpr int STEP_MS = 10;
+    HeadlessRenderContext ctx;
+    if (!ctx.LoadShowFolder(c.showDir) || !ctx.OpenSequence(c.xsqPath)) {
+        return { { "marks", marks }, { "ok", false } };
+    }
+    Element* el = ctx.GetSequenceElements().AddElement("xlRenderBench Timing", "timing", true, false, true, false, false);
+    if (el == nullptr) {
+        return { { "marks", marks }, { "ok", false } };
+    }
+    EffectLayer* layer = el->AddEffectLayer();
+    for (int m = 0; m < marks; ++m) {
+        layer->AddEffect(0, "M" + std::to_string(m), "", "", m * MARK_MS, (m + 1) * MARK_MS, 0, false, true);
+    }
+
+    // what the lookups did before the index: first effect in layer order
+    auto scan = [layer](int ms) -> Effect* {
+        for (const auto& e : layer->GetEffects()) {
+            if (ms >= e->GetStartTimeMS() && ms <= e->GetEndTimeMS()) {
+                return e;
+            }
+        }
+        return nullptr;
+    };
+
+    const int endMS = marks * MARK_MS;
+    const int queries = endMS / STEP_MS;
+    size_t hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int ms = 0; ms < endMS; ms += STEP_MS) {
+        hits += scan(ms) != nullptr;
+    }
+    const double scanNs = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    layer->GetEffectAtTime(0); // build the index outside the timed loop
+    size_t indexedHits = 0;
+    bool match = true;
+    start = std::chrono::steady_clock::now();
+    for (int ms = 0; ms < endMS; ms += STEP_MS) {
+        indexedHits += layer->GetEffectAtTime(ms) != nullptr;
+    }
+    const double indexNs = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    for (int ms = 0; ms < endMS && match; ms += STEP_MS) {
+        match = layer->GetEffectAtTime(ms) == scan(ms) && layer->GetEffectByTime(ms) == scan(ms);
+    }
+    for (int m = 0; m < marks && match; ++m) {
+        match = layer->GetEffectStartingAtTime(m * MARK_MS) == layer->GetEffect(m);
+    }
+    ctx.CloseSequence();
+
+    const double scanPer = queries ? scanNs / queries : 0.0;
+    const double indexPer = queries ? indexNs / queries : 0.0;
+    spdlog::info("xlRenderBench: timing lookups over {} marks: scan {:.0f} ns, index {:.0f} ns ({:.1f}x){}",
+                 marks, scanPer, indexPer, indexPer > 0 ? scanPer / indexPer : 0.0, match ? "" : " MISMATCH");
+    return {
+        { "marks", marks },
+        { "ok", match && hits == indexedHits },
+        { "queries", queries },
+        { "scanNsPerLookup", scanPer },
+        { "indexNsPerLookup", indexPer },
+        { "speedup", indexPer > 0 ? scanPer / indexPer : 0.0 }
+    };
+}
+
+// Returns the number of regressions and logs each one.
+int CompareToBaseline(const nlohmann::json& current, const nlohmann::json& base, const BenchOptions& o) {
+    const double slower = 1.0 + o.thresholdPct / 100.0;
+    int regressions = 0;
+    for (const auto& bc : base["cases"]) {
+        const std::string name = bc.value("name", "");
+        auto it = std::find_if(current["cases"].begin(), current["cases"].end(),
+                               [&name](const nlohmann::json& j) { return j.value("name", "") == name; });
+        if (it == current["cases"].end()) {
+            spdlog::warn("xlRenderBench: baseline case '{}' was not run", name);
+            continue;
+        }
+        if (!it->value("ok", false)) {
+            spdlog::error("xlRenderBench: REGRESSION {}: render failed", name);
+            ++regressions;
+            continue;
+        }
+        const double bfps = bc.value("fps", 0.0);
+        const double cfps = it->value("fps", 0.0);
+        if (bfps > 0 && cfps * slower < bfps) {
+            spdlog::error("xlRenderBench: REGRESSION {}: {:.1f} fps vs baseline {:.1f}", name, cfps, bfps);
+            ++regressions;
+        }
+        if (!bc.contains("effects")) {
+            continue;
+        }
+        for (const auto& be : bc["effects"].items()) {
+            const double bns = be.value().value("nsPerRender", 0.0);
+            const double btotalMS = (be.value().value("ns", 0.0) + be.value().value("gpuNs", 0.0)) / 1.0e6;
+            if (bns <= 0 || btotalMS < o.minEffectMS || !(*it)["effects"].contains(be.key())) {
+                continue;
+            }
+            const double cns = (*it)["effects"][be.key()].value("nsPerRender", 0.0);
+            if (cns > bns * slower) {
+                spdlog::error("xlRenderBench: REGRESSION {}/{}: {:.0f} ns/render vs baseline {:.0f} (+{:.1f}%)",
+                              name, be.key(), cns, bns, 100.0 * (cns - bns) / bns);
+                ++regressions;
+            }
+        }
+    }
+    return regressions;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions opts;
+    if (!ParseArgs(argc, argv, opts)) {
+        Usage();
+        return 2;
+    }
+    spdlog::set_level(spdlog::level::info);
+
+    std::vector<BenchCase> cases;
+    std::filesystem::path synthDir;
+    if (opts.synthetic) {
+        synthDir = std::filesystem::temp_directory_path() / ("xlRenderBench-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+        std::error_code ec;
+        std::filesystem::create_directories(synthDir, ec);
+        if (ec || !WriteSyntheticShow(synthDir.string(), opts)) {
+            spdlog::critical("xlRenderBench: could not create synthetic show in {}", synthDir.string());
+            return 2;
+        }
+        for (const auto& eff : opts.syntheticEffects) {
+            const std::string xsq = (synthDir / ("Bench_" + CaseSlug(eff) + ".xsq")).string();
+            if (!WriteSyntheticSequence(xsq, eff, opts)) {
+                spdlog::critical("xlRenderBench: could not write {}", xsq);
+                return 2;
+            }
+            cases.push_back({ "synthetic/" + eff, synthDir.string(), xsq });
+        }
+    }
+    for (const auto& s : opts.sequences) {
+        cases.push_back({ std::filesystem::path(s).filename().string(), opts.showDir, s });
+    }
+
+    nlohmann::json result;
+    result["version"] = 1;
+    result["xlights"] = xlights_version_string;
+    result["synthetic"] = { { "models", opts.syntheticModels },
+                            { "width", opts.syntheticWidth },
+                            { "height", opts.syntheticHeight },
+                            { "durationMs", opts.syntheticDurationMS } };
+    result["cases"] = nlohmann::json::array();
+    for (const auto& c : cases) {
+        result["cases"].push_back(BenchCaseJSON(c, opts.repeat));
+    }
+    if (opts.timingMarks > 0 && !cases.empty()) {
+        result["timingLookups"] = TimingLookupJSON(cases.front(), opts.timingMarks);
+    }
+
+    if (!synthDir.empty()) {
+        std::error_code ec;
+        std::filesystem::remove_all(synthDir, ec);
+    }
+
+    const std::string text = result.dump(2);
+    if (opts.jsonOut.empty()) {
+        std::cout << text << std::endl;
+    } else {
+        std::ofstream out(opts.jsonOut, std::ios::binary);
+        out << text << "\n";
+    }
+
+    int failed = 0;
+    for (const auto& c : result["cases"]) {
+        if (!c.value("ok", false)) ++failed;
+    }
+    if (result.contains("timingLookups") && !result["timingLookups"].value("ok", false)) {
+        ++failed;
+    }
+    if (!opts.baseline.empty()) {
+        std::ifstream in(opts.baseline, std::ios::binary);
+        nlohmann::json base = nlohmann::json::parse(in, nullptr, false);
+        if (base.is_discarded() || !base.contains("cases")) {
+            spdlog::critical("xlRenderBench: could not read baseline {}", opts.baseline);
+            return 2;
+        }
+        const int regressions = CompareToBaseline(result, base, opts);
+        if (regressions > 0) {
+            spdlog::error("xlRenderBench: {} regression(s) beyond {:.1f}%", regressions, opts.thresholdPct);
+            return 1;
+        }
+        spdlog::info("xlRenderBench: no regressions beyond {:.1f}% against {}", opts.thresholdPct, opts.baseline);
+    }
+    return failed ? 1 : 0;
+}